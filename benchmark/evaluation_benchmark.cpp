@@ -0,0 +1,614 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include <jmespath/jmespath.h>
+#include <boost/algorithm/string/predicate.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <utility>
+
+using namespace jmespath;
+
+namespace {
+/**
+ * @brief Creates a document with an array of @a recordCount records.
+ * @param[in] recordCount The number of records.
+ * @return The document.
+ */
+Json makeDocument(int recordCount)
+{
+    Json records(Json::value_t::array);
+    for (int i = 0; i < recordCount; ++i)
+    {
+        records.push_back({
+            {"id", i},
+            {"name", "item" + std::to_string(i)},
+            {"price", (i % 100) * 1.5},
+            {"active", i % 3 != 0},
+            {"tags", {"a", "b", i % 2 == 0 ? "even" : "odd"}},
+            {"owner", {{"name", "owner" + std::to_string(i % 10)}}}
+        });
+        // only some of the records have a discount
+        if (i % 10 == 0)
+        {
+            records.back()["discount"] = 0.1;
+        }
+    }
+    return {{"records", records}, {"meta", {{"count", recordCount}}}};
+}
+
+/**
+ * @brief Creates a document with an array of @a recordCount log records,
+ * whose messages are a few kilobytes long and half of them contain non
+ * ASCII characters.
+ * @param[in] recordCount The number of records.
+ * @return The document.
+ */
+Json makeLogDocument(int recordCount)
+{
+    Json logs(Json::value_t::array);
+    for (int i = 0; i < recordCount; ++i)
+    {
+        String message = "request " + std::to_string(i) + " to upstream "
+                         "service " + std::to_string(i % 7)
+                         + (i % 2 == 0 ? " " : " \u2014 ");
+        while (message.size() < 4096)
+        {
+            message += "the service responded to the request with status "
+                       "code 200 after waiting for the connection to be "
+                       "established; ";
+        }
+        // only some of the messages report a timeout
+        if (i % 50 == 0)
+        {
+            message += "timeout";
+        }
+        logs.push_back({{"level", i % 50 == 0 ? "error" : "info"},
+                        {"message", std::move(message)}});
+    }
+    return {{"logs", logs}};
+}
+
+/**
+ * @brief Creates a document with arrays of @a valueCount integer and floating
+ * point metric values.
+ * @param[in] valueCount The number of values in each array.
+ * @return The document.
+ */
+Json makeMetricDocument(int valueCount)
+{
+    Json integers(Json::value_t::array);
+    Json floats(Json::value_t::array);
+    for (int i = 0; i < valueCount; ++i)
+    {
+        // spread the values, so the extreme value is replaced a few times
+        std::int64_t value = (static_cast<std::int64_t>(i) * 7919) % 1000003;
+        integers.push_back(value - 500000);
+        floats.push_back((value - 500000) * 0.25);
+    }
+    return {{"integers", integers}, {"floats", floats}};
+}
+
+/**
+ * @brief Creates a filter expression with @a conditionCount conditions, like
+ * the ones generated by applications.
+ * @param[in] conditionCount The number of conditions.
+ * @param[in] ownerPrefix The prefix of the compared owner names.
+ * @return The expression.
+ */
+String makeGeneratedExpression(int conditionCount, const String& ownerPrefix)
+{
+    String expression = "records[?";
+    for (int i = 0; i < conditionCount; ++i)
+    {
+        if (i != 0)
+        {
+            expression += " || ";
+        }
+        expression += "(owner.name == '" + ownerPrefix + std::to_string(i)
+                      + "' && price > `" + std::to_string(i) + "`)";
+    }
+    return expression + "].{id: id, \"tag list\": tags[?starts_with(@, 'e')]}";
+}
+
+/**
+ * @brief Measures the average duration of parsing the @a expression.
+ * @param[in] expression The parsed expression.
+ * @param[in] iterationCount The number of parses.
+ * @return The average duration of parsing in microseconds.
+ */
+double measureParsing(const String& expression, int iterationCount)
+{
+    using Clock = std::chrono::steady_clock;
+    size_t nodeCount = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < iterationCount; ++i)
+    {
+        nodeCount += Expression{expression}.isEmpty() ? 0 : 1;
+    }
+    std::chrono::duration<double, std::micro> duration = Clock::now() - start;
+    if (nodeCount == 0)
+    {
+        std::cerr << "empty expression " << expression << "\n";
+    }
+    return duration.count() / iterationCount;
+}
+
+/**
+ * @brief Measures the durations of creating Expression objects from the
+ * @a expressions by parsing them, by decoding their binary forms one by one
+ * and by decoding their binary forms with loadExpressions.
+ * @param[in] expressions The string representations of the expressions.
+ * @return The durations in milliseconds.
+ */
+std::array<double, 3> measureLoading(const std::vector<String>& expressions)
+{
+    using Clock = std::chrono::steady_clock;
+    using Duration = std::chrono::duration<double, std::milli>;
+    std::vector<std::vector<std::uint8_t>> encodedExpressions;
+    for (const auto& expression: expressions)
+    {
+        encodedExpressions.push_back(Expression{expression}.toBinary());
+    }
+
+    std::vector<Expression> parsed;
+    parsed.reserve(expressions.size());
+    auto start = Clock::now();
+    for (const auto& expression: expressions)
+    {
+        parsed.emplace_back(expression);
+    }
+    Duration parsing = Clock::now() - start;
+
+    std::vector<Expression> decoded;
+    decoded.reserve(expressions.size());
+    start = Clock::now();
+    for (const auto& encodedExpression: encodedExpressions)
+    {
+        decoded.push_back(Expression::fromBinary(encodedExpression.data(),
+                                                 encodedExpression.size()));
+    }
+    Duration decoding = Clock::now() - start;
+
+    start = Clock::now();
+    std::vector<Expression> loaded = loadExpressions(encodedExpressions);
+    Duration loading = Clock::now() - start;
+    if ((decoded != parsed) || (loaded != parsed))
+    {
+        std::cerr << "decoded expressions differ from the parsed ones\n";
+    }
+    return {{parsing.count(), decoding.count(), loading.count()}};
+}
+
+/**
+ * @brief Measures the latency of the first and the second query of fresh
+ * threads, which parse the @a expression and search the @a document with it.
+ * @param[in] expression The searched expression.
+ * @param[in] document The searched document.
+ * @param[in] threadCount The number of started threads.
+ * @return The average durations of the first and the second queries in
+ * microseconds.
+ */
+std::pair<double, double> measureFirstQuery(const String& expression,
+                                            const Json& document,
+                                            int threadCount)
+{
+    using Clock = std::chrono::steady_clock;
+    using Duration = std::chrono::duration<double, std::micro>;
+    Duration first{0};
+    Duration second{0};
+    for (int i = 0; i < threadCount; ++i)
+    {
+        // the threads are started one by one, so they don't compete with
+        // each other
+        std::thread thread{[&] {
+            auto start = Clock::now();
+            Json result = search(Expression{expression}, document);
+            auto end = Clock::now();
+            result = search(Expression{expression}, document);
+            second += Clock::now() - end;
+            first += end - start;
+        }};
+        thread.join();
+    }
+    return {first.count() / threadCount, second.count() / threadCount};
+}
+
+/**
+ * @brief Measures the average duration of searching the @a document with the
+ * @a expression.
+ * @param[in] expression The searched expression.
+ * @param[in] document The searched document.
+ * @param[in] iterationCount The number of searches.
+ * @tparam DocumentT The type of the @a document.
+ * @return The average duration of a search in microseconds.
+ */
+template <typename DocumentT>
+double measure(const Expression& expression,
+               const DocumentT& document,
+               int iterationCount)
+{
+    using Clock = std::chrono::steady_clock;
+    Evaluator evaluator;
+    size_t resultSize = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < iterationCount; ++i)
+    {
+        resultSize += evaluator.search(expression, document).size();
+    }
+    std::chrono::duration<double, std::micro> duration = Clock::now() - start;
+    // use the results, so the searches can't be optimized away
+    if (resultSize == 0)
+    {
+        std::cerr << "empty results for " << expression.toString() << "\n";
+    }
+    return duration.count() / iterationCount;
+}
+
+/**
+ * @brief Measures the average duration of reading the @a data with the
+ * @a read function and searching the result with the @a expression.
+ * @param[in] expression The searched expression.
+ * @param[in] data The encoded document.
+ * @param[in] read The function which reads the encoded document.
+ * @param[in] iterationCount The number of searches.
+ * @tparam ReaderT The type of the @a read function.
+ * @return The average duration of a read and search in microseconds.
+ */
+template <typename ReaderT>
+double measureReading(const Expression& expression,
+                      const std::vector<std::uint8_t>& data,
+                      ReaderT read,
+                      int iterationCount)
+{
+    using Clock = std::chrono::steady_clock;
+    Evaluator evaluator;
+    size_t resultSize = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < iterationCount; ++i)
+    {
+        resultSize += evaluator.search(expression, read(data)).size();
+    }
+    std::chrono::duration<double, std::micro> duration = Clock::now() - start;
+    if (resultSize == 0)
+    {
+        std::cerr << "empty results for " << expression.toString() << "\n";
+    }
+    return duration.count() / iterationCount;
+}
+
+/**
+ * @brief Measures the average duration of searching the @a document with the
+ * @a expression and serializing the result with the @a serialize function.
+ * @param[in] expression The searched expression.
+ * @param[in] document The searched document.
+ * @param[in] serialize The function which searches and serializes.
+ * @param[in] iterationCount The number of searches.
+ * @tparam SerializerT The type of the @a serialize function.
+ * @return The average duration of a search in microseconds.
+ */
+template <typename SerializerT>
+double measureSerialization(const Expression& expression,
+                            const Json& document,
+                            SerializerT serialize,
+                            int iterationCount)
+{
+    using Clock = std::chrono::steady_clock;
+    Evaluator evaluator;
+    size_t resultSize = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < iterationCount; ++i)
+    {
+        resultSize += serialize(evaluator, expression, document).size();
+    }
+    std::chrono::duration<double, std::micro> duration = Clock::now() - start;
+    if (resultSize == 0)
+    {
+        std::cerr << "empty results for " << expression.toString() << "\n";
+    }
+    return duration.count() / iterationCount;
+}
+} // anonymous namespace
+
+int main()
+{
+    const int iterationCount = 200;
+    const Json document = makeDocument(1000);
+    const FrozenDocument frozenDocument{document};
+    const String expressions[] = {
+        "meta.count",
+        "records[500].owner.name",
+        "records[*].id",
+        "records[?active].name",
+        "records[?price > `50` && active].{id: id, owner: owner.name}",
+        "records[].tags[]",
+        "records[10:500:2].owner.name",
+        "length(records[?contains(tags, 'even')])",
+        "sort_by(records, &price)[-1].id",
+        "records[*].[id, name, price]",
+        "records[?discount].id"
+    };
+
+    std::cout << std::left << std::setw(64) << "expression"
+              << std::right << std::setw(14) << "interpreted"
+              << std::setw(14) << "compiled"
+              << std::setw(14) << "frozen" << "  (us/search)\n";
+    for (const auto& expressionString: expressions)
+    {
+        Expression expression{expressionString};
+        double interpreted = measure(expression, document, iterationCount);
+        expression.setEvaluationMode(EvaluationMode::Compiled);
+        double compiled = measure(expression, document, iterationCount);
+        double frozen = measure(expression, frozenDocument, iterationCount);
+        std::cout << std::left << std::setw(64) << expressionString
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << interpreted
+                  << std::setw(14) << compiled
+                  << std::setw(14) << frozen << "\n";
+    }
+
+    // compare decoding binary messages before searching them with reading
+    // them directly into frozen documents
+    const std::vector<std::uint8_t> messagePack = Json::to_msgpack(document);
+    const std::vector<std::uint8_t> cbor = Json::to_cbor(document);
+    const String binaryExpressions[] = {
+        "meta.count",
+        "records[?active].name"
+    };
+    std::cout << "\n" << std::left << std::setw(64) << "expression"
+              << std::right << std::setw(14) << "from_msgpack"
+              << std::setw(14) << "msgpack"
+              << std::setw(14) << "from_cbor"
+              << std::setw(14) << "cbor" << "  (us/read and search)\n";
+    for (const auto& expressionString: binaryExpressions)
+    {
+        Expression expression{expressionString};
+        double decodedMessagePack = measureReading(
+            expression, messagePack,
+            [](const std::vector<std::uint8_t>& data) {
+                return Json::from_msgpack(data);
+            }, iterationCount);
+        double frozenMessagePack = measureReading(
+            expression, messagePack,
+            [](const std::vector<std::uint8_t>& data) {
+                return FrozenDocument::fromBinary(data.data(),
+                                                  data.size(),
+                                                  BinaryFormat::MessagePack);
+            }, iterationCount);
+        double decodedCbor = measureReading(
+            expression, cbor,
+            [](const std::vector<std::uint8_t>& data) {
+                return Json::from_cbor(data);
+            }, iterationCount);
+        double frozenCbor = measureReading(
+            expression, cbor,
+            [](const std::vector<std::uint8_t>& data) {
+                return FrozenDocument::fromBinary(data.data(),
+                                                  data.size(),
+                                                  BinaryFormat::Cbor);
+            }, iterationCount);
+        std::cout << std::left << std::setw(64) << expressionString
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << decodedMessagePack
+                  << std::setw(14) << frozenMessagePack
+                  << std::setw(14) << decodedCbor
+                  << std::setw(14) << frozenCbor << "\n";
+    }
+
+    // compare serializing the results of searches with writing them while
+    // they're evaluated
+    const String serializedExpressions[] = {
+        "records",
+        "records[*].{id: id, owner: owner.name}",
+        "[records[*].id, meta]"
+    };
+    std::cout << "\n" << std::left << std::setw(64) << "expression"
+              << std::right << std::setw(14) << "dump"
+              << std::setw(14) << "write" << "  (us/search)\n";
+    for (const auto& expressionString: serializedExpressions)
+    {
+        Expression expression{expressionString};
+        double dumped = measureSerialization(
+            expression, document,
+            [](Evaluator& evaluator,
+               const Expression& expression,
+               const Json& document) {
+                return evaluator.search(expression, document).dump();
+            }, iterationCount);
+        double written = measureSerialization(
+            expression, document,
+            [](Evaluator& evaluator,
+               const Expression& expression,
+               const Json& document) {
+                String output;
+                evaluator.search(expression, document, output);
+                return output;
+            }, iterationCount);
+        std::cout << std::left << std::setw(64) << expressionString
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << dumped
+                  << std::setw(14) << written << "\n";
+    }
+
+    // compare searching for constant substrings in long strings with the
+    // naive search used before, which is registered as a native function
+    registerFunction("naive_contains",
+                     {ArgumentType::String, ArgumentType::String},
+                     [](std::vector<NativeArgument>& arguments) {
+        return Json(boost::algorithm::contains(
+            arguments[0].value().get_ref<const String&>(),
+            arguments[1].value().get_ref<const String&>()));
+    });
+    const Json logDocument = makeLogDocument(1000);
+    const String substringExpressions[] = {
+        "logs[?contains(message, 'timeout')].level",
+        "length(logs[?contains(message, 'status code 404')])",
+        "logs[?starts_with(message, 'request 99')].level",
+        "logs[?ends_with(message, 'timeout')].level",
+        "logs[?naive_contains(message, 'timeout')].level",
+        "length(logs[?naive_contains(message, 'status code 404')])"
+    };
+    std::cout << "\n" << std::left << std::setw(64) << "expression"
+              << std::right << std::setw(14) << "interpreted"
+              << std::setw(14) << "compiled" << "  (us/search)\n";
+    for (const auto& expressionString: substringExpressions)
+    {
+        Expression expression{expressionString};
+        double interpreted = measure(expression, logDocument, iterationCount);
+        expression.setEvaluationMode(EvaluationMode::Compiled);
+        double compiled = measure(expression, logDocument, iterationCount);
+        std::cout << std::left << std::setw(64) << expressionString
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << interpreted
+                  << std::setw(14) << compiled << "\n";
+    }
+
+    // measure counting the code points of long strings
+    const FrozenDocument frozenLogDocument{logDocument};
+    const String lengthExpressions[] = {
+        "logs[?length(message) > `4100`].level",
+        "length(logs[?level == 'error'] | [0].message)"
+    };
+    std::cout << "\n" << std::left << std::setw(64) << "expression"
+              << std::right << std::setw(14) << "interpreted"
+              << std::setw(14) << "compiled"
+              << std::setw(14) << "frozen" << "  (us/search)\n";
+    for (const auto& expressionString: lengthExpressions)
+    {
+        Expression expression{expressionString};
+        double interpreted = measure(expression, logDocument, iterationCount);
+        expression.setEvaluationMode(EvaluationMode::Compiled);
+        double compiled = measure(expression, logDocument, iterationCount);
+        double frozen = measure(expression, frozenLogDocument,
+                                iterationCount);
+        std::cout << std::left << std::setw(64) << expressionString
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << interpreted
+                  << std::setw(14) << compiled
+                  << std::setw(14) << frozen << "\n";
+    }
+
+    // compare the aggregation of large metric arrays with comparing their
+    // items one by one as Json values, which is registered as a native
+    // function
+    registerFunction("naive_max",
+                     {ArgumentType::Array},
+                     [](std::vector<NativeArgument>& arguments) {
+        const Json& array = arguments[0].value();
+        return *std::max_element(array.begin(), array.end());
+    });
+    const Json metricDocument = makeMetricDocument(1000000);
+    const String aggregationExpressions[] = {
+        "max(integers)",
+        "min(integers)",
+        "max(floats)",
+        "min(floats)",
+        "naive_max(integers)",
+        "naive_max(floats)",
+        "sum(floats)"
+    };
+    std::cout << "\n" << std::left << std::setw(64) << "expression"
+              << std::right << std::setw(14) << "interpreted"
+              << std::setw(14) << "compiled" << "  (us/search)\n";
+    for (const auto& expressionString: aggregationExpressions)
+    {
+        Expression expression{expressionString};
+        double interpreted = measure(expression, metricDocument, 20);
+        expression.setEvaluationMode(EvaluationMode::Compiled);
+        double compiled = measure(expression, metricDocument, 20);
+        std::cout << std::left << std::setw(64) << expressionString
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << interpreted
+                  << std::setw(14) << compiled << "\n";
+    }
+
+    // measure parsing long generated expressions, with and without non
+    // ASCII characters in their raw strings
+    std::cout << "\n" << std::left << std::setw(64) << "expression"
+              << std::right << std::setw(14) << "bytes"
+              << std::setw(14) << "parse" << "  (us/parse)\n";
+    const std::pair<const char*, String> generatedExpressions[] = {
+        {"30 conditions, ASCII", makeGeneratedExpression(30, "owner")},
+        {"60 conditions, ASCII", makeGeneratedExpression(60, "owner")},
+        {"30 conditions, non ASCII",
+         makeGeneratedExpression(30, "\u00e9l\u00e9ment ")}
+    };
+    for (const auto& generatedExpression: generatedExpressions)
+    {
+        double parsing = measureParsing(generatedExpression.second,
+                                        iterationCount);
+        std::cout << std::left << std::setw(64) << generatedExpression.first
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << generatedExpression.second.size()
+                  << std::setw(14) << parsing << "\n";
+    }
+
+    // measure the latency of the first queries of fresh threads, which don't
+    // have their own parser and function tables anymore
+    std::cout << "\n" << std::left << std::setw(64) << "expression"
+              << std::right << std::setw(14) << "first"
+              << std::setw(14) << "second" << "  (us/query on a new thread)\n";
+    const Json smallDocument = makeDocument(10);
+    const char* coldStartExpressions[] = {
+        "records[?active].name",
+        "max_by(records, &price).owner.name",
+        "length(records[?contains(tags, 'even')])"
+    };
+    for (const char* expressionString: coldStartExpressions)
+    {
+        auto latency = measureFirstQuery(expressionString, smallDocument, 200);
+        std::cout << std::left << std::setw(64) << expressionString
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << latency.first
+                  << std::setw(14) << latency.second << "\n";
+    }
+
+    // measure loading a large number of stored expressions, either by
+    // parsing them or by decoding their binary forms
+    std::cout << "\n" << std::left << std::setw(64) << "expressions"
+              << std::right << std::setw(14) << "parse"
+              << std::setw(14) << "decode"
+              << std::setw(14) << "bulk decode" << "  (ms)\n";
+    std::vector<String> storedExpressions;
+    for (int i = 0; i < 20000; ++i)
+    {
+        storedExpressions.push_back(makeGeneratedExpression(
+            1 + i % 4,
+            "owner" + std::to_string(i)));
+    }
+    auto loading = measureLoading(storedExpressions);
+    std::cout << std::left << std::setw(64) << "20000 generated filters"
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(14) << loading[0]
+              << std::setw(14) << loading[1]
+              << std::setw(14) << loading[2] << "\n";
+    return 0;
+}
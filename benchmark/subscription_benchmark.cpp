@@ -0,0 +1,151 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include <jmespath/jmespath.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace jmespath;
+
+namespace {
+/**
+ * @brief The event types used by the predicates and the documents.
+ */
+const char* const s_types[] = {"order", "refund", "payment", "shipment"};
+/**
+ * @brief The regions used by the predicates and the documents.
+ */
+const char* const s_regions[] = {"eu", "us", "apac", "latam", "mea"};
+
+/**
+ * @brief Creates the predicate of the subscription at @a index.
+ * @param[in] index The index of the subscription.
+ * @return The predicate.
+ */
+Expression makePredicate(int index)
+{
+    String type = s_types[index % 4];
+    String region = s_regions[(index / 4) % 5];
+    String customer = std::to_string(index % 1000);
+    // mix simple conjunctions, disjunctions and conditions on other values
+    switch (index % 3)
+    {
+    case 0:
+        return "type == '" + type + "' && region == '" + region
+            + "' && customer.id == `" + customer + "`";
+    case 1:
+        return "customer.id == `" + customer + "` || (type == '" + type
+            + "' && region == '" + region + "' && total > `990`)";
+    default:
+        return "type == '" + type + "' && customer.id == `" + customer
+            + "` && length(items) > `1`";
+    }
+}
+
+/**
+ * @brief Creates the event document at @a index.
+ * @param[in] index The index of the document.
+ * @return The document.
+ */
+Json makeDocument(int index)
+{
+    return {
+        {"type", s_types[index % 4]},
+        {"region", s_regions[index % 5]},
+        {"customer", {{"id", (index * 7) % 1000}}},
+        {"total", index % 1000},
+        {"items", Json::array({1, 2, 3})}
+    };
+}
+} // anonymous namespace
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+    const int documentCount = 100;
+    const int subscriptionCounts[] = {100, 1000, 5000, 20000};
+
+    std::cout << std::left << std::setw(16) << "subscriptions"
+              << std::right << std::setw(14) << "search"
+              << std::setw(14) << "index"
+              << std::setw(14) << "matches" << "  (us/document)\n";
+    for (int subscriptionCount: subscriptionCounts)
+    {
+        std::vector<Expression> predicates;
+        SubscriptionIndex index;
+        for (int i = 0; i < subscriptionCount; ++i)
+        {
+            predicates.push_back(makePredicate(i));
+            index.addSubscription(predicates.back());
+        }
+        std::vector<Json> documents;
+        for (int i = 0; i < documentCount; ++i)
+        {
+            documents.push_back(makeDocument(i));
+        }
+
+        // search every document with every predicate
+        Evaluator evaluator;
+        size_t searchMatchCount = 0;
+        auto start = Clock::now();
+        for (const auto& document: documents)
+        {
+            for (const auto& predicate: predicates)
+            {
+                if (evaluator.search(predicate, document) == true)
+                {
+                    ++searchMatchCount;
+                }
+            }
+        }
+        std::chrono::duration<double, std::micro> searchDuration
+            = Clock::now() - start;
+
+        // match the documents with the index
+        size_t indexMatchCount = 0;
+        start = Clock::now();
+        for (const auto& document: documents)
+        {
+            indexMatchCount += index.match(document).size();
+        }
+        std::chrono::duration<double, std::micro> indexDuration
+            = Clock::now() - start;
+
+        if (searchMatchCount != indexMatchCount)
+        {
+            std::cerr << "different number of matches for "
+                      << subscriptionCount << " subscriptions\n";
+        }
+        std::cout << std::left << std::setw(16) << subscriptionCount
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << searchDuration.count() / documentCount
+                  << std::setw(14) << indexDuration.count() / documentCount
+                  << std::setw(14) << indexMatchCount << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef COLUMNARDOCUMENT_H
+#define COLUMNARDOCUMENT_H
+#include <memory>
+#include <jmespath/types.h>
+
+namespace jmespath {
+
+namespace interpreter {
+class ColumnCache;
+}
+/**
+ * @ingroup public
+ * @brief The ColumnarDocument class represents an immutable JSON document
+ * which stores the arrays of objects in it in a columnar layout.
+ *
+ * When the document is searched, the values of fields accessed in
+ * projections, filters and sort_by expressions on arrays of objects are
+ * transposed into per-field columns on first use, and subsequent searches
+ * look up the field values from the columns instead of searching the
+ * objects. Documents which are searched repeatedly with expressions touching
+ * only a few fields of large arrays of objects benefit the most from this
+ * layout.
+ * @note The same instance can be searched concurrently from multiple
+ * threads, the creation of the columns is synchronized.
+ */
+class ColumnarDocument
+{
+public:
+    /**
+     * @brief Constructs a ColumnarDocument object which takes ownership of
+     * the @a document.
+     * @param[in] document A JSON document.
+     */
+    explicit ColumnarDocument(Json document = {});
+    /**
+     * @brief Move-constructs a ColumnarDocument by moving the value of
+     * @a other to this object.
+     * @param[in] other The object whose value should be moved.
+     */
+    ColumnarDocument(ColumnarDocument&& other);
+    /**
+     * @brief Move-assigns @a other to this document and returns a reference
+     * to this document.
+     * @param[in] other The document that should be moved.
+     * @return Reference to this document.
+     */
+    ColumnarDocument& operator= (ColumnarDocument&& other);
+    /**
+     * @brief Destroys the document and the columns created for it.
+     */
+    ~ColumnarDocument();
+    /**
+     * @brief Returns a reference to the JSON document.
+     * @return Reference to the JSON document.
+     */
+    const Json& document() const;
+    /**
+     * @brief Returns the number of columns created for the document so far.
+     * @return The number of columns.
+     */
+    size_t columnCount() const;
+    /**
+     * @brief Returns a pointer to the cache of the columns of the document,
+     * which creates the columns lazily and synchronizes their creation, so
+     * it can be used through const documents from multiple threads.
+     * @return A pointer to the column cache.
+     */
+    interpreter::ColumnCache* columnCache() const;
+
+private:
+    /**
+     * @brief The ColumnCacheDeleter struct is a custom destruction policy
+     * for deleting interpreter::ColumnCache objects.
+     *
+     * Unlike std::default_deleter it can be used to delete forward declared
+     * @ref interpreter::ColumnCache.
+     */
+    struct ColumnCacheDeleter
+    {
+        /**
+         * @brief operator () Destroys the given @a cache object.
+         * @param cache An instance of interpreter::ColumnCache
+         */
+        void operator()(interpreter::ColumnCache* cache) const;
+    };
+    /**
+     * @brief The JSON document, it's allocated dynamically so its address
+     * and the addresses of its values remain stable when the object is moved.
+     */
+    std::unique_ptr<const Json> m_document;
+    /**
+     * @brief The columns created for the arrays in the document.
+     */
+    std::unique_ptr<interpreter::ColumnCache, ColumnCacheDeleter> m_columns;
+};
+} // namespace jmespath
+#endif // COLUMNARDOCUMENT_H
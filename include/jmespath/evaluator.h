@@ -0,0 +1,210 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <jmespath/types.h>
+#include <jmespath/expression.h>
+#include <jmespath/columnardocument.h>
+#include <jmespath/frozendocument.h>
+
+namespace jmespath {
+
+/**
+ * @ingroup public
+ * @brief Type of the functions which receive the serialized result of a
+ * search in consecutive chunks of characters.
+ */
+using OutputCallback = std::function<void(const Char* data, size_t size)>;
+
+/**
+ * @ingroup public
+ * @brief The Evaluator class owns the state needed for evaluating JMESPath
+ * expressions. The parser and the tables of built in functions are immutable
+ * and shared by every thread of the process.
+ *
+ * The free @ref search and @ref Expression functions use a hidden evaluation
+ * state for every thread which is created on first use and kept alive until
+ * the thread exits. An Evaluator object makes this state explicit, so it can
+ * be created upfront, reused for any number of searches, pooled, reset and
+ * passed between threads, coroutines or fibers.
+ * @note This class is reentrant, but a single instance shouldn't be used
+ * concurrently from multiple threads.
+ */
+class Evaluator
+{
+public:
+    /**
+     * @brief Constructs an Evaluator object.
+     */
+    Evaluator();
+    /**
+     * @brief Move-constructs an Evaluator by moving the state of @a other to
+     * this object.
+     * @param[in] other The object whose state should be moved.
+     */
+    Evaluator(Evaluator&& other);
+    /**
+     * @brief Move-assigns @a other to this evaluator and returns a reference
+     * to this evaluator.
+     * @param[in] other The evaluator that should be moved.
+     * @return Reference to this evaluator.
+     */
+    Evaluator& operator= (Evaluator&& other);
+    /**
+     * @brief Destroys the evaluator and its state.
+     */
+    ~Evaluator();
+    /**
+     * @brief Parses the @a expressionString with the parser shared by every
+     * thread of the process.
+     * @param[in] expressionString The string representation of a JMESPath
+     * expression.
+     * @return An Expression object.
+     * @throws SyntaxError When the syntax of the specified
+     * *expressionString* is invalid.
+     */
+    Expression parse(const String& expressionString);
+    /**
+     * @brief Finds or creates the results for the @a expression evaluated on
+     * the given @a document.
+     * @param[in] expression JMESPath expression.
+     * @param[in] document Input JSON document
+     * @return Result of the evaluation of the @a expression in @ref Json
+     * format
+     * @throws InvalidAgrument If a precondition fails. Usually signals an
+     * internal error.
+     * @throws InvalidValue When an invalid value is specified for an
+     * *expression*. For example a `0` step value for a slice expression.
+     * @throws UnknownFunction When an unknown JMESPath function is called in
+     * the *expression*.
+     * @throws InvalidFunctionArgumentArity When a JMESPath function is called
+     * with an unexpected number of arguments in the *expression*.
+     * @throws InvalidFunctionArgumentType When an invalid type of argument was
+     * specified for a JMESPath function call in the *expression*.
+     */
+    Json search(const Expression& expression, const Json& document);
+    /**
+     * @brief Finds or creates the results for the @a expression evaluated on
+     * the given @a document, which can be consumed by the evaluation.
+     * @copydetails search(const Expression&, const Json&)
+     */
+    Json search(const Expression& expression, Json&& document);
+    /**
+     * @brief Finds or creates the results for the @a expression evaluated on
+     * the given columnar @a document.
+     * @copydetails search(const Expression&, const Json&)
+     */
+    Json search(const Expression& expression,
+                const ColumnarDocument& document);
+    /**
+     * @brief Finds or creates the results for the @a expression evaluated on
+     * the given frozen @a document.
+     *
+     * The expression is evaluated directly on the layout of the document
+     * as far as possible, and the parts of it which need @ref Json values are
+     * evaluated by the interpreter, even if the @a expression is compiled.
+     * @copydetails search(const Expression&, const Json&)
+     */
+    Json search(const Expression& expression,
+                const FrozenDocument& document);
+    /**
+     * @brief Evaluates the @a expression on the given @a document and writes
+     * the result in JSON format into the @a output stream.
+     *
+     * The output is the same as the output of `search(expression,
+     * document).dump()`, but the result isn't created as a @ref Json value.
+     * The items of projections and the values of multiselect expressions are
+     * serialized as soon as they're evaluated, and values of the @a document
+     * are serialized directly from the @a document without copying them. If
+     * the evaluation fails, the @a output might contain a partial result.
+     * @param[in] expression JMESPath expression.
+     * @param[in] document Input JSON document
+     * @param[in] output The output which receives the result.
+     * @throws InvalidAgrument If a precondition fails. Usually signals an
+     * internal error.
+     * @throws InvalidValue When an invalid value is specified for an
+     * *expression*. For example a `0` step value for a slice expression.
+     * @throws UnknownFunction When an unknown JMESPath function is called in
+     * the *expression*.
+     * @throws InvalidFunctionArgumentArity When a JMESPath function is called
+     * with an unexpected number of arguments in the *expression*.
+     * @throws InvalidFunctionArgumentType When an invalid type of argument was
+     * specified for a JMESPath function call in the *expression*.
+     */
+    void search(const Expression& expression,
+                const Json& document,
+                std::ostream& output);
+    /**
+     * @brief Evaluates the @a expression on the given @a document and appends
+     * the result in JSON format to the @a output string.
+     * @copydetails search(const Expression&, const Json&, std::ostream&)
+     */
+    void search(const Expression& expression,
+                const Json& document,
+                String& output);
+    /**
+     * @brief Evaluates the @a expression on the given @a document and passes
+     * the result in JSON format to the @a output callback in chunks.
+     * @copydetails search(const Expression&, const Json&, std::ostream&)
+     */
+    void search(const Expression& expression,
+                const Json& document,
+                const OutputCallback& output);
+    /**
+     * @brief Releases the values held from the last evaluation, while keeping
+     * the interpreter for reuse.
+     */
+    void reset();
+
+private:
+    /**
+     * @brief The State struct holds the interpreter of the evaluator.
+     */
+    struct State;
+    /**
+     * @brief The StateDeleter struct is a custom destruction policy
+     * for deleting the forward declared @ref State objects.
+     */
+    struct StateDeleter
+    {
+        /**
+         * @brief operator () Destroys the given @a d object.
+         * @param state An instance of @ref State
+         */
+        void operator()(State* state) const;
+    };
+    /**
+     * @brief The state of the evaluator.
+     */
+    std::unique_ptr<State, StateDeleter> m_state;
+};
+} // namespace jmespath
+#endif // EVALUATOR_H
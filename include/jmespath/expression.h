@@ -27,7 +27,10 @@
 ****************************************************************************/
 #ifndef EXPRESSION_H
 #define EXPRESSION_H
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <vector>
 #include <jmespath/types.h>
 #include <jmespath/exceptions.h>
 
@@ -36,13 +39,40 @@ namespace jmespath {
 namespace ast {
 class ExpressionNode;
 }
+namespace interpreter {
+class CompiledExpression;
+}
+
+/**
+ * @ingroup public
+ * @brief The EvaluationMode enum defines how an @ref Expression is evaluated.
+ */
+enum class EvaluationMode
+{
+    /**
+     * @brief The AST of the expression is evaluated by an interpreter, which
+     * visits its nodes.
+     */
+    Interpreted,
+    /**
+     * @brief The AST of the expression is compiled into a tree of closures
+     * specialized on the type and operands of the nodes, which are then
+     * called for evaluation.
+     */
+    Compiled
+};
 /**
  * @ingroup public
  * @brief The Expression class represents a JMESPath expression.
  *
  * The Expression class can be used to store a parsed JMESPath expression and
  * reuse it for multiple searches.
- * @note This class is reentrant.
+ *
+ * The string representation and the AST of a parsed expression are immutable
+ * and they're shared between the copies of the expression, so copying an
+ * Expression takes constant time and it doesn't allocate memory.
+ * @note This class is reentrant. Copies of the same expression can be used
+ * and destroyed on different threads concurrently.
  */
 class Expression
 {
@@ -52,7 +82,8 @@ public:
      */
     Expression();
     /**
-     * @brief Constructs a copy of @a other.
+     * @brief Constructs a copy of @a other, which shares its AST with
+     * @a other.
      * @param[in] other The object that should be copied.
      */
     Expression(const Expression& other);
@@ -77,13 +108,12 @@ public:
         std::enable_if<
             std::is_convertible<U, String>::value>::type* = nullptr>
     Expression(U&& expression)
-        : m_expressionString(std::forward<U>(expression))
     {
-        parseExpression(m_expressionString);
+        parseExpression(String(std::forward<U>(expression)));
     }
     /**
-     * @brief Assigns @a other to this expression and returns a reference to
-     * this expression.
+     * @brief Assigns @a other to this expression, which shares its AST with
+     * @a other, and returns a reference to this expression.
      * @param[in] other The expression that should be assigned.
      * @return Reference to this expression.
      */
@@ -100,8 +130,33 @@ public:
      * @param[in] other The expression that should be compared.
      * @return Returns true if this object is equal to the @a other, otherwise
      * false
+     *
+     * Copies of the same expression are equal without comparing their ASTs.
      */
     bool operator== (const Expression& other) const;
+    /**
+     * @brief Checks whether this expression is equivalent to the @a other,
+     * which means that their ASTs have the same canonical form, even if
+     * their string representations differ.
+     *
+     * The canonical form leaves out the nodes which don't affect the result
+     * of the expression, so for example `foo.bar`, `(foo).bar`, `foo . bar`
+     * and `@.foo.bar` are equivalent. Equivalent expressions produce the same
+     * result for every document.
+     * @param[in] other The expression that should be compared.
+     * @return Returns true if this expression is equivalent to the @a other,
+     * otherwise false.
+     */
+    bool isEquivalent(const Expression& other) const;
+    /**
+     * @brief Returns the hash of the canonical form of the AST, which is
+     * the same for equivalent expressions.
+     *
+     * The canonical form is calculated only once and it's shared between
+     * the copies of the expression.
+     * @return The hash value.
+     */
+    std::size_t structuralHash() const;
     /**
      * @brief Converts the expression to the string representation of the
      * JMESPath expression.
@@ -122,31 +177,69 @@ public:
      * empty.
      */
     const ast::ExpressionNode* astRoot() const;
+    /**
+     * @brief Sets how the expression should be evaluated. The expression is
+     * compiled when the @ref EvaluationMode::Compiled mode is set.
+     * @param[in] mode The evaluation mode.
+     */
+    void setEvaluationMode(EvaluationMode mode);
+    /**
+     * @brief Returns how the expression is evaluated.
+     * @return The evaluation mode.
+     */
+    EvaluationMode evaluationMode() const;
+    /**
+     * @brief Returns a pointer to the compiled form of the expression.
+     * @return A pointer to the compiled expression or `nullptr` if the
+     * expression is interpreted.
+     */
+    const interpreter::CompiledExpression* compiledExpression() const;
+    /**
+     * @brief Encodes the expression into a compact binary form, which can be
+     * turned back into an Expression with @ref fromBinary without parsing
+     * the expression again.
+     *
+     * The encoding starts with a format version, and it contains the string
+     * representation of the expression, its evaluation mode and its AST.
+     * @return The encoded expression.
+     */
+    std::vector<std::uint8_t> toBinary() const;
+    /**
+     * @brief Creates an Expression object from the binary form written by
+     * @ref toBinary, without parsing the expression.
+     *
+     * Expressions which were compiled when they were encoded are compiled
+     * again.
+     * @param[in] data The address of the encoded expression.
+     * @param[in] size The size of the encoded expression in bytes.
+     * @return An Expression object.
+     * @throws InvalidAgrument If the @a data doesn't contain an expression
+     * encoded with a supported version of the format.
+     */
+    static Expression fromBinary(const std::uint8_t* data, size_t size);
 
 private:
+    friend class Evaluator;
     /**
-     * @brief The ExpressionDeleter struct is a custom destruction policy
-     * for deleting ast::ExpressionNode objects.
-     *
-     * Unlike std::default_deleter it can be used to delete forward declared
-     * @ref ast::ExpressionNode.
+     * @brief The ParsedExpression struct holds the string representation and
+     * the AST of an expression, which are shared between its copies.
      */
-    struct ExpressionDeleter
-    {
-        /**
-         * @brief operator () Destroys the given @a node object.
-         * @param node An instance of ast::ExpressionNode
-         */
-        void operator()(ast::ExpressionNode* node) const;
-    };
+    struct ParsedExpression;
+    /**
+     * @brief The parsed expression, which is never modified after it's
+     * shared.
+     */
+    std::shared_ptr<const ParsedExpression> m_parsedExpression;
     /**
-     * @brief The string representation of the JMESPath expression.
+     * @brief The evaluation mode of the expression.
      */
-    String m_expressionString;
+    EvaluationMode m_evaluationMode{EvaluationMode::Interpreted};
     /**
-     * @brief The root node of the ast.
+     * @brief The compiled form of the expression, which refers to the nodes
+     * of the AST and it's shared between the copies of the expression too.
      */
-    std::unique_ptr<ast::ExpressionNode, ExpressionDeleter> m_astRoot;
+    std::shared_ptr<const interpreter::CompiledExpression>
+        m_compiledExpression;
     /**
      * @brief Parses the @a expressionString and updates the AST.
      * @param[in] expressionString The string representation of the JMESPath
@@ -154,9 +247,81 @@ private:
      * @throws SyntaxError When the syntax of the specified
      * *expressionString* is invalid.
      */
-    void parseExpression(const String &expressionString);
+    void parseExpression(String expressionString);
+    /**
+     * @brief Replaces the parsed expression with the @a expressionString and
+     * the @a root node of its AST.
+     * @param[in] expressionString The string representation of the JMESPath
+     * expression.
+     * @param[in] root The root node of the AST of the expression.
+     */
+    void setParsedExpression(String expressionString,
+                             ast::ExpressionNode&& root);
 };
 
+/**
+ * @ingroup public
+ * @brief The EquivalentExpressionHash struct is a hash function which
+ * hashes the canonical forms of @ref Expression objects.
+ *
+ * Together with @ref EquivalentExpressionEqual it can be used to key
+ * unordered containers by expressions, which stores equivalent expressions
+ * like `(foo).bar` and `@.foo.bar` only once.
+ */
+struct EquivalentExpressionHash
+{
+    /**
+     * @brief Returns the structural hash of the @a expression.
+     * @param[in] expression The hashed expression.
+     * @return The hash value.
+     */
+    std::size_t operator()(const Expression& expression) const
+    {
+        return expression.structuralHash();
+    }
+};
+
+/**
+ * @ingroup public
+ * @brief The EquivalentExpressionEqual struct compares the canonical forms
+ * of @ref Expression objects.
+ */
+struct EquivalentExpressionEqual
+{
+    /**
+     * @brief Checks whether the @a first expression is equivalent to the
+     * @a second one.
+     * @param[in] first The first expression.
+     * @param[in] second The second expression.
+     * @return Returns true if the expressions are equivalent, otherwise
+     * false.
+     */
+    bool operator()(const Expression& first, const Expression& second) const
+    {
+        return first.isEquivalent(second);
+    }
+};
+
+/**
+ * @ingroup public
+ * @brief Creates Expression objects from the binary forms written by
+ * @ref Expression::toBinary on multiple threads.
+ *
+ * The @a encodedExpressions are split into equally sized chunks, and each
+ * chunk is decoded on a separate thread. It's meant for loading large
+ * numbers of stored expressions, like when an application starts.
+ * @param[in] encodedExpressions The encoded expressions.
+ * @param[in] threadCount The number of threads which decode the
+ * expressions, or 0 to use as many threads as the number of hardware
+ * threads.
+ * @return The decoded expressions in the same order as the
+ * @a encodedExpressions.
+ * @throws InvalidAgrument If any of the @a encodedExpressions is invalid.
+ */
+std::vector<Expression> loadExpressions(
+    const std::vector<std::vector<std::uint8_t>>& encodedExpressions,
+    unsigned threadCount = 0);
+
 /**
  * @brief User defined literals
  */
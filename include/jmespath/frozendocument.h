@@ -0,0 +1,207 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef FROZENDOCUMENT_H
+#define FROZENDOCUMENT_H
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <jmespath/types.h>
+
+namespace jmespath {
+
+/**
+ * @ingroup public
+ * @brief The BinaryFormat enum lists the binary encodings of JSON documents
+ * from which a @ref FrozenDocument can be created.
+ */
+enum class BinaryFormat
+{
+    Cbor,
+    MessagePack,
+    Bson,
+    Ubjson
+};
+
+/**
+ * @ingroup public
+ * @brief The MappingValidation enum lists how thoroughly the files mapped by
+ * @ref FrozenDocument::map are validated.
+ */
+enum class MappingValidation
+{
+    /**
+     * @brief Every value of the document is validated before it's used,
+     * which reads the whole file.
+     */
+    Full,
+    /**
+     * @brief Only the header and the sizes of the tables are validated, so
+     * mapping takes constant time, but the file is trusted to be written by
+     * @ref FrozenDocument::save.
+     */
+    HeaderOnly
+};
+
+/**
+ * @ingroup public
+ * @brief The FrozenDocument class represents an immutable JSON document
+ * stored in a flat, contiguous binary layout.
+ *
+ * Every value of the document is described by a fixed size entry, and the
+ * entries are stored in document order in a single buffer together with the
+ * tables of array items, the tables of object members sorted by their keys
+ * and a pool of interned strings. Searching the document looks up object
+ * members with a binary search and array items by their index directly in
+ * the buffer, and only the values which are needed by the parts of the
+ * expression that aren't plain field and index lookups are converted into
+ * @ref Json values. Documents which are searched repeatedly, like large
+ * configuration documents, benefit the most from this layout.
+ *
+ * The document is created once, either from a @ref Json value or directly
+ * from JSON text or one of the binary formats listed in @ref BinaryFormat,
+ * and copies of the document share the same buffer. The
+ * buffer doesn't contain any pointers, so it can be saved into a file with
+ * @ref save and later memory mapped with @ref map without parsing or
+ * copying it. The pages of the mapped file are shared by every process which
+ * maps the same file, and if the file is trusted, they are only loaded on
+ * demand.
+ * @note This class is reentrant and since the document is immutable the same
+ * document can be searched concurrently from multiple threads.
+ */
+class FrozenDocument
+{
+public:
+    /**
+     * @brief Constructs a FrozenDocument object which holds a null value.
+     */
+    FrozenDocument();
+    /**
+     * @brief Constructs a FrozenDocument object from the given @a document.
+     * @param[in] document A JSON document.
+     * @throws InvalidValue If the @a document has more than 2^32 values, or
+     * a string or an array or object larger than that, or if its values are
+     * nested deeper than 1000 levels.
+     */
+    explicit FrozenDocument(const Json& document);
+    /**
+     * @brief Creates a FrozenDocument object by parsing the JSON @a text
+     * directly into the frozen layout.
+     * @param[in] text A JSON document.
+     * @return A FrozenDocument object.
+     * @throws nlohmann::json::parse_error If the @a text isn't valid JSON.
+     * @throws InvalidValue If the document is too large for the layout, as
+     * described at @ref FrozenDocument(const Json&).
+     */
+    static FrozenDocument fromText(const String& text);
+    /**
+     * @brief Creates a FrozenDocument object by reading the document encoded
+     * in the given binary @a format directly into the frozen layout, without
+     * decoding it into a @ref Json value first.
+     *
+     * Binary values, which can't be represented in JSON, are stored as null
+     * values.
+     * @param[in] data The address of the encoded document.
+     * @param[in] size The size of the encoded document in bytes.
+     * @param[in] format The format of the encoded document.
+     * @return A FrozenDocument object.
+     * @throws nlohmann::json::parse_error If the @a data isn't a valid
+     * document in the given @a format.
+     * @throws InvalidValue If the document is too large for the layout, as
+     * described at @ref FrozenDocument(const Json&).
+     */
+    static FrozenDocument fromBinary(const std::uint8_t* data,
+                                     size_t size,
+                                     BinaryFormat format);
+    /**
+     * @brief Creates a FrozenDocument object by memory mapping the file at
+     * the given @a path which was written by @ref save.
+     *
+     * With @ref MappingValidation::Full the header and every value of the
+     * document are validated once, so corrupted files are rejected instead
+     * of being read out of bounds or searched incorrectly, but it takes time
+     * proportional to the size of the document and it loads every page of
+     * the file. With
+     * @ref MappingValidation::HeaderOnly only the header is validated, which
+     * should only be used for files written by @ref save which can't be
+     * modified by others. The file must not be modified while it's mapped,
+     * since it's not validated again afterwards.
+     * @param[in] path The path of the file.
+     * @param[in] validation How thoroughly the file is validated.
+     * @return A FrozenDocument object which reads the mapped file.
+     * @throws boost::interprocess::interprocess_exception If the file can't
+     * be mapped.
+     * @throws InvalidAgrument If the file doesn't contain a valid frozen
+     * document written on a platform with the same byte order.
+     */
+    static FrozenDocument map(
+        const String& path,
+        MappingValidation validation = MappingValidation::Full);
+    /**
+     * @brief Writes the buffer of the document into the file at the given
+     * @a path, replacing its contents.
+     * @param[in] path The path of the file.
+     * @throws std::ios_base::failure If the file can't be written.
+     */
+    void save(const String& path) const;
+    /**
+     * @brief Converts the document into a @ref Json value.
+     * @return The @ref Json value of the document.
+     */
+    Json toJson() const;
+    /**
+     * @brief Returns the address of the buffer which stores the document.
+     * @return Pointer to the first byte of the buffer.
+     */
+    const unsigned char* data() const;
+    /**
+     * @brief Returns the size of the buffer which stores the document.
+     * @return The size of the buffer in bytes.
+     */
+    size_t size() const;
+
+private:
+    /**
+     * @brief Keeps the buffer of the document alive.
+     */
+    std::shared_ptr<const void> m_storage;
+    /**
+     * @brief The address of the buffer.
+     */
+    const unsigned char* m_data{nullptr};
+    /**
+     * @brief The size of the buffer in bytes.
+     */
+    size_t m_size{0};
+    /**
+     * @brief Takes the ownership of the @a buffer.
+     * @param[in] buffer The buffer which stores the document.
+     */
+    void setBuffer(std::vector<std::uint64_t>&& buffer);
+};
+} // namespace jmespath
+#endif // FROZENDOCUMENT_H
@@ -0,0 +1,154 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef INCREMENTALSEARCH_H
+#define INCREMENTALSEARCH_H
+#include <memory>
+#include <vector>
+#include <jmespath/types.h>
+#include <jmespath/expression.h>
+
+namespace jmespath {
+
+/**
+ * @ingroup public
+ * @brief The IncrementalSearch class keeps the results of a set of
+ * expressions up to date while its document is changed with JSON patches.
+ *
+ * When an expression is added, the locations of the document which its
+ * result depends on are collected from the expression, without evaluating
+ * it. After a JSON patch (RFC 6902) is applied to the document, only the
+ * expressions whose dependencies are affected by the locations changed by
+ * the patch are evaluated again, and the results of the rest of the
+ * expressions are kept.
+ * @note This class is reentrant, but a single instance shouldn't be used
+ * concurrently from multiple threads.
+ */
+class IncrementalSearch
+{
+public:
+    /**
+     * @brief Constructs an IncrementalSearch object for the given
+     * @a document.
+     * @param[in] document Input JSON document.
+     */
+    explicit IncrementalSearch(Json document);
+    /**
+     * @brief Move-constructs an IncrementalSearch object by moving the state
+     * of @a other to this object.
+     * @param[in] other The object whose state should be moved.
+     */
+    IncrementalSearch(IncrementalSearch&& other);
+    /**
+     * @brief Move-assigns @a other to this object and returns a reference
+     * to this object.
+     * @param[in] other The object that should be moved.
+     * @return Reference to this object.
+     */
+    IncrementalSearch& operator= (IncrementalSearch&& other);
+    /**
+     * @brief Destroys the object and its state.
+     */
+    ~IncrementalSearch();
+    /**
+     * @brief Adds the @a expression to the searched expressions and
+     * evaluates it on the document.
+     * @param[in] expression JMESPath expression.
+     * @return The index of the @a expression, which identifies its result.
+     * @throws InvalidAgrument If a precondition fails. Usually signals an
+     * internal error.
+     * @throws InvalidValue When an invalid value is specified for an
+     * *expression*. For example a `0` step value for a slice expression.
+     * @throws UnknownFunction When an unknown JMESPath function is called in
+     * the *expression*.
+     * @throws InvalidFunctionArgumentArity When a JMESPath function is called
+     * with an unexpected number of arguments in the *expression*.
+     * @throws InvalidFunctionArgumentType When an invalid type of argument was
+     * specified for a JMESPath function call in the *expression*.
+     */
+    size_t addExpression(const Expression& expression);
+    /**
+     * @brief Returns the number of searched expressions.
+     * @return The number of searched expressions.
+     */
+    size_t expressionCount() const;
+    /**
+     * @brief Returns the result of the expression at the given @a index.
+     * @param[in] index The index returned by @ref addExpression.
+     * @return The result of the expression evaluated on the current
+     * document.
+     * @throws Exception The error raised by the evaluation of the expression
+     * on the current document, if it failed after a patch.
+     */
+    const Json& result(size_t index) const;
+    /**
+     * @brief Returns the current document.
+     * @return The document with all the patches applied.
+     */
+    const Json& document() const;
+    /**
+     * @brief Applies the JSON @a patch to the document and evaluates the
+     * expressions which might be affected by the changes again.
+     *
+     * The patch is atomic, if any of its operations fails, the document and
+     * the results are left unchanged. If the evaluation of an affected
+     * expression fails, its error isn't thrown by this function, instead
+     * @ref result throws the error until a later patch affecting the
+     * expression fixes it.
+     * @param[in] patch A JSON patch as described by RFC 6902.
+     * @return The indices of the expressions whose results or errors changed,
+     * in ascending order.
+     * @throws nlohmann::json::exception If the @a patch is invalid or it
+     * can't be applied on the document.
+     */
+    std::vector<size_t> applyPatch(const Json& patch);
+
+private:
+    /**
+     * @brief The State struct holds the document, the expressions, their
+     * dependencies and results.
+     */
+    struct State;
+    /**
+     * @brief The StateDeleter struct is a custom destruction policy
+     * for deleting the forward declared @ref State objects.
+     */
+    struct StateDeleter
+    {
+        /**
+         * @brief operator () Destroys the given @a d object.
+         * @param state An instance of @ref State
+         */
+        void operator()(State* state) const;
+    };
+    /**
+     * @brief The state of the object.
+     */
+    std::unique_ptr<State, StateDeleter> m_state;
+};
+} // namespace jmespath
+#endif // INCREMENTALSEARCH_H
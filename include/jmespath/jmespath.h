@@ -31,6 +31,13 @@
 #include <jmespath/types.h>
 #include <jmespath/exceptions.h>
 #include <jmespath/expression.h>
+#include <jmespath/columnardocument.h>
+#include <jmespath/frozendocument.h>
+#include <jmespath/evaluator.h>
+#include <jmespath/incrementalsearch.h>
+#include <jmespath/subscriptionindex.h>
+#include <jmespath/nativefunction.h>
+#include <jmespath/staticexpression.h>
 
 /**
  * @mainpage %jmespath.cpp
@@ -331,6 +338,129 @@ template <typename JsonT>
 std::enable_if_t<std::is_same<std::decay_t<JsonT>, Json>::value, Json>
 search(const Expression& expression, JsonT&& document);
 
+/**
+ * @ingroup public
+ * @brief Finds or creates the results for the @a expression evaluated on the
+ * given columnar @a document.
+ *
+ * The fields of the objects in the arrays of the @a document are looked up
+ * from the columns of the @a document while they're projected, filtered or
+ * sorted, and the columns are created on first use.
+ * @param expression JMESPath expression.
+ * @param document Input JSON document in columnar layout.
+ * @return Result of the evaluation of the @a expression in @ref Json format
+ * @note This function is thread safe, the same @a document can be searched
+ * concurrently from multiple threads.
+ * @throws InvalidAgrument If a precondition fails. Usually signals an internal
+ * error.
+ * @throws InvalidValue When an invalid value is specified for an *expression*.
+ * For example a `0` step value for a slice expression.
+ * @throws UnknownFunction When an unknown JMESPath function is called in the
+ * *expression*.
+ * @throws InvalidFunctionArgumentArity When a JMESPath function is called with
+ * an unexpected number of arguments in the *expression*.
+ * @throws InvalidFunctionArgumentType When an invalid type of argument was
+ * specified for a JMESPath function call in the *expression*.
+ */
+Json search(const Expression& expression, const ColumnarDocument& document);
+
+/**
+ * @ingroup public
+ * @brief Finds or creates the results for the @a expression evaluated on the
+ * given frozen @a document.
+ *
+ * Field and index lookups are evaluated directly on the layout of the
+ * @a document, and only the values needed by the rest of the @a expression
+ * are converted into @ref Json values.
+ * @param expression JMESPath expression.
+ * @param document Input JSON document in frozen layout.
+ * @return Result of the evaluation of the @a expression in @ref Json format
+ * @note This function is reentrant and the same @a document can be searched
+ * concurrently from multiple threads.
+ * @throws InvalidAgrument If a precondition fails. Usually signals an internal
+ * error.
+ * @throws InvalidValue When an invalid value is specified for an *expression*.
+ * For example a `0` step value for a slice expression.
+ * @throws UnknownFunction When an unknown JMESPath function is called in the
+ * *expression*.
+ * @throws InvalidFunctionArgumentArity When a JMESPath function is called with
+ * an unexpected number of arguments in the *expression*.
+ * @throws InvalidFunctionArgumentType When an invalid type of argument was
+ * specified for a JMESPath function call in the *expression*.
+ */
+Json search(const Expression& expression, const FrozenDocument& document);
+
+/**
+ * @ingroup public
+ * @brief Evaluates the @a expression on the given @a document and writes the
+ * result in JSON format into the @a output.
+ *
+ * The output is the same as the output of `search(expression,
+ * document).dump()`, but the result isn't created as a @ref Json value. The
+ * items of projections and the values of multiselect expressions are
+ * serialized as soon as they're evaluated, and values of the @a document are
+ * serialized directly from the @a document without copying them. If the
+ * evaluation fails, the @a output might contain a partial result.
+ * @param expression JMESPath expression.
+ * @param document Input JSON document
+ * @param output The output which receives the result, either a
+ * `std::ostream`, a @ref String to which the result is appended or an
+ * @ref OutputCallback which receives the result in chunks.
+ * @note This function is reentrant.
+ * @throws InvalidAgrument If a precondition fails. Usually signals an internal
+ * error.
+ * @throws InvalidValue When an invalid value is specified for an *expression*.
+ * For example a `0` step value for a slice expression.
+ * @throws UnknownFunction When an unknown JMESPath function is called in the
+ * *expression*.
+ * @throws InvalidFunctionArgumentArity When a JMESPath function is called with
+ * an unexpected number of arguments in the *expression*.
+ * @throws InvalidFunctionArgumentType When an invalid type of argument was
+ * specified for a JMESPath function call in the *expression*.
+ * @{
+ */
+void search(const Expression& expression,
+            const Json& document,
+            std::ostream& output);
+void search(const Expression& expression,
+            const Json& document,
+            String& output);
+void search(const Expression& expression,
+            const Json& document,
+            const OutputCallback& output);
+/** @}*/
+
+/**
+ * @ingroup public
+ * @brief Finds or creates the results for the @a expression evaluated on the
+ * given @a document with the state owned by the @a evaluator instead of the
+ * state of the calling thread.
+ * @param expression JMESPath expression.
+ * @param document Input JSON document, either a @ref Json value, a
+ * @ref ColumnarDocument or a @ref FrozenDocument.
+ * @param evaluator The evaluator used for the evaluation.
+ * @return Result of the evaluation of the @a expression in @ref Json format
+ * @note The same @a evaluator shouldn't be used concurrently from multiple
+ * threads.
+ * @throws InvalidAgrument If a precondition fails. Usually signals an internal
+ * error.
+ * @throws InvalidValue When an invalid value is specified for an *expression*.
+ * For example a `0` step value for a slice expression.
+ * @throws UnknownFunction When an unknown JMESPath function is called in the
+ * *expression*.
+ * @throws InvalidFunctionArgumentArity When a JMESPath function is called with
+ * an unexpected number of arguments in the *expression*.
+ * @throws InvalidFunctionArgumentType When an invalid type of argument was
+ * specified for a JMESPath function call in the *expression*.
+ */
+template <typename DocumentT>
+inline Json search(const Expression& expression,
+                   DocumentT&& document,
+                   Evaluator& evaluator)
+{
+    return evaluator.search(expression, std::forward<DocumentT>(document));
+}
+
 /**
  * @brief Explicit instantiation declaration for @ref search to prevent
  * implicit instantiation in client code.
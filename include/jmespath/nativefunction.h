@@ -0,0 +1,145 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef NATIVEFUNCTION_H
+#define NATIVEFUNCTION_H
+#include <functional>
+#include <vector>
+#include <jmespath/types.h>
+
+namespace jmespath {
+
+/**
+ * @ingroup public
+ * @brief The ArgumentType enum lists the types which the arguments of
+ * native functions can be declared with.
+ */
+enum class ArgumentType
+{
+    Any,
+    Null,
+    Boolean,
+    Number,
+    String,
+    Array,
+    Object
+};
+
+/**
+ * @ingroup public
+ * @brief The NativeArgument class gives access to an argument of a native
+ * function without copying it.
+ *
+ * The argument either refers to a value of the searched document or to a
+ * temporary value created by the evaluation of the expression. Temporary
+ * values can be moved out of the argument with @ref take, while values of the
+ * document are copied.
+ * @note Arguments are only valid during the call of the function.
+ */
+class NativeArgument
+{
+public:
+    /**
+     * @brief Constructs a NativeArgument object which refers to the @a value
+     * of the document.
+     * @param[in] value A value of the searched document.
+     */
+    explicit NativeArgument(const Json& value);
+    /**
+     * @brief Constructs a NativeArgument object which refers to the temporary
+     * @a value, which can be moved out of the argument.
+     * @param[in] value A temporary value.
+     */
+    explicit NativeArgument(Json&& value);
+    /**
+     * @brief Returns the value of the argument.
+     * @return Reference to the value of the argument.
+     */
+    const Json& value() const;
+    /**
+     * @brief Returns whether the value is a temporary value.
+     * @return Returns true if the value is a temporary value, or false if it
+     * refers to a value of the document.
+     */
+    bool isTemporary() const;
+    /**
+     * @brief Takes the value out of the argument, by moving it if it's a
+     * temporary value or by copying it otherwise.
+     * @return The value of the argument.
+     */
+    Json take();
+
+private:
+    /**
+     * @brief The value of the argument.
+     */
+    const Json* m_value;
+    /**
+     * @brief The value of the argument if it's a temporary value, otherwise
+     * `nullptr`.
+     */
+    Json* m_temporary{nullptr};
+};
+
+/**
+ * @ingroup public
+ * @brief Type of the native functions, which receive their arguments and
+ * return their result.
+ */
+using NativeFunction = std::function<Json(std::vector<NativeArgument>&)>;
+
+/**
+ * @ingroup public
+ * @brief Registers a native @a function which can be called from
+ * expressions by its @a name, just like the built in functions.
+ *
+ * Before the @a function is called, the number and the types of the
+ * arguments are validated against the declared @a argumentTypes, and
+ * @ref InvalidFunctionArgumentArity or @ref InvalidFunctionArgumentType is
+ * thrown if they don't match, so the @a function only has to validate the
+ * values of its arguments. Expression type arguments, like `&field`, are not
+ * supported by native functions. Compiled expressions resolve the function
+ * when they're compiled, while interpreted expressions resolve it on their
+ * first call. Both look the function up again only after a function has
+ * been registered, so they always call the last registered function without
+ * locking the registry on every call.
+ * @param[in] name The name of the function.
+ * @param[in] argumentTypes The types of the arguments.
+ * @param[in] function The implementation of the function.
+ * @param[in] isVariadic If true, the last argument can be repeated any
+ * number of times, including zero.
+ * @note This function is thread safe.
+ * @throws InvalidAgrument If the @a name is empty or it's the name of a
+ * built in function, if the @a function is empty, or if the function is
+ * variadic without any declared arguments.
+ */
+void registerFunction(const String& name,
+                      std::vector<ArgumentType> argumentTypes,
+                      NativeFunction function,
+                      bool isVariadic = false);
+} // namespace jmespath
+#endif // NATIVEFUNCTION_H
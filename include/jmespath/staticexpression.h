@@ -0,0 +1,485 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef STATICEXPRESSION_H
+#define STATICEXPRESSION_H
+#include <utility>
+#include <jmespath/types.h>
+#include <jmespath/expression.h>
+
+/**
+ * @ingroup public
+ * @brief Defines a @ref jmespath::StaticExpression from the string literal
+ * @a expression, which is parsed at compile time.
+ *
+ * The @a expression should be a path made of field names and array indices,
+ * like `"a.b[0]"` or `"\"quoted name\"[-1].c"`. Other kinds of expressions and
+ * invalid syntax are reported as compile errors.
+ * @param expression A string literal containing a JMESPath expression.
+ */
+#define JMESPATH_STATIC(expression) \
+    ([] { \
+        struct StaticExpressionSource \
+        { \
+            static constexpr const char* value() \
+            { \
+                return expression; \
+            } \
+        }; \
+        return ::jmespath::StaticExpression<StaticExpressionSource>{}; \
+    }())
+
+namespace jmespath {
+
+/**
+ * @brief Contains the compile time parser and evaluator of
+ * @ref StaticExpression objects.
+ */
+namespace compiletime {
+
+/**
+ * @brief The type of the segments of static paths.
+ */
+enum class SegmentType
+{
+    Invalid,
+    Field,
+    Index
+};
+
+/**
+ * @brief The Segment struct describes a field name or an array index in a
+ * static path.
+ */
+struct Segment
+{
+    /**
+     * @brief The type of the segment.
+     */
+    SegmentType type = SegmentType::Invalid;
+    /**
+     * @brief The position of the first character of the field name.
+     */
+    size_t begin = 0;
+    /**
+     * @brief The length of the field name.
+     */
+    size_t length = 0;
+    /**
+     * @brief The array index.
+     */
+    long long index = 0;
+};
+
+/**
+ * @brief The Scanner class splits a static path into @ref Segment objects.
+ */
+class Scanner
+{
+public:
+    /**
+     * @brief Constructs a Scanner object which scans the @a expression.
+     * @param[in] expression The null terminated expression string.
+     */
+    constexpr explicit Scanner(const char* expression)
+        : m_expression(expression)
+    {
+    }
+    /**
+     * @brief Checks whether the whole expression has been scanned.
+     * @return Returns true if there are no more characters left.
+     */
+    constexpr bool atEnd() const
+    {
+        return m_expression[m_position] == '\0';
+    }
+    /**
+     * @brief Scans the next segment of the expression.
+     * @return The next segment, or an invalid segment if the syntax of the
+     * expression is invalid at the current position.
+     */
+    constexpr Segment next()
+    {
+        Segment segment;
+        char current = m_expression[m_position];
+        // every segment except the first one starts with a separator
+        if (!m_isFirst)
+        {
+            if (current == '.')
+            {
+                current = m_expression[++m_position];
+                if (current == '[')
+                {
+                    return segment;
+                }
+            }
+            else if (current != '[')
+            {
+                return segment;
+            }
+        }
+        m_isFirst = false;
+        if (current == '[')
+        {
+            return scanIndex();
+        }
+        if (current == '"')
+        {
+            return scanQuotedField();
+        }
+        return scanField();
+    }
+
+private:
+    /**
+     * @brief The expression string.
+     */
+    const char* m_expression;
+    /**
+     * @brief The position of the next unscanned character.
+     */
+    size_t m_position = 0;
+    /**
+     * @brief Marks whether the first segment is being scanned.
+     */
+    bool m_isFirst = true;
+
+    /**
+     * @brief Checks whether @a c can start an unquoted field name.
+     * @param[in] c A character.
+     * @return Returns true if @a c is a letter or an underscore.
+     */
+    static constexpr bool isAlpha(char c)
+    {
+        return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z'))
+            || (c == '_');
+    }
+    /**
+     * @brief Checks whether @a c is a decimal digit.
+     * @param[in] c A character.
+     * @return Returns true if @a c is a decimal digit.
+     */
+    static constexpr bool isDigit(char c)
+    {
+        return (c >= '0') && (c <= '9');
+    }
+    /**
+     * @brief Scans an unquoted field name.
+     * @return The scanned segment.
+     */
+    constexpr Segment scanField()
+    {
+        Segment segment;
+        if (!isAlpha(m_expression[m_position]))
+        {
+            return segment;
+        }
+        segment.begin = m_position;
+        while (isAlpha(m_expression[m_position])
+               || isDigit(m_expression[m_position]))
+        {
+            ++m_position;
+        }
+        segment.type = SegmentType::Field;
+        segment.length = m_position - segment.begin;
+        return segment;
+    }
+    /**
+     * @brief Scans a quoted field name, which shouldn't contain escape
+     * sequences.
+     * @return The scanned segment.
+     */
+    constexpr Segment scanQuotedField()
+    {
+        Segment segment;
+        segment.begin = ++m_position;
+        while ((m_expression[m_position] != '"')
+               && (m_expression[m_position] != '\\')
+               && (m_expression[m_position] != '\0'))
+        {
+            ++m_position;
+        }
+        if ((m_expression[m_position] != '"')
+            || (m_position == segment.begin))
+        {
+            return segment;
+        }
+        segment.type = SegmentType::Field;
+        segment.length = m_position++ - segment.begin;
+        return segment;
+    }
+    /**
+     * @brief Scans an array index in brackets.
+     * @return The scanned segment.
+     */
+    constexpr Segment scanIndex()
+    {
+        Segment segment;
+        bool isNegative = (m_expression[++m_position] == '-');
+        if (isNegative)
+        {
+            ++m_position;
+        }
+        size_t digitCount = 0;
+        while (isDigit(m_expression[m_position]))
+        {
+            // reject indices which would overflow
+            if (++digitCount > 18)
+            {
+                return segment;
+            }
+            segment.index = segment.index * 10
+                + (m_expression[m_position++] - '0');
+        }
+        if ((digitCount == 0) || (m_expression[m_position] != ']'))
+        {
+            return segment;
+        }
+        ++m_position;
+        segment.type = SegmentType::Index;
+        segment.index = isNegative ? -segment.index : segment.index;
+        return segment;
+    }
+};
+
+/**
+ * @brief Returns the number of segments in the static path @a expression.
+ * @param[in] expression The null terminated expression string.
+ * @return The number of segments, or 0 if the syntax of the @a expression is
+ * invalid.
+ */
+constexpr size_t segmentCount(const char* expression)
+{
+    Scanner scanner{expression};
+    size_t count = 0;
+    while (!scanner.atEnd())
+    {
+        if (scanner.next().type == SegmentType::Invalid)
+        {
+            return 0;
+        }
+        ++count;
+    }
+    return count;
+}
+
+/**
+ * @brief Returns the segment at the given @a position in the static path
+ * @a expression.
+ * @param[in] expression The null terminated expression string.
+ * @param[in] position The position of the segment.
+ * @return The segment at @a position.
+ */
+constexpr Segment segmentAt(const char* expression, size_t position)
+{
+    Scanner scanner{expression};
+    Segment segment = scanner.next();
+    for (size_t i = 0; i < position; ++i)
+    {
+        segment = scanner.next();
+    }
+    return segment;
+}
+
+/**
+ * @brief The PathSegment class template looks up the value selected by the
+ * segment at @a Position of the static path defined by @a SourceT.
+ * @tparam SourceT The type which defines the expression string.
+ * @tparam Position The position of the segment.
+ * @tparam Type The type of the segment.
+ */
+template <typename SourceT,
+          size_t Position,
+          SegmentType Type = segmentAt(SourceT::value(), Position).type>
+struct PathSegment;
+
+/**
+ * @brief Specialization of PathSegment for field names.
+ */
+template <typename SourceT, size_t Position>
+struct PathSegment<SourceT, Position, SegmentType::Field>
+{
+    /**
+     * @brief Looks up the field in @a value.
+     * @param[in] value Pointer to a JSON value.
+     * @return Pointer to the field's value, or `nullptr` if @a value isn't
+     * an object or it doesn't have such field.
+     */
+    static const Json* apply(const Json* value)
+    {
+        if (!value->is_object())
+        {
+            return nullptr;
+        }
+        constexpr Segment segment = segmentAt(SourceT::value(), Position);
+        static const String fieldName(SourceT::value() + segment.begin,
+                                      segment.length);
+        auto it = value->find(fieldName);
+        return (it != value->end()) ? &*it : nullptr;
+    }
+};
+
+/**
+ * @brief Specialization of PathSegment for array indices.
+ */
+template <typename SourceT, size_t Position>
+struct PathSegment<SourceT, Position, SegmentType::Index>
+{
+    /**
+     * @brief Looks up the item at the index in @a value.
+     * @param[in] value Pointer to a JSON value.
+     * @return Pointer to the item, or `nullptr` if @a value isn't an array or
+     * the index is out of range.
+     */
+    static const Json* apply(const Json* value)
+    {
+        if (!value->is_array())
+        {
+            return nullptr;
+        }
+        constexpr long long index = segmentAt(SourceT::value(),
+                                              Position).index;
+        // negative indices refer to items from the end of the array
+        long long size = static_cast<long long>(value->size());
+        long long position = (index < 0) ? (size + index) : index;
+        if ((position < 0) || (position >= size))
+        {
+            return nullptr;
+        }
+        return &(*value)[static_cast<size_t>(position)];
+    }
+};
+
+/**
+ * @brief Looks up the value selected by the static path defined by
+ * @a SourceT in the @a document.
+ * @param[in] document The JSON document.
+ * @tparam SourceT The type which defines the expression string.
+ * @tparam Positions The positions of the path's segments.
+ * @return Pointer to the selected value, or `nullptr` if the path doesn't
+ * select any value.
+ */
+template <typename SourceT, size_t... Positions>
+const Json* findPath(const Json& document, std::index_sequence<Positions...>)
+{
+    const Json* value = &document;
+    using Expand = int[];
+    static_cast<void>(Expand{0, (value = value
+        ? PathSegment<SourceT, Positions>::apply(value)
+        : nullptr, 0)...});
+    return value;
+}
+} // namespace compiletime
+
+/**
+ * @ingroup public
+ * @brief The StaticExpression class template represents a JMESPath expression
+ * which is parsed at compile time.
+ *
+ * Static expressions are limited to paths of field names and array indices.
+ * The path is turned into a sequence of types which look up the fields and
+ * items directly, so evaluating a static expression involves no parsing, no
+ * virtual dispatch and no variant visitation. Objects of this type should be
+ * created with the @ref JMESPATH_STATIC macro.
+ * @tparam SourceT The type which defines the expression string with a static
+ * `constexpr const char* value()` function.
+ */
+template <typename SourceT>
+class StaticExpression
+{
+public:
+    /**
+     * @brief The number of field names and array indices in the path.
+     */
+    static constexpr size_t segmentCount
+        = compiletime::segmentCount(SourceT::value());
+    static_assert(segmentCount > 0,
+                  "The expression isn't a valid static JMESPath expression. "
+                  "Only paths of field names and array indices are "
+                  "supported.");
+
+    /**
+     * @brief Converts the expression to the string representation of the
+     * JMESPath expression.
+     * @return String representation of the JMESPath expression.
+     */
+    static String toString()
+    {
+        return SourceT::value();
+    }
+    /**
+     * @brief Converts the static expression to an equivalent @ref Expression.
+     * @return An Expression object.
+     */
+    static Expression toExpression()
+    {
+        return Expression{toString()};
+    }
+    /**
+     * @brief Looks up the value selected by the expression in the
+     * @a document without copying it.
+     * @param[in] document The JSON document.
+     * @return Pointer to the selected value, or `nullptr` if the expression
+     * evaluates to null.
+     */
+    static const Json* find(const Json& document)
+    {
+        return compiletime::findPath<SourceT>(
+            document,
+            std::make_index_sequence<segmentCount>{});
+    }
+    /**
+     * @brief Evaluates the expression on the @a document.
+     * @param[in] document The JSON document.
+     * @return Result of the evaluation of the expression in @ref Json format
+     */
+    static Json search(const Json& document)
+    {
+        const Json* value = find(document);
+        return value ? *value : Json{};
+    }
+};
+
+template <typename SourceT>
+constexpr size_t StaticExpression<SourceT>::segmentCount;
+
+/**
+ * @ingroup public
+ * @brief Finds the results for the static @a expression evaluated on the
+ * given @a document.
+ * @param expression JMESPath expression created with @ref JMESPATH_STATIC.
+ * @param document Input JSON document
+ * @return Result of the evaluation of the @a expression in @ref Json format
+ */
+template <typename SourceT>
+inline Json search(const StaticExpression<SourceT>& expression,
+                   const Json& document)
+{
+    return expression.search(document);
+}
+} // namespace jmespath
+#endif // STATICEXPRESSION_H
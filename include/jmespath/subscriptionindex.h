@@ -0,0 +1,134 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef SUBSCRIPTIONINDEX_H
+#define SUBSCRIPTIONINDEX_H
+#include <memory>
+#include <vector>
+#include <jmespath/types.h>
+#include <jmespath/expression.h>
+
+namespace jmespath {
+
+/**
+ * @ingroup public
+ * @brief The SubscriptionIndex class finds which of a large number of
+ * predicate expressions match a document, without evaluating every
+ * predicate.
+ *
+ * When a predicate is added, it's decomposed into the equality comparisons
+ * of paths made of field names and array indices with literal values, like
+ * `type == 'order'`, which are joined by `&&` and `||` operators. The
+ * comparisons which the predicate can't be true without are stored in an
+ * index by their path and literal value. When a document is matched, the
+ * value of each indexed path is looked up only once, and only the
+ * predicates found in the index by these values are evaluated, together with
+ * the predicates which couldn't be indexed. Predicates which consist only of
+ * equality comparisons joined by `||` operators match without being
+ * evaluated.
+ * @note This class is reentrant, but a single instance shouldn't be used
+ * concurrently from multiple threads.
+ */
+class SubscriptionIndex
+{
+public:
+    /**
+     * @brief Constructs an empty SubscriptionIndex object.
+     */
+    SubscriptionIndex();
+    /**
+     * @brief Move-constructs a SubscriptionIndex object by moving the state
+     * of @a other to this object.
+     * @param[in] other The object whose state should be moved.
+     */
+    SubscriptionIndex(SubscriptionIndex&& other);
+    /**
+     * @brief Move-assigns @a other to this object and returns a reference
+     * to this object.
+     * @param[in] other The object that should be moved.
+     * @return Reference to this object.
+     */
+    SubscriptionIndex& operator= (SubscriptionIndex&& other);
+    /**
+     * @brief Destroys the index and its state.
+     */
+    ~SubscriptionIndex();
+    /**
+     * @brief Adds the @a predicate to the index.
+     * @param[in] predicate JMESPath expression which matches a document if
+     * its result is a true like value.
+     * @return The index of the @a predicate, which identifies it in the
+     * results of @ref match.
+     */
+    size_t addSubscription(const Expression& predicate);
+    /**
+     * @brief Returns the number of predicates in the index.
+     * @return The number of predicates.
+     */
+    size_t subscriptionCount() const;
+    /**
+     * @brief Finds the predicates which match the @a document.
+     * @param[in] document Input JSON document.
+     * @return The indices of the matching predicates in ascending order.
+     * @throws InvalidAgrument If a precondition fails. Usually signals an
+     * internal error.
+     * @throws InvalidValue When an invalid value is specified for a
+     * *predicate*. For example a `0` step value for a slice expression.
+     * @throws UnknownFunction When an unknown JMESPath function is called in
+     * a *predicate*.
+     * @throws InvalidFunctionArgumentArity When a JMESPath function is called
+     * with an unexpected number of arguments in a *predicate*.
+     * @throws InvalidFunctionArgumentType When an invalid type of argument was
+     * specified for a JMESPath function call in a *predicate*.
+     */
+    std::vector<size_t> match(const Json& document);
+
+private:
+    /**
+     * @brief The State struct holds the predicates, the index and the
+     * interpreter used for evaluating the predicates.
+     */
+    struct State;
+    /**
+     * @brief The StateDeleter struct is a custom destruction policy
+     * for deleting the forward declared @ref State objects.
+     */
+    struct StateDeleter
+    {
+        /**
+         * @brief operator () Destroys the given @a d object.
+         * @param state An instance of @ref State
+         */
+        void operator()(State* state) const;
+    };
+    /**
+     * @brief The state of the index.
+     */
+    std::unique_ptr<State, StateDeleter> m_state;
+};
+} // namespace jmespath
+#endif // SUBSCRIPTIONINDEX_H
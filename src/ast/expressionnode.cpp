@@ -38,6 +38,12 @@ ExpressionNode::~ExpressionNode()
 {
 }
 
+ExpressionNode::ExpressionNode(ExpressionNode &&other)
+    : VariantNode()
+{
+    takeValue(other);
+}
+
 ExpressionNode::ExpressionNode(const ValueType &expression)
     : VariantNode(expression)
 {
@@ -52,6 +58,15 @@ ExpressionNode &ExpressionNode::operator=(const ExpressionNode &other)
     return *this;
 }
 
+ExpressionNode &ExpressionNode::operator=(ExpressionNode &&other)
+{
+    if (this != &other)
+    {
+        takeValue(other);
+    }
+    return *this;
+}
+
 ExpressionNode &ExpressionNode::operator=(const ValueType &expression)
 {
     value = expression;
@@ -80,6 +80,11 @@ public:
      * @brief Copy-constructs an ExpressionNode object.
      */
     ExpressionNode(const ExpressionNode&) = default;
+    /**
+     * @brief Move-constructs an ExpressionNode object, leaving the @a other
+     * object empty.
+     */
+    ExpressionNode(ExpressionNode&& other);
     /**
      * @brief Destroys the ExpressionNode object.
      */
@@ -96,6 +101,13 @@ public:
      * @return Returns a reference to this object.
      */
     ExpressionNode& operator=(const ExpressionNode& other);
+    /**
+     * @brief Moves the @a other object's expression to this object, leaving
+     * the @a other object empty.
+     * @param[in] other An ExpressionNode object.
+     * @return Returns a reference to this object.
+     */
+    ExpressionNode& operator=(ExpressionNode&& other);
     /**
      * @brief Assigns the @a other Expression to this object's expression.
      * @param[in] expression An Expression object.
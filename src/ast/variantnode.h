@@ -58,6 +58,16 @@ public:
      * @brief Copy-constructs an VariantNode object.
      */
     VariantNode(const VariantNode&) = default;
+    /**
+     * @brief Move-constructs a VariantNode object, leaving the @a other
+     * object empty.
+     * @param[in] other The object whose value should be taken.
+     */
+    VariantNode(VariantNode&& other)
+        : AbstractNode()
+    {
+        takeValue(other);
+    }
     /**
      * @brief Copy constructs a VariantNode object if T is VariantNode or
      * constructs a VariantNode object with T as the represented node type with
@@ -82,6 +92,20 @@ public:
         }
         return *this;
     }
+    /**
+     * @brief Moves the @a other object's value to this object, leaving the
+     * @a other object empty.
+     * @param[in] other The object whos value should be moved to this object.
+     * @return Returns a reference to this object.
+     */
+    VariantNode<VariantT...>& operator=(VariantNode&& other)
+    {
+        if (this != &other)
+        {
+            takeValue(other);
+        }
+        return *this;
+    }
     /**
      * @brief Assigns the value of the @a other object to this object's internal
      * variant making it the node that this object represents.
@@ -124,6 +148,49 @@ public:
      * @brief The variable which stores the node that this object represents.
      */
     ValueType value;
+
+protected:
+    /**
+     * @brief Takes the value of the @a other object and leaves it empty.
+     *
+     * The variant holds the nodes in recursive wrappers, whose move
+     * assignment only exchanges the pointers to the nodes, while their move
+     * construction moves the whole subtree into a new allocation. So if the
+     * values represent different types of nodes, this object is set to an
+     * empty node of the @a other object's type first, to make the move an
+     * assignment.
+     * @param[in] other The object whose value should be taken.
+     */
+    void takeValue(VariantNode& other)
+    {
+        if (value.which() != other.value.which())
+        {
+            boost::apply_visitor(EmptyValueAssigner{&value}, other.value);
+        }
+        value = std::move(other.value);
+        other.value = boost::blank{};
+    }
+
+private:
+    /**
+     * @brief The EmptyValueAssigner struct is a visitor which assigns an
+     * empty node of the visited node's type to the target variant.
+     */
+    struct EmptyValueAssigner : boost::static_visitor<>
+    {
+        ValueType* target;
+
+        EmptyValueAssigner(ValueType* target)
+            : target{target}
+        {
+        }
+
+        template <typename T>
+        void operator()(const T&) const
+        {
+            *target = T{};
+        }
+    };
 };
 }} // namespace jmespath::ast
 #endif // VARIANTNODE_H
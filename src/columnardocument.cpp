@@ -0,0 +1,78 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "jmespath/columnardocument.h"
+#include "src/interpreter/columncache.h"
+
+namespace jmespath {
+
+ColumnarDocument::ColumnarDocument(Json document)
+    : m_document(new Json(std::move(document))),
+      m_columns(new interpreter::ColumnCache(*m_document))
+{
+}
+
+ColumnarDocument::ColumnarDocument(ColumnarDocument &&other)
+    : ColumnarDocument(Json{})
+{
+    *this = std::move(other);
+}
+
+ColumnarDocument& ColumnarDocument::operator=(ColumnarDocument &&other)
+{
+    if (this != &other)
+    {
+        // swap the values so the moved from object remains in a valid state
+        std::swap(m_document, other.m_document);
+        std::swap(m_columns, other.m_columns);
+    }
+    return *this;
+}
+
+ColumnarDocument::~ColumnarDocument() = default;
+
+const Json &ColumnarDocument::document() const
+{
+    return *m_document;
+}
+
+size_t ColumnarDocument::columnCount() const
+{
+    return m_columns->size();
+}
+
+interpreter::ColumnCache *ColumnarDocument::columnCache() const
+{
+    return m_columns.get();
+}
+
+void ColumnarDocument::ColumnCacheDeleter::operator()(
+    interpreter::ColumnCache *cache) const
+{
+    delete cache;
+}
+} // namespace jmespath
@@ -0,0 +1,237 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "jmespath/evaluator.h"
+#include "src/interpreter/interpreter.h"
+#include "src/interpreter/compiledexpression.h"
+#include "src/interpreter/frozenevaluator.h"
+#include "src/interpreter/resultwriter.h"
+#include "src/ast/expressionnode.h"
+
+namespace jmespath {
+
+struct Evaluator::State
+{
+    /**
+     * @brief The interpreter used for evaluating expressions.
+     */
+    interpreter::Interpreter interpreter;
+
+    /**
+     * @brief Evaluates the @a expression on the @a document.
+     * @param[in] expression JMESPath expression.
+     * @param[in] document Input JSON document.
+     * @tparam JsonT The type of the @a document.
+     * @return The result of the evaluation.
+     */
+    template <typename JsonT>
+    Json evaluate(const Expression& expression, JsonT&& document)
+    {
+        // evaluate compiled expressions by calling their closures
+        if (auto compiledExpression = expression.compiledExpression())
+        {
+            interpreter::ContextValue result = compiledExpression->evaluate(
+                document,
+                &interpreter);
+            return takeResult(&result);
+        }
+        interpreter.setContext(std::forward<JsonT>(document));
+        // evaluate the expression by calling visit with the root of the AST
+        interpreter.visit(expression.astRoot());
+        return takeResult(&interpreter.currentContextValue());
+    }
+    /**
+     * @brief Evaluates the @a expression on the @a document and writes the
+     * result into the @a output.
+     * @param[in] expression JMESPath expression.
+     * @param[in] document Input JSON document.
+     * @param[in] output The output where the result is written.
+     */
+    void write(const Expression& expression,
+               const Json& document,
+               interpreter::OutputAdapter output)
+    {
+        interpreter::ResultWriter writer{&interpreter, std::move(output)};
+        if (expression.isEmpty())
+        {
+            writer.write(Json{});
+        }
+        // write the result of compiled expressions after evaluating them,
+        // without copying it if it refers to the document
+        else if (auto compiledExpression = expression.compiledExpression())
+        {
+            interpreter::ContextValue result = compiledExpression->evaluate(
+                document,
+                &interpreter);
+            writer.write(interpreter::getJsonValue(result));
+            interpreter.setContext(Json{});
+        }
+        else
+        {
+            writer.write(expression.astRoot(), document);
+        }
+    }
+    /**
+     * @brief Extracts the result of an evaluation from the @a contextValue.
+     * @param[in] contextValue The result of the evaluation.
+     * @return The result of the evaluation.
+     */
+    Json takeResult(interpreter::ContextValue* contextValue)
+    {
+        // copy the context value if it's a reference or a shared value, or
+        // move it into the local result variable if it's owned by the
+        // context, and return the result of the function by value. this
+        // approach leaves open the possibility for the compiler to use copy
+        // elision to optimize away any further copies or moves
+        Json result = interpreter::takeJsonValue(std::move(*contextValue));
+        // don't keep the moved from value or the reference to the document
+        // in the context of the interpreter
+        interpreter.setContext(Json{});
+        return result;
+    }
+};
+
+Evaluator::Evaluator()
+    : m_state(new State)
+{
+}
+
+Evaluator::Evaluator(Evaluator &&other)
+    : Evaluator()
+{
+    *this = std::move(other);
+}
+
+Evaluator &Evaluator::operator=(Evaluator &&other)
+{
+    if (this != &other)
+    {
+        // swap the states so the moved from object remains usable
+        std::swap(m_state, other.m_state);
+    }
+    return *this;
+}
+
+Evaluator::~Evaluator() = default;
+
+Expression Evaluator::parse(const String &expressionString)
+{
+    Expression expression;
+    expression.parseExpression(expressionString);
+    return expression;
+}
+
+Json Evaluator::search(const Expression &expression, const Json &document)
+{
+    if (expression.isEmpty())
+    {
+        return {};
+    }
+    return m_state->evaluate(expression, document);
+}
+
+Json Evaluator::search(const Expression &expression, Json &&document)
+{
+    if (expression.isEmpty())
+    {
+        return {};
+    }
+    return m_state->evaluate(expression, std::move(document));
+}
+
+Json Evaluator::search(const Expression &expression,
+                       const ColumnarDocument &document)
+{
+    if (expression.isEmpty())
+    {
+        return {};
+    }
+    // make sure that the interpreter doesn't keep a reference to the columns
+    // of the document after the evaluation
+    struct ColumnCacheGuard
+    {
+        interpreter::Interpreter& interpreter;
+        ~ColumnCacheGuard()
+        {
+            interpreter.setColumnCache(nullptr);
+        }
+    } guard{m_state->interpreter};
+    m_state->interpreter.setColumnCache(document.columnCache());
+    return m_state->evaluate(expression, document.document());
+}
+
+Json Evaluator::search(const Expression &expression,
+                       const FrozenDocument &document)
+{
+    if (expression.isEmpty())
+    {
+        return {};
+    }
+    interpreter::FrozenLayout layout(document.data(), document.size());
+    interpreter::FrozenEvaluator evaluator(layout, &m_state->interpreter);
+    return evaluator.evaluate(expression.astRoot());
+}
+
+void Evaluator::search(const Expression &expression,
+                       const Json &document,
+                       std::ostream &output)
+{
+    m_state->write(expression,
+                   document,
+                   interpreter::makeOutputAdapter(output));
+}
+
+void Evaluator::search(const Expression &expression,
+                       const Json &document,
+                       String &output)
+{
+    m_state->write(expression,
+                   document,
+                   interpreter::makeOutputAdapter(output));
+}
+
+void Evaluator::search(const Expression &expression,
+                       const Json &document,
+                       const OutputCallback &output)
+{
+    auto adapter = std::make_shared<interpreter::CallbackOutputAdapter>(
+        output);
+    m_state->write(expression, document, adapter);
+    adapter->flush();
+}
+
+void Evaluator::reset()
+{
+    m_state->interpreter.setContext(Json{});
+    m_state->interpreter.setColumnCache(nullptr);
+}
+
+void Evaluator::StateDeleter::operator()(State *state) const
+{
+    delete state;
+}
+} // namespace jmespath
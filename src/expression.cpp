@@ -28,18 +28,85 @@
 #include "jmespath/expression.h"
 #include "src/parser/parser.h"
 #include "src/parser/grammar.h"
+#include "src/interpreter/compiledexpression.h"
+#include "src/interpreter/astencoder.h"
+#include "src/interpreter/astdecoder.h"
+#include "src/interpreter/canonicalencoder.h"
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
 
 namespace jmespath {
 
+namespace {
+/**
+ * @brief The bytes at the start of every encoded expression.
+ */
+constexpr std::uint8_t binaryMagic[] = {'J', 'M', 'E', 'X'};
+/**
+ * @brief The version of the binary encoding of expressions, which should be
+ * incremented whenever the encoding changes.
+ */
+constexpr std::uint8_t binaryVersion = 1;
+} // anonymous namespace
+
+struct Expression::ParsedExpression
+{
+    /**
+     * @brief The string representation of the JMESPath expression.
+     */
+    String expressionString;
+    /**
+     * @brief The root node of the AST.
+     */
+    ast::ExpressionNode root;
+    /**
+     * @brief Makes sure that the canonical form is calculated only once,
+     * even if it's requested by multiple threads.
+     */
+    mutable std::once_flag canonicalFormFlag;
+    /**
+     * @brief The canonical form of the AST written by
+     * interpreter::CanonicalEncoder, which is calculated on first use.
+     */
+    mutable std::vector<std::uint8_t> canonicalForm;
+    /**
+     * @brief The hash of the canonical form.
+     */
+    mutable std::size_t structuralHash{0};
+
+    /**
+     * @brief Calculates the canonical form and its hash if they weren't
+     * calculated yet.
+     */
+    void calculateCanonicalForm() const
+    {
+        std::call_once(canonicalFormFlag, [this]() {
+            interpreter::CanonicalEncoder{&canonicalForm}.encode(&root);
+            structuralHash = interpreter::CanonicalEncoder::hash(
+                canonicalForm);
+        });
+    }
+};
+
 Expression::Expression()
-    : m_astRoot(new ast::ExpressionNode)
 {
+    // every empty expression shares the same parsed form
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wexit-time-destructors"
+    static const std::shared_ptr<const ParsedExpression> s_emptyExpression
+        = std::make_shared<ParsedExpression>();
+#pragma clang diagnostic pop
+    m_parsedExpression = s_emptyExpression;
 }
 
 Expression::Expression(const Expression &other)
-    : Expression()
+    : m_parsedExpression(other.m_parsedExpression),
+      m_evaluationMode(other.m_evaluationMode),
+      m_compiledExpression(other.m_compiledExpression)
 {
-    *this = other;
 }
 
 Expression::Expression(Expression &&other)
@@ -51,8 +118,10 @@ Expression& Expression::operator=(const Expression &other)
 {
     if (this != &other)
     {
-        m_expressionString = other.m_expressionString;
-        *m_astRoot = *other.m_astRoot;
+        // release the compiled form before the AST which it refers to
+        m_compiledExpression = other.m_compiledExpression;
+        m_parsedExpression = other.m_parsedExpression;
+        m_evaluationMode = other.m_evaluationMode;
     }
     return *this;
 }
@@ -61,55 +130,243 @@ Expression& Expression::operator=(Expression &&other)
 {
     if (this != &other)
     {
-        m_expressionString = std::move(other.m_expressionString);
-        m_astRoot = std::move(other.m_astRoot);
+        m_compiledExpression = std::move(other.m_compiledExpression);
+        m_parsedExpression = std::move(other.m_parsedExpression);
+        m_evaluationMode = other.m_evaluationMode;
     }
     return *this;
 }
 
 String Expression::toString() const
 {
-    return m_expressionString;
+    if (m_parsedExpression)
+    {
+        return m_parsedExpression->expressionString;
+    }
+    return {};
 }
 
 bool Expression::isEmpty() const
 {
-    return (!m_astRoot || m_astRoot->isNull());
+    return (!m_parsedExpression || m_parsedExpression->root.isNull());
 }
 
 const ast::ExpressionNode *Expression::astRoot() const
 {
-    return m_astRoot.get();
+    if (m_parsedExpression)
+    {
+        return &m_parsedExpression->root;
+    }
+    return nullptr;
 }
 
-void Expression::parseExpression(const String& expressionString)
+void Expression::setEvaluationMode(EvaluationMode mode)
 {
-    if (!m_astRoot)
+    m_evaluationMode = mode;
+    if ((mode == EvaluationMode::Compiled) && !isEmpty())
     {
-        m_astRoot.reset(new ast::ExpressionNode);
+        m_compiledExpression
+            = std::make_shared<interpreter::CompiledExpression>(
+                m_parsedExpression->root);
     }
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wexit-time-destructors"
-     thread_local parser::Parser<parser::Grammar> s_parser;
-#pragma clang diagnostic pop
-    *m_astRoot = s_parser.parse(expressionString);
+    else
+    {
+        m_compiledExpression.reset();
+    }
+}
+
+EvaluationMode Expression::evaluationMode() const
+{
+    return m_evaluationMode;
+}
+
+const interpreter::CompiledExpression *Expression::compiledExpression() const
+{
+    return m_compiledExpression.get();
+}
+
+void Expression::parseExpression(String expressionString)
+{
+    auto root = parser::Parser<parser::Grammar>::instance().parse(
+        expressionString);
+    setParsedExpression(std::move(expressionString), std::move(root));
+}
+
+void Expression::setParsedExpression(String expressionString,
+                                     ast::ExpressionNode &&root)
+{
+    auto parsedExpression = std::make_shared<ParsedExpression>();
+    parsedExpression->expressionString = std::move(expressionString);
+    parsedExpression->root = std::move(root);
+    // the compiled form refers to the nodes of the replaced AST
+    m_compiledExpression.reset();
+    m_parsedExpression = std::move(parsedExpression);
+    setEvaluationMode(m_evaluationMode);
+}
+
+std::vector<std::uint8_t> Expression::toBinary() const
+{
+    using interpreter::AstEncoder;
+
+    std::vector<std::uint8_t> output(std::begin(binaryMagic),
+                                     std::end(binaryMagic));
+    String expressionString = toString();
+    output.reserve(expressionString.size() * 2 + 16);
+    output.push_back(binaryVersion);
+    output.push_back(static_cast<std::uint8_t>(m_evaluationMode));
+    AstEncoder::writeString(expressionString, &output);
+    if (isEmpty())
+    {
+        output.push_back(static_cast<std::uint8_t>(
+                             interpreter::NodeTag::Empty));
+    }
+    else
+    {
+        AstEncoder{&output}.encode(astRoot());
+    }
+    return output;
+}
+
+Expression Expression::fromBinary(const std::uint8_t *data, size_t size)
+{
+    // check the magic bytes and the version before reading anything else
+    if ((size < sizeof(binaryMagic) + 1)
+        || !std::equal(std::begin(binaryMagic), std::end(binaryMagic), data)
+        || (data[sizeof(binaryMagic)] != binaryVersion))
+    {
+        BOOST_THROW_EXCEPTION(InvalidAgrument{});
+    }
+    interpreter::AstDecoder decoder{data + sizeof(binaryMagic) + 1,
+                                    size - sizeof(binaryMagic) - 1};
+    auto mode = static_cast<EvaluationMode>(decoder.readByte());
+    if ((mode != EvaluationMode::Interpreted)
+        && (mode != EvaluationMode::Compiled))
+    {
+        BOOST_THROW_EXCEPTION(InvalidAgrument{});
+    }
+    String expressionString = decoder.readString();
+    ast::ExpressionNode root;
+    decoder.decode(&root);
+    if (!decoder.atEnd())
+    {
+        BOOST_THROW_EXCEPTION(InvalidAgrument{});
+    }
+    Expression expression;
+    expression.m_evaluationMode = mode;
+    expression.setParsedExpression(std::move(expressionString),
+                                   std::move(root));
+    return expression;
 }
 
 bool Expression::operator==(const Expression &other) const
 {
-    if (this != &other)
+    // copies of the same expression share their parsed forms
+    if (m_parsedExpression == other.m_parsedExpression)
+    {
+        return true;
+    }
+    if (!m_parsedExpression || !other.m_parsedExpression)
+    {
+        return false;
+    }
+    return (m_parsedExpression->expressionString
+            == other.m_parsedExpression->expressionString)
+            && (m_parsedExpression->root == other.m_parsedExpression->root);
+}
+
+bool Expression::isEquivalent(const Expression &other) const
+{
+    if (m_parsedExpression == other.m_parsedExpression)
     {
-        return (m_expressionString == other.m_expressionString)
-                && (*m_astRoot == *other.m_astRoot);
+        return true;
     }
-    return true;
+    // moved from expressions are equivalent to empty ones
+    if (!m_parsedExpression || !other.m_parsedExpression)
+    {
+        return isEmpty() && other.isEmpty();
+    }
+    m_parsedExpression->calculateCanonicalForm();
+    other.m_parsedExpression->calculateCanonicalForm();
+    return (m_parsedExpression->structuralHash
+            == other.m_parsedExpression->structuralHash)
+            && (m_parsedExpression->canonicalForm
+                == other.m_parsedExpression->canonicalForm);
 }
 
-void Expression::ExpressionDeleter::operator()(ast::ExpressionNode *node) const
+std::size_t Expression::structuralHash() const
 {
-    if (node)
+    // moved from expressions are hashed like empty ones
+    if (!m_parsedExpression)
+    {
+        return Expression{}.structuralHash();
+    }
+    m_parsedExpression->calculateCanonicalForm();
+    return m_parsedExpression->structuralHash;
+}
+
+std::vector<Expression> loadExpressions(
+    const std::vector<std::vector<std::uint8_t>>& encodedExpressions,
+    unsigned threadCount)
+{
+    std::vector<Expression> expressions(encodedExpressions.size());
+    if (threadCount == 0)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    // don't start more threads than the number of expressions
+    threadCount = static_cast<unsigned>(std::max<size_t>(
+        std::min<size_t>(threadCount, encodedExpressions.size()), 1));
+    size_t chunkSize = (encodedExpressions.size() + threadCount - 1)
+        / threadCount;
+    // decode the chunks of the expressions on separate threads, and keep the
+    // first error which is rethrown after every thread finished
+    auto decodeChunk = [&](size_t begin,
+                           size_t end,
+                           std::exception_ptr* error) {
+        try
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const auto& encodedExpression = encodedExpressions[i];
+                expressions[i] = Expression::fromBinary(
+                    encodedExpression.data(),
+                    encodedExpression.size());
+            }
+        }
+        catch (...)
+        {
+            *error = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    std::vector<std::exception_ptr> errors(threadCount);
+    for (size_t begin = 0, chunk = 0; begin < encodedExpressions.size();
+         begin += chunkSize, ++chunk)
+    {
+        size_t end = std::min(begin + chunkSize, encodedExpressions.size());
+        // if a thread can't be created, decode its chunk on the calling
+        // thread, so the threads which are already running still get joined
+        try
+        {
+            threads.emplace_back(decodeChunk, begin, end, &errors[chunk]);
+        }
+        catch (const std::system_error&)
+        {
+            decodeChunk(begin, end, &errors[chunk]);
+        }
+    }
+    for (auto& thread: threads)
+    {
+        thread.join();
+    }
+    for (const auto& error: errors)
     {
-        delete node;
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
     }
+    return expressions;
 }
 } // namespace jmespath
@@ -0,0 +1,142 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "jmespath/frozendocument.h"
+#include "src/interpreter/frozenlayout.h"
+#include <fstream>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace jmespath {
+
+FrozenDocument::FrozenDocument()
+    : FrozenDocument(Json{})
+{
+}
+
+FrozenDocument::FrozenDocument(const Json &document)
+{
+    setBuffer(interpreter::FrozenLayoutBuilder::build(document));
+}
+
+FrozenDocument FrozenDocument::fromText(const String &text)
+{
+    FrozenDocument document;
+    document.setBuffer(interpreter::FrozenLayoutBuilder::build(text));
+    return document;
+}
+
+FrozenDocument FrozenDocument::fromBinary(const std::uint8_t *data,
+                                          size_t size,
+                                          BinaryFormat format)
+{
+    Json::input_format_t inputFormat = Json::input_format_t::cbor;
+    switch (format)
+    {
+    case BinaryFormat::Cbor:
+        inputFormat = Json::input_format_t::cbor;
+        break;
+    case BinaryFormat::MessagePack:
+        inputFormat = Json::input_format_t::msgpack;
+        break;
+    case BinaryFormat::Bson:
+        inputFormat = Json::input_format_t::bson;
+        break;
+    case BinaryFormat::Ubjson:
+        inputFormat = Json::input_format_t::ubjson;
+        break;
+    }
+    FrozenDocument document;
+    document.setBuffer(
+        interpreter::FrozenLayoutBuilder::build(data, size, inputFormat));
+    return document;
+}
+
+FrozenDocument FrozenDocument::map(const String &path,
+                                   MappingValidation validation)
+{
+    namespace ipc = boost::interprocess;
+    // the region must be destroyed before the file mapping
+    struct Mapping
+    {
+        ipc::file_mapping file;
+        ipc::mapped_region region;
+    };
+    auto mapping = std::make_shared<Mapping>();
+    mapping->file = ipc::file_mapping{path.c_str(), ipc::read_only};
+    mapping->region = ipc::mapped_region{mapping->file, ipc::read_only};
+    FrozenDocument document;
+    document.m_data = static_cast<const unsigned char*>(
+        mapping->region.get_address());
+    document.m_size = mapping->region.get_size();
+    // the header is always validated, while the whole layout is validated
+    // before the document is used only if the file might not have been
+    // written by save
+    interpreter::FrozenLayout layout{document.m_data, document.m_size};
+    if (validation == MappingValidation::Full)
+    {
+        layout.validate();
+    }
+    document.m_storage = std::move(mapping);
+    return document;
+}
+
+void FrozenDocument::save(const String &path) const
+{
+    std::ofstream file;
+    file.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+    file.open(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(m_data),
+               static_cast<std::streamsize>(m_size));
+    file.close();
+}
+
+Json FrozenDocument::toJson() const
+{
+    interpreter::FrozenLayout layout(m_data, m_size);
+    return layout.toJson(layout.root());
+}
+
+const unsigned char *FrozenDocument::data() const
+{
+    return m_data;
+}
+
+size_t FrozenDocument::size() const
+{
+    return m_size;
+}
+
+void FrozenDocument::setBuffer(std::vector<std::uint64_t> &&buffer)
+{
+    auto storage = std::make_shared<const std::vector<std::uint64_t>>(
+        std::move(buffer));
+    m_data = reinterpret_cast<const unsigned char*>(storage->data());
+    m_size = storage->size() * sizeof(std::uint64_t);
+    m_storage = std::move(storage);
+}
+} // namespace jmespath
@@ -0,0 +1,524 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "jmespath/incrementalsearch.h"
+#include "jmespath/evaluator.h"
+#include "src/interpreter/dependencyanalyzer.h"
+#include "src/ast/expressionnode.h"
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+
+namespace jmespath {
+
+namespace {
+/**
+ * @brief Splits the JSON @a pointer into its reference tokens.
+ * @param[in] pointer A JSON pointer as described by RFC 6901.
+ * @return The unescaped reference tokens of the @a pointer.
+ */
+std::vector<String> pointerTokens(const String& pointer)
+{
+    std::vector<String> tokens;
+    size_t start = pointer.find('/');
+    while (start != String::npos)
+    {
+        size_t end = pointer.find('/', start + 1);
+        String token = pointer.substr(start + 1, end == String::npos
+                                                 ? String::npos
+                                                 : end - start - 1);
+        // unescape "~1" before "~0" as described in RFC 6901
+        for (auto position = token.find("~1");
+             position != String::npos;
+             position = token.find("~1", position + 1))
+        {
+            token.replace(position, 2, "/");
+        }
+        for (auto position = token.find("~0");
+             position != String::npos;
+             position = token.find("~0", position + 1))
+        {
+            token.replace(position, 2, "~");
+        }
+        tokens.push_back(std::move(token));
+        start = end;
+    }
+    return tokens;
+}
+
+/**
+ * @brief Converts the reference @a token of a JSON pointer into an array
+ * index.
+ * @param[in] token A reference token.
+ * @param[out] index The array index described by the @a token.
+ * @return Returns true if the @a token is a valid array index, otherwise
+ * false.
+ */
+bool toArrayIndex(const String& token, size_t* index)
+{
+    // indices with leading zeros are invalid, and long indices are left to
+    // nlohmann_json, which reports them as out of range
+    if (token.empty()
+        || token.size() > 18
+        || (token.size() > 1 && token[0] == '0')
+        || !std::all_of(token.cbegin(), token.cend(), [](Char character) {
+               return character >= '0' && character <= '9';
+           }))
+    {
+        return false;
+    }
+    *index = std::stoull(token);
+    return true;
+}
+
+/**
+ * @brief The InPlacePatch class applies the operations of a JSON patch
+ * directly on a document, and records how to undo them, so the document can
+ * be restored without keeping a copy of it.
+ *
+ * The operations follow the behavior of nlohmann_json's patch function. An
+ * operation which can't be applied isn't reported with an error, instead
+ * the patch should be rolled back and applied with nlohmann_json which
+ * reports the error.
+ */
+class InPlacePatch
+{
+public:
+    /**
+     * @brief Constructs an InPlacePatch object for the given @a document.
+     * @param[in] document The patched document.
+     */
+    explicit InPlacePatch(Json* document)
+        : m_document(document)
+    {
+    }
+    /**
+     * @brief Applies the operations of the @a patch on the document.
+     * @param[in] patch A JSON patch as described by RFC 6902.
+     * @return Returns true if every operation was applied, otherwise false.
+     * @throws nlohmann::json::exception If an operation is malformed or it
+     * refers to a missing value.
+     */
+    bool apply(const Json& patch)
+    {
+        if (!patch.is_array())
+        {
+            return false;
+        }
+        for (const auto& operation: patch)
+        {
+            if (!operation.is_object())
+            {
+                return false;
+            }
+            const auto& name = operation.at("op").get_ref<const String&>();
+            Json::json_pointer pointer{operation.at("path").get<String>()};
+            bool isApplied = false;
+            if (name == "add")
+            {
+                isApplied = add(pointer, operation.at("value"));
+            }
+            else if (name == "remove")
+            {
+                isApplied = remove(pointer);
+            }
+            else if (name == "replace")
+            {
+                isApplied = remove(pointer)
+                    && add(pointer, operation.at("value"));
+            }
+            else if (name == "move" || name == "copy")
+            {
+                Json::json_pointer from{operation.at("from").get<String>()};
+                Json value = m_document->at(from);
+                isApplied = (name == "copy" || remove(from))
+                    && add(pointer, std::move(value));
+            }
+            else if (name == "test")
+            {
+                isApplied = m_document->at(pointer) == operation.at("value");
+            }
+            if (!isApplied)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    /**
+     * @brief Undoes the operations applied on the document in reverse
+     * order.
+     */
+    void rollback()
+    {
+        for (auto it = m_undoLog.rbegin(); it != m_undoLog.rend(); ++it)
+        {
+            if (it->kind == UndoKind::Restore)
+            {
+                m_document->at(it->pointer) = std::move(it->value);
+                continue;
+            }
+            Json& parent = m_document->at(it->pointer.parent_pointer());
+            const String& key = it->pointer.back();
+            size_t index = 0;
+            if (parent.is_object())
+            {
+                if (it->kind == UndoKind::Erase)
+                {
+                    parent.erase(key);
+                }
+                else
+                {
+                    parent[key] = std::move(it->value);
+                }
+            }
+            else if (toArrayIndex(key, &index))
+            {
+                if (it->kind == UndoKind::Erase)
+                {
+                    parent.erase(index);
+                }
+                else
+                {
+                    parent.insert(parent.begin()
+                                  + static_cast<std::ptrdiff_t>(index),
+                                  std::move(it->value));
+                }
+            }
+        }
+        m_undoLog.clear();
+    }
+
+private:
+    /**
+     * @brief The kinds of steps which undo a change of the document.
+     */
+    enum class UndoKind
+    {
+        Restore, /**< Replace the value at the pointer with the old value */
+        Erase,   /**< Remove the added value at the pointer */
+        Insert   /**< Insert the removed value at the pointer */
+    };
+    /**
+     * @brief The Undo struct describes how to undo a change of the document.
+     */
+    struct Undo
+    {
+        UndoKind kind;
+        Json::json_pointer pointer;
+        Json value;
+    };
+    Json* m_document;
+    std::vector<Undo> m_undoLog;
+
+    /**
+     * @brief Adds the @a value at the location of the @a pointer.
+     * @return Returns true if the value was added, otherwise false.
+     */
+    bool add(const Json::json_pointer& pointer, Json value)
+    {
+        // adding to the root of the document replaces the document
+        if (pointer.empty())
+        {
+            m_undoLog.push_back({UndoKind::Restore,
+                                 pointer,
+                                 std::move(*m_document)});
+            *m_document = std::move(value);
+            return true;
+        }
+        Json::json_pointer parentPointer = pointer.parent_pointer();
+        Json& parent = m_document->at(parentPointer);
+        const String& key = pointer.back();
+        if (parent.is_null())
+        {
+            m_undoLog.push_back({UndoKind::Restore, parentPointer, Json{}});
+            parent = Json::object();
+        }
+        if (parent.is_object())
+        {
+            auto it = parent.find(key);
+            if (it != parent.end())
+            {
+                m_undoLog.push_back({UndoKind::Restore,
+                                     pointer,
+                                     std::move(*it)});
+                *it = std::move(value);
+            }
+            else
+            {
+                m_undoLog.push_back({UndoKind::Erase, pointer, Json{}});
+                parent.emplace(key, std::move(value));
+            }
+            return true;
+        }
+        size_t index = parent.size();
+        if (!parent.is_array()
+            || (key != "-"
+                && (!toArrayIndex(key, &index) || index > parent.size())))
+        {
+            return false;
+        }
+        parent.insert(parent.begin() + static_cast<std::ptrdiff_t>(index),
+                      std::move(value));
+        m_undoLog.push_back({UndoKind::Erase, parentPointer / index, Json{}});
+        return true;
+    }
+    /**
+     * @brief Removes the value at the location of the @a pointer.
+     * @return Returns true if the value was removed, otherwise false.
+     */
+    bool remove(const Json::json_pointer& pointer)
+    {
+        if (pointer.empty())
+        {
+            return false;
+        }
+        Json& parent = m_document->at(pointer.parent_pointer());
+        const String& key = pointer.back();
+        if (parent.is_object())
+        {
+            auto it = parent.find(key);
+            if (it == parent.end())
+            {
+                return false;
+            }
+            m_undoLog.push_back({UndoKind::Insert, pointer, std::move(*it)});
+            parent.erase(it);
+            return true;
+        }
+        size_t index = 0;
+        if (!parent.is_array()
+            || !toArrayIndex(key, &index)
+            || index >= parent.size())
+        {
+            return false;
+        }
+        m_undoLog.push_back({UndoKind::Insert, pointer,
+                             std::move(parent[index])});
+        parent.erase(index);
+        return true;
+    }
+};
+} // anonymous namespace
+
+struct IncrementalSearch::State
+{
+    /**
+     * @brief The Entry struct describes a searched expression.
+     */
+    struct Entry
+    {
+        /**
+         * @brief The searched expression.
+         */
+        Expression expression;
+        /**
+         * @brief The locations of the document which the result depends on.
+         */
+        std::vector<interpreter::Dependency> dependencies;
+        /**
+         * @brief The result of the expression on the current document.
+         */
+        Json result;
+        /**
+         * @brief The error raised by the evaluation of the expression on the
+         * current document or `nullptr` if it succeeded.
+         */
+        std::exception_ptr error;
+    };
+
+    /**
+     * @brief The searched document.
+     */
+    Json document;
+    /**
+     * @brief The evaluator used for evaluating the expressions.
+     */
+    Evaluator evaluator;
+    /**
+     * @brief The searched expressions.
+     */
+    std::vector<Entry> entries;
+
+    /**
+     * @brief Evaluates the expression of the @a entry again.
+     *
+     * If the evaluation fails, the error is stored in the @a entry instead
+     * of being thrown, so the rest of the entries can still be updated.
+     * @param[in] entry The entry of the expression.
+     * @return Returns true if the result or the error changed, otherwise
+     * returns false.
+     */
+    bool update(Entry& entry)
+    {
+        Json result;
+        try
+        {
+            result = evaluator.search(entry.expression, document);
+        }
+        catch (...)
+        {
+            entry.result = Json{};
+            entry.error = std::current_exception();
+            return true;
+        }
+        if (!entry.error && result == entry.result)
+        {
+            return false;
+        }
+        entry.result = std::move(result);
+        entry.error = nullptr;
+        return true;
+    }
+};
+
+IncrementalSearch::IncrementalSearch(Json document)
+    : m_state(new State)
+{
+    m_state->document = std::move(document);
+}
+
+IncrementalSearch::IncrementalSearch(IncrementalSearch &&other)
+    : IncrementalSearch(Json{})
+{
+    *this = std::move(other);
+}
+
+IncrementalSearch &IncrementalSearch::operator=(IncrementalSearch &&other)
+{
+    if (this != &other)
+    {
+        // swap the states so the moved from object remains usable
+        std::swap(m_state, other.m_state);
+    }
+    return *this;
+}
+
+IncrementalSearch::~IncrementalSearch() = default;
+
+size_t IncrementalSearch::addExpression(const Expression &expression)
+{
+    State::Entry entry{expression, {}, {}, {}};
+    if (!expression.isEmpty())
+    {
+        interpreter::DependencyAnalyzer analyzer;
+        entry.dependencies = analyzer.analyze(expression.astRoot());
+    }
+    entry.result = m_state->evaluator.search(expression, m_state->document);
+    m_state->entries.push_back(std::move(entry));
+    return m_state->entries.size() - 1;
+}
+
+size_t IncrementalSearch::expressionCount() const
+{
+    return m_state->entries.size();
+}
+
+const Json &IncrementalSearch::result(size_t index) const
+{
+    const auto& entry = m_state->entries.at(index);
+    if (entry.error)
+    {
+        std::rethrow_exception(entry.error);
+    }
+    return entry.result;
+}
+
+const Json &IncrementalSearch::document() const
+{
+    return m_state->document;
+}
+
+std::vector<size_t> IncrementalSearch::applyPatch(const Json &patch)
+{
+    std::vector<size_t> changedIndices;
+    // patch the document in place to avoid copying it, and if an operation
+    // fails undo the applied operations and let nlohmann_json patch a copy
+    // of the document, which reports the error and leaves the document and
+    // the results untouched as required by RFC 6902
+    InPlacePatch inPlacePatch{&m_state->document};
+    bool isApplied = false;
+    try
+    {
+        isApplied = inPlacePatch.apply(patch);
+    }
+    catch (const Json::exception&)
+    {
+    }
+    if (!isApplied)
+    {
+        inPlacePatch.rollback();
+        m_state->document = m_state->document.patch(patch);
+    }
+
+    // collect the locations changed by the operations of the patch, tests
+    // don't change the document and copies only change their target
+    std::vector<std::vector<String>> changedLocations;
+    for (const auto& operation: patch)
+    {
+        const auto& name = operation.at("op");
+        if (name != "test")
+        {
+            changedLocations.push_back(
+                pointerTokens(operation.at("path").get<String>()));
+        }
+        if (name == "move")
+        {
+            changedLocations.push_back(
+                pointerTokens(operation.at("from").get<String>()));
+        }
+    }
+
+    // evaluate the expressions which depend on the changed locations again,
+    // failed evaluations are stored in their entries and reported by result
+    for (size_t i = 0; i < m_state->entries.size(); ++i)
+    {
+        auto& entry = m_state->entries[i];
+        bool isAffected = std::any_of(
+            entry.dependencies.cbegin(),
+            entry.dependencies.cend(),
+            [&](const interpreter::Dependency& dependency) {
+                return std::any_of(
+                    changedLocations.cbegin(),
+                    changedLocations.cend(),
+                    [&](const std::vector<String>& location) {
+                        return dependency.isAffectedBy(location);
+                    });
+            });
+        if (isAffected && m_state->update(entry))
+        {
+            changedIndices.push_back(i);
+        }
+    }
+    return changedIndices;
+}
+
+void IncrementalSearch::StateDeleter::operator()(State *state) const
+{
+    delete state;
+}
+} // namespace jmespath
@@ -0,0 +1,292 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "src/interpreter/astdecoder.h"
+#include "jmespath/exceptions.h"
+
+namespace jmespath { namespace interpreter {
+
+constexpr size_t AstDecoder::maxDepth;
+
+AstDecoder::AstDecoder(const std::uint8_t *data, size_t size)
+    : m_position{data},
+      m_end{data + size}
+{
+}
+
+void AstDecoder::decode(ast::ExpressionNode *node)
+{
+    readExpression(readTag(), node);
+}
+
+std::uint8_t AstDecoder::readByte()
+{
+    if (m_position == m_end)
+    {
+        BOOST_THROW_EXCEPTION(InvalidAgrument{});
+    }
+    return *m_position++;
+}
+
+std::uint64_t AstDecoder::readVarint()
+{
+    std::uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+        std::uint8_t byte = readByte();
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return value;
+        }
+    }
+    BOOST_THROW_EXCEPTION(InvalidAgrument{});
+}
+
+String AstDecoder::readString()
+{
+    std::uint64_t size = readVarint();
+    if (size > static_cast<std::uint64_t>(m_end - m_position))
+    {
+        BOOST_THROW_EXCEPTION(InvalidAgrument{});
+    }
+    String string(reinterpret_cast<const char*>(m_position),
+                  static_cast<size_t>(size));
+    m_position += size;
+    return string;
+}
+
+bool AstDecoder::atEnd() const
+{
+    return m_position == m_end;
+}
+
+NodeTag AstDecoder::readTag()
+{
+    std::uint8_t tag = readByte();
+    if (tag > static_cast<std::uint8_t>(NodeTag::FilterExpression))
+    {
+        BOOST_THROW_EXCEPTION(InvalidAgrument{});
+    }
+    return static_cast<NodeTag>(tag);
+}
+
+Index AstDecoder::readIndex()
+{
+    bool isNegative = readByte() != 0;
+    Index index{readVarint()};
+    return isNegative ? Index{-index} : index;
+}
+
+size_t AstDecoder::readItemCount()
+{
+    std::uint64_t count = readVarint();
+    if (count > static_cast<std::uint64_t>(m_end - m_position))
+    {
+        BOOST_THROW_EXCEPTION(InvalidAgrument{});
+    }
+    return static_cast<size_t>(count);
+}
+
+void AstDecoder::readExpression(NodeTag tag, ast::ExpressionNode *node)
+{
+    // the child nodes are read recursively, so the nesting has to be limited
+    // to keep corrupted data from exhausting the stack
+    if (m_depth == maxDepth)
+    {
+        BOOST_THROW_EXCEPTION(InvalidAgrument{});
+    }
+    struct DepthGuard
+    {
+        size_t& depth;
+        ~DepthGuard()
+        {
+            --depth;
+        }
+    } guard{++m_depth};
+    switch (tag)
+    {
+    case NodeTag::Empty:
+        node->value = boost::blank{};
+        break;
+    case NodeTag::Identifier:
+        emplace<ast::IdentifierNode>(node).identifier = readString();
+        break;
+    case NodeTag::RawString:
+        emplace<ast::RawStringNode>(node).rawString = readString();
+        break;
+    case NodeTag::Literal:
+        emplace<ast::LiteralNode>(node).literal = readString();
+        break;
+    case NodeTag::Subexpression:
+        readChildren(&emplace<ast::SubexpressionNode>(node));
+        break;
+    case NodeTag::IndexExpression:
+    {
+        auto& indexExpression = emplace<ast::IndexExpressionNode>(node);
+        readBracketSpecifier(&indexExpression.bracketSpecifier);
+        readChildren(&indexExpression);
+        break;
+    }
+    case NodeTag::HashWildcard:
+        readChildren(&emplace<ast::HashWildcardNode>(node));
+        break;
+    case NodeTag::MultiselectList:
+    {
+        auto& expressions = emplace<ast::MultiselectListNode>(node)
+            .expressions;
+        expressions.resize(readItemCount());
+        for (auto& expression: expressions)
+        {
+            decode(&expression);
+        }
+        break;
+    }
+    case NodeTag::MultiselectHash:
+    {
+        auto& expressions = emplace<ast::MultiselectHashNode>(node)
+            .expressions;
+        expressions.resize(readItemCount());
+        for (auto& keyValuePair: expressions)
+        {
+            keyValuePair.first.identifier = readString();
+            decode(&keyValuePair.second);
+        }
+        break;
+    }
+    case NodeTag::NotExpression:
+        decode(&emplace<ast::NotExpressionNode>(node).expression);
+        break;
+    case NodeTag::ComparatorExpression:
+    {
+        auto& comparatorExpression
+            = emplace<ast::ComparatorExpressionNode>(node);
+        using Comparator = ast::ComparatorExpressionNode::Comparator;
+        std::uint8_t comparator = readByte();
+        if (comparator > static_cast<std::uint8_t>(Comparator::NotEqual))
+        {
+            BOOST_THROW_EXCEPTION(InvalidAgrument{});
+        }
+        comparatorExpression.comparator = static_cast<Comparator>(comparator);
+        readChildren(&comparatorExpression);
+        break;
+    }
+    case NodeTag::OrExpression:
+        readChildren(&emplace<ast::OrExpressionNode>(node));
+        break;
+    case NodeTag::AndExpression:
+        readChildren(&emplace<ast::AndExpressionNode>(node));
+        break;
+    case NodeTag::ParenExpression:
+        decode(&emplace<ast::ParenExpressionNode>(node).expression);
+        break;
+    case NodeTag::PipeExpression:
+        readChildren(&emplace<ast::PipeExpressionNode>(node));
+        break;
+    case NodeTag::Current:
+        emplace<ast::CurrentNode>(node);
+        break;
+    case NodeTag::FunctionExpression:
+        readArguments(&emplace<ast::FunctionExpressionNode>(node));
+        break;
+    // the remaining tags can't be used for expressions
+    default:
+        BOOST_THROW_EXCEPTION(InvalidAgrument{});
+    }
+}
+
+void AstDecoder::readChildren(ast::BinaryExpressionNode *node)
+{
+    decode(&node->leftExpression);
+    decode(&node->rightExpression);
+}
+
+void AstDecoder::readBracketSpecifier(ast::BracketSpecifierNode *node)
+{
+    switch (readTag())
+    {
+    case NodeTag::Empty:
+        node->value = boost::blank{};
+        break;
+    case NodeTag::ArrayItem:
+        emplace<ast::ArrayItemNode>(node).index = readIndex();
+        break;
+    case NodeTag::FlattenOperator:
+        emplace<ast::FlattenOperatorNode>(node);
+        break;
+    case NodeTag::SliceExpression:
+    {
+        auto& slice = emplace<ast::SliceExpressionNode>(node);
+        std::uint8_t presentIndices = readByte();
+        if (presentIndices & 0x01)
+        {
+            slice.start = readIndex();
+        }
+        if (presentIndices & 0x02)
+        {
+            slice.stop = readIndex();
+        }
+        if (presentIndices & 0x04)
+        {
+            slice.step = readIndex();
+        }
+        break;
+    }
+    case NodeTag::ListWildcard:
+        emplace<ast::ListWildcardNode>(node);
+        break;
+    case NodeTag::FilterExpression:
+        decode(&emplace<ast::FilterExpressionNode>(node).expression);
+        break;
+    // the remaining tags can't be used for bracket specifiers
+    default:
+        BOOST_THROW_EXCEPTION(InvalidAgrument{});
+    }
+}
+
+void AstDecoder::readArguments(ast::FunctionExpressionNode *node)
+{
+    node->functionName = readString();
+    node->arguments.resize(readItemCount());
+    for (auto& argument: node->arguments)
+    {
+        NodeTag tag = readTag();
+        if (tag == NodeTag::ExpressionArgument)
+        {
+            argument = ast::ExpressionArgumentNode{};
+            decode(&boost::get<ast::ExpressionArgumentNode>(argument)
+                   .expression);
+        }
+        else if (tag != NodeTag::Empty)
+        {
+            argument = ast::ExpressionNode{};
+            readExpression(tag,
+                           &boost::get<ast::ExpressionNode>(argument));
+        }
+    }
+}
+}} // namespace jmespath::interpreter
@@ -0,0 +1,164 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef ASTDECODER_H
+#define ASTDECODER_H
+#include "src/interpreter/astencoder.h"
+#include "src/ast/allnodes.h"
+
+namespace jmespath { namespace interpreter {
+
+/**
+ * @brief The AstDecoder class reads the binary encoding written by
+ * @ref AstEncoder and creates the nodes of the AST directly, without
+ * parsing the expression.
+ *
+ * Every read is bounds checked and the nesting of the expressions is
+ * limited, so truncated or corrupted data is reported with an exception
+ * instead of creating an invalid AST or exhausting the stack.
+ */
+class AstDecoder
+{
+public:
+    /**
+     * @brief The maximum nesting depth of the decoded expressions.
+     */
+    static constexpr size_t maxDepth = 1000;
+
+    /**
+     * @brief Constructs an AstDecoder object which reads the given @a data.
+     * @param[in] data The address of the encoded data.
+     * @param[in] size The size of the encoded data in bytes.
+     */
+    AstDecoder(const std::uint8_t* data, size_t size);
+    /**
+     * @brief Reads an AST into the given @a node.
+     * @param[out] node The node which becomes the root of the AST.
+     * @throws InvalidAgrument If the data doesn't contain a valid AST, or
+     * if the expressions are nested deeper than @ref maxDepth.
+     */
+    void decode(ast::ExpressionNode* node);
+    /**
+     * @brief Reads a single byte.
+     * @return The value of the byte.
+     * @throws InvalidAgrument If there's no more data.
+     */
+    std::uint8_t readByte();
+    /**
+     * @brief Reads a variable length unsigned integer.
+     * @return The value of the integer.
+     * @throws InvalidAgrument If the integer is truncated or too long.
+     */
+    std::uint64_t readVarint();
+    /**
+     * @brief Reads a string written as its length followed by its bytes.
+     * @return The string.
+     * @throws InvalidAgrument If the string is truncated.
+     */
+    String readString();
+    /**
+     * @brief Checks whether every byte of the data has been read.
+     * @return Returns true if the whole data has been read, otherwise
+     * returns false.
+     */
+    bool atEnd() const;
+
+private:
+    /**
+     * @brief The address of the next byte.
+     */
+    const std::uint8_t* m_position;
+    /**
+     * @brief The address past the last byte.
+     */
+    const std::uint8_t* m_end;
+    /**
+     * @brief The nesting depth of the expression which is currently read.
+     */
+    size_t m_depth{0};
+
+    /**
+     * @brief Reads the tag of a node.
+     * @return The tag of the node.
+     * @throws InvalidAgrument If the tag is unknown.
+     */
+    NodeTag readTag();
+    /**
+     * @brief Reads an array index written as its sign and its magnitude.
+     * @return The index.
+     */
+    Index readIndex();
+    /**
+     * @brief Reads the number of items of a list and checks that it's not
+     * larger than the number of the remaining bytes, since every item takes
+     * at least a byte.
+     * @return The number of items.
+     */
+    size_t readItemCount();
+    /**
+     * @brief Reads the fields and the child nodes of an expression whose
+     * @a tag has been read already into the given @a node.
+     * @param[in] tag The tag of the node.
+     * @param[out] node The node which receives the expression.
+     * @throws InvalidAgrument If the expression is nested deeper than
+     * @ref maxDepth.
+     */
+    void readExpression(NodeTag tag, ast::ExpressionNode* node);
+    /**
+     * @brief Reads the child nodes of a binary expression.
+     * @param[out] node The binary expression.
+     */
+    void readChildren(ast::BinaryExpressionNode* node);
+    /**
+     * @brief Reads a bracket specifier into the given @a node.
+     * @param[out] node The node which receives the bracket specifier.
+     */
+    void readBracketSpecifier(ast::BracketSpecifierNode* node);
+    /**
+     * @brief Reads the arguments of a function expression into the given
+     * @a node.
+     * @param[out] node The function expression.
+     */
+    void readArguments(ast::FunctionExpressionNode* node);
+    /**
+     * @brief Creates a node of type @a T in the given @a target and returns
+     * a reference to it, so its fields can be read in place without moving
+     * or copying the node afterwards.
+     * @param[out] target The node which receives the new node.
+     * @tparam T The type of the created node.
+     * @tparam VariantT The type of the @a target.
+     * @return Reference to the created node.
+     */
+    template <typename T, typename VariantT>
+    static T& emplace(VariantT* target)
+    {
+        target->value = T{};
+        return boost::get<T>(target->value);
+    }
+};
+}} // namespace jmespath::interpreter
+#endif // ASTDECODER_H
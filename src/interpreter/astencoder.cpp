@@ -0,0 +1,274 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "src/interpreter/astencoder.h"
+#include "src/ast/allnodes.h"
+
+namespace jmespath { namespace interpreter {
+
+AstEncoder::AstEncoder(std::vector<std::uint8_t> *output)
+    : AbstractVisitor{},
+      m_output{output}
+{
+}
+
+void AstEncoder::encode(const ast::ExpressionNode *node)
+{
+    visit(node);
+}
+
+void AstEncoder::writeVarint(std::uint64_t value,
+                             std::vector<std::uint8_t> *output)
+{
+    // write 7 bits at a time, and mark every byte except the last one with
+    // the highest bit
+    while (value >= 0x80)
+    {
+        output->push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    output->push_back(static_cast<std::uint8_t>(value));
+}
+
+void AstEncoder::writeString(const String &string,
+                             std::vector<std::uint8_t> *output)
+{
+    writeVarint(string.size(), output);
+    output->insert(output->end(), string.cbegin(), string.cend());
+}
+
+void AstEncoder::visit(const ast::AbstractNode *node)
+{
+    node->accept(this);
+}
+
+void AstEncoder::visit(const ast::ExpressionNode *node)
+{
+    if (node->isNull())
+    {
+        writeTag(NodeTag::Empty);
+        return;
+    }
+    node->accept(this);
+}
+
+void AstEncoder::visit(const ast::IdentifierNode *node)
+{
+    writeTag(NodeTag::Identifier);
+    writeString(node->identifier, m_output);
+}
+
+void AstEncoder::visit(const ast::RawStringNode *node)
+{
+    writeTag(NodeTag::RawString);
+    writeString(node->rawString, m_output);
+}
+
+void AstEncoder::visit(const ast::LiteralNode *node)
+{
+    writeTag(NodeTag::Literal);
+    writeString(node->literal, m_output);
+}
+
+void AstEncoder::visit(const ast::SubexpressionNode *node)
+{
+    writeTag(NodeTag::Subexpression);
+    writeChildren(node);
+}
+
+void AstEncoder::visit(const ast::IndexExpressionNode *node)
+{
+    writeTag(NodeTag::IndexExpression);
+    visit(&node->bracketSpecifier);
+    writeChildren(node);
+}
+
+void AstEncoder::visit(const ast::ArrayItemNode *node)
+{
+    writeTag(NodeTag::ArrayItem);
+    writeIndex(node->index);
+}
+
+void AstEncoder::visit(const ast::FlattenOperatorNode *)
+{
+    writeTag(NodeTag::FlattenOperator);
+}
+
+void AstEncoder::visit(const ast::BracketSpecifierNode *node)
+{
+    if (node->isNull())
+    {
+        writeTag(NodeTag::Empty);
+        return;
+    }
+    node->accept(this);
+}
+
+void AstEncoder::visit(const ast::SliceExpressionNode *node)
+{
+    writeTag(NodeTag::SliceExpression);
+    // the first byte marks which of the optional indices are present
+    std::uint8_t presentIndices = (node->start ? 0x01 : 0x00)
+        | (node->stop ? 0x02 : 0x00)
+        | (node->step ? 0x04 : 0x00);
+    m_output->push_back(presentIndices);
+    for (const auto* index: {&node->start, &node->stop, &node->step})
+    {
+        if (*index)
+        {
+            writeIndex(**index);
+        }
+    }
+}
+
+void AstEncoder::visit(const ast::ListWildcardNode *)
+{
+    writeTag(NodeTag::ListWildcard);
+}
+
+void AstEncoder::visit(const ast::HashWildcardNode *node)
+{
+    writeTag(NodeTag::HashWildcard);
+    writeChildren(node);
+}
+
+void AstEncoder::visit(const ast::MultiselectListNode *node)
+{
+    writeTag(NodeTag::MultiselectList);
+    writeVarint(node->expressions.size(), m_output);
+    for (const auto& expression: node->expressions)
+    {
+        visit(&expression);
+    }
+}
+
+void AstEncoder::visit(const ast::MultiselectHashNode *node)
+{
+    writeTag(NodeTag::MultiselectHash);
+    writeVarint(node->expressions.size(), m_output);
+    for (const auto& keyValuePair: node->expressions)
+    {
+        writeString(keyValuePair.first.identifier, m_output);
+        visit(&keyValuePair.second);
+    }
+}
+
+void AstEncoder::visit(const ast::NotExpressionNode *node)
+{
+    writeTag(NodeTag::NotExpression);
+    visit(&node->expression);
+}
+
+void AstEncoder::visit(const ast::ComparatorExpressionNode *node)
+{
+    writeTag(NodeTag::ComparatorExpression);
+    m_output->push_back(static_cast<std::uint8_t>(node->comparator));
+    writeChildren(node);
+}
+
+void AstEncoder::visit(const ast::OrExpressionNode *node)
+{
+    writeTag(NodeTag::OrExpression);
+    writeChildren(node);
+}
+
+void AstEncoder::visit(const ast::AndExpressionNode *node)
+{
+    writeTag(NodeTag::AndExpression);
+    writeChildren(node);
+}
+
+void AstEncoder::visit(const ast::ParenExpressionNode *node)
+{
+    writeTag(NodeTag::ParenExpression);
+    visit(&node->expression);
+}
+
+void AstEncoder::visit(const ast::PipeExpressionNode *node)
+{
+    writeTag(NodeTag::PipeExpression);
+    writeChildren(node);
+}
+
+void AstEncoder::visit(const ast::CurrentNode *)
+{
+    writeTag(NodeTag::Current);
+}
+
+void AstEncoder::visit(const ast::FilterExpressionNode *node)
+{
+    writeTag(NodeTag::FilterExpression);
+    visit(&node->expression);
+}
+
+void AstEncoder::visit(const ast::FunctionExpressionNode *node)
+{
+    writeTag(NodeTag::FunctionExpression);
+    writeString(node->functionName, m_output);
+    writeVarint(node->arguments.size(), m_output);
+    for (const auto& argument: node->arguments)
+    {
+        if (auto expression = boost::get<ast::ExpressionNode>(&argument))
+        {
+            visit(expression);
+        }
+        else if (auto expressionArgument
+                 = boost::get<ast::ExpressionArgumentNode>(&argument))
+        {
+            visit(expressionArgument);
+        }
+        else
+        {
+            writeTag(NodeTag::Empty);
+        }
+    }
+}
+
+void AstEncoder::visit(const ast::ExpressionArgumentNode *node)
+{
+    writeTag(NodeTag::ExpressionArgument);
+    visit(&node->expression);
+}
+
+void AstEncoder::writeTag(NodeTag tag)
+{
+    m_output->push_back(static_cast<std::uint8_t>(tag));
+}
+
+void AstEncoder::writeIndex(const Index &index)
+{
+    m_output->push_back(index < 0 ? 1 : 0);
+    writeVarint(boost::multiprecision::abs(index).convert_to<std::uint64_t>(),
+                m_output);
+}
+
+void AstEncoder::writeChildren(const ast::BinaryExpressionNode *node)
+{
+    visit(&node->leftExpression);
+    visit(&node->rightExpression);
+}
+}} // namespace jmespath::interpreter
@@ -0,0 +1,172 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef ASTENCODER_H
+#define ASTENCODER_H
+#include "src/interpreter/abstractvisitor.h"
+#include "jmespath/types.h"
+#include <cstdint>
+#include <vector>
+
+namespace jmespath { namespace ast {
+
+class BinaryExpressionNode;
+}} // namespace jmespath::ast
+
+namespace jmespath { namespace interpreter {
+
+/**
+ * @brief The NodeTag enum lists the tags which identify the types of the
+ * nodes in the binary encoding of an AST.
+ *
+ * The values of the tags are part of the encoding, so existing values
+ * shouldn't be changed, new node types should get new values.
+ */
+enum class NodeTag : std::uint8_t
+{
+    Empty = 0,
+    Identifier = 1,
+    RawString = 2,
+    Literal = 3,
+    Subexpression = 4,
+    IndexExpression = 5,
+    HashWildcard = 6,
+    MultiselectList = 7,
+    MultiselectHash = 8,
+    NotExpression = 9,
+    ComparatorExpression = 10,
+    OrExpression = 11,
+    AndExpression = 12,
+    ParenExpression = 13,
+    PipeExpression = 14,
+    Current = 15,
+    FunctionExpression = 16,
+    ExpressionArgument = 17,
+    ArrayItem = 18,
+    FlattenOperator = 19,
+    SliceExpression = 20,
+    ListWildcard = 21,
+    FilterExpression = 22
+};
+
+/**
+ * @brief The AstEncoder class writes an AST into a compact binary encoding,
+ * which can be turned back into the same AST with @ref AstDecoder without
+ * parsing the expression again.
+ *
+ * The nodes are written in pre-order. Every node starts with its
+ * @ref NodeTag, which is followed by the fields of the node and then by its
+ * child nodes. Strings are written as their length followed by their bytes,
+ * while lengths and array indices are written as variable length integers
+ * which take a single byte for values below 128.
+ */
+class AstEncoder : public AbstractVisitor
+{
+public:
+    /**
+     * @brief Constructs an AstEncoder object which appends the encoded nodes
+     * to the given @a output.
+     * @param[in] output The buffer where the encoded nodes are written.
+     */
+    explicit AstEncoder(std::vector<std::uint8_t>* output);
+    /**
+     * @brief Writes the AST with the given root @a node.
+     * @param[in] node The root of the AST.
+     */
+    void encode(const ast::ExpressionNode* node);
+    /**
+     * @brief Appends a variable length unsigned integer to the @a output.
+     * @param[in] value The written value.
+     * @param[in] output The buffer where the value is written.
+     */
+    static void writeVarint(std::uint64_t value,
+                            std::vector<std::uint8_t>* output);
+    /**
+     * @brief Appends the length and the bytes of the @a string to the
+     * @a output.
+     * @param[in] string The written string.
+     * @param[in] output The buffer where the string is written.
+     */
+    static void writeString(const String& string,
+                            std::vector<std::uint8_t>* output);
+
+    /**
+     * @brief Writes the given @a node.
+     * @param[in] node Pointer to the node
+     * @{
+     */
+    void visit(const ast::AbstractNode* node) override;
+    void visit(const ast::ExpressionNode* node) override;
+    void visit(const ast::IdentifierNode* node) override;
+    void visit(const ast::RawStringNode* node) override;
+    void visit(const ast::LiteralNode* node) override;
+    void visit(const ast::SubexpressionNode* node) override;
+    void visit(const ast::IndexExpressionNode* node) override;
+    void visit(const ast::ArrayItemNode* node) override;
+    void visit(const ast::FlattenOperatorNode*) override;
+    void visit(const ast::BracketSpecifierNode* node) override;
+    void visit(const ast::SliceExpressionNode* node) override;
+    void visit(const ast::ListWildcardNode*) override;
+    void visit(const ast::HashWildcardNode* node) override;
+    void visit(const ast::MultiselectListNode* node) override;
+    void visit(const ast::MultiselectHashNode* node) override;
+    void visit(const ast::NotExpressionNode* node) override;
+    void visit(const ast::ComparatorExpressionNode* node) override;
+    void visit(const ast::OrExpressionNode* node) override;
+    void visit(const ast::AndExpressionNode* node) override;
+    void visit(const ast::ParenExpressionNode* node) override;
+    void visit(const ast::PipeExpressionNode* node) override;
+    void visit(const ast::CurrentNode*) override;
+    void visit(const ast::FilterExpressionNode* node) override;
+    void visit(const ast::FunctionExpressionNode* node) override;
+    void visit(const ast::ExpressionArgumentNode* node) override;
+    /** @}*/
+
+protected:
+    /**
+     * @brief The buffer where the encoded nodes are written.
+     */
+    std::vector<std::uint8_t>* m_output;
+
+    /**
+     * @brief Writes the tag of a node.
+     * @param[in] tag The tag of the node.
+     */
+    void writeTag(NodeTag tag);
+    /**
+     * @brief Writes an array index as its sign followed by its magnitude.
+     * @param[in] index The written index.
+     */
+    void writeIndex(const Index& index);
+    /**
+     * @brief Writes the child nodes of a binary expression.
+     * @param[in] node The binary expression.
+     */
+    void writeChildren(const ast::BinaryExpressionNode* node);
+};
+}} // namespace jmespath::interpreter
+#endif // ASTENCODER_H
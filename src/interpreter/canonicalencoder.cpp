@@ -0,0 +1,168 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "src/interpreter/canonicalencoder.h"
+#include "src/interpreter/astdecoder.h"
+#include "src/ast/allnodes.h"
+#include <boost/functional/hash.hpp>
+
+namespace jmespath { namespace interpreter {
+
+CanonicalEncoder::CanonicalEncoder(std::vector<std::uint8_t> *output)
+    : AstEncoder{output}
+{
+}
+
+ast::ExpressionNode CanonicalEncoder::canonicalForm(
+    const ast::ExpressionNode &node)
+{
+    std::vector<std::uint8_t> encoding;
+    CanonicalEncoder{&encoding}.encode(&node);
+    ast::ExpressionNode canonicalRoot;
+    AstDecoder{encoding.data(), encoding.size()}.decode(&canonicalRoot);
+    return canonicalRoot;
+}
+
+std::size_t CanonicalEncoder::structuralHash(const ast::ExpressionNode &node)
+{
+    std::vector<std::uint8_t> encoding;
+    CanonicalEncoder{&encoding}.encode(&node);
+    return hash(encoding);
+}
+
+std::size_t CanonicalEncoder::hash(const std::vector<std::uint8_t> &encoding)
+{
+    return boost::hash_range(encoding.cbegin(), encoding.cend());
+}
+
+void CanonicalEncoder::visit(const ast::ExpressionNode *node)
+{
+    AstEncoder::visit(canonicalNode(node));
+}
+
+void CanonicalEncoder::visit(const ast::RawStringNode *node)
+{
+    // raw strings evaluate to the same value as string literals
+    writeTag(NodeTag::Literal);
+    writeString(Json(node->rawString).dump(), m_output);
+}
+
+void CanonicalEncoder::visit(const ast::LiteralNode *node)
+{
+    writeTag(NodeTag::Literal);
+    // literals which differ only in whitespace or in the order of the keys of
+    // objects represent the same value, invalid literals are written as they
+    // are
+    Json value = Json::parse(node->literal, nullptr, false);
+    if (value.is_discarded())
+    {
+        writeString(node->literal, m_output);
+    }
+    else
+    {
+        writeString(value.dump(), m_output);
+    }
+}
+
+void CanonicalEncoder::visit(const ast::IndexExpressionNode *node)
+{
+    writeTag(NodeTag::IndexExpression);
+    visit(&node->bracketSpecifier);
+    writeLeftExpression(&node->leftExpression);
+    visit(&node->rightExpression);
+}
+
+void CanonicalEncoder::visit(const ast::HashWildcardNode *node)
+{
+    writeTag(NodeTag::HashWildcard);
+    writeLeftExpression(&node->leftExpression);
+    visit(&node->rightExpression);
+}
+
+const ast::ExpressionNode *CanonicalEncoder::canonicalNode(
+    const ast::ExpressionNode *node)
+{
+    while (true)
+    {
+        // parentheses only affect how the expression is parsed
+        if (auto parenNode = boost::get<ast::ParenExpressionNode>(
+                &node->value))
+        {
+            node = &parenNode->expression;
+        }
+        // applying an expression on the current node is the same as the
+        // expression itself
+        else if (auto subexpressionNode = boost::get<ast::SubexpressionNode>(
+                     &node->value))
+        {
+            if (!isCurrentNode(&subexpressionNode->leftExpression))
+            {
+                return node;
+            }
+            node = &subexpressionNode->rightExpression;
+        }
+        else if (auto pipeNode = boost::get<ast::PipeExpressionNode>(
+                     &node->value))
+        {
+            if (isCurrentNode(&pipeNode->leftExpression))
+            {
+                node = &pipeNode->rightExpression;
+            }
+            else if (isCurrentNode(&pipeNode->rightExpression))
+            {
+                node = &pipeNode->leftExpression;
+            }
+            else
+            {
+                return node;
+            }
+        }
+        else
+        {
+            return node;
+        }
+    }
+}
+
+bool CanonicalEncoder::isCurrentNode(const ast::ExpressionNode *node)
+{
+    return boost::get<ast::CurrentNode>(&canonicalNode(node)->value)
+        != nullptr;
+}
+
+void CanonicalEncoder::writeLeftExpression(const ast::ExpressionNode *node)
+{
+    if (isCurrentNode(node))
+    {
+        writeTag(NodeTag::Empty);
+    }
+    else
+    {
+        visit(node);
+    }
+}
+}} // namespace jmespath::interpreter
@@ -0,0 +1,118 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef CANONICALENCODER_H
+#define CANONICALENCODER_H
+#include "src/interpreter/astencoder.h"
+#include <cstddef>
+
+namespace jmespath { namespace interpreter {
+
+/**
+ * @brief The CanonicalEncoder class writes the canonical form of an AST in
+ * the binary encoding of @ref AstEncoder.
+ *
+ * Expressions which differ only in nodes that don't affect their results
+ * have the same canonical form, like `foo.bar`, `(foo).bar` and `@.foo.bar`:
+ * - parenthesized expressions are replaced by their sub expressions
+ * - subexpressions and pipe expressions are replaced by their other side
+ * when one of their sides is the current node
+ * - current nodes on the left side of index expressions and hash wildcards
+ * are left out, since the missing left side refers to the current node too
+ * - literals are written as the serialization of their JSON values, and raw
+ * strings are written as the equivalent string literals
+ */
+class CanonicalEncoder : public AstEncoder
+{
+public:
+    /**
+     * @brief Constructs a CanonicalEncoder object which appends the
+     * canonical form of the encoded nodes to the given @a output.
+     * @param[in] output The buffer where the encoded nodes are written.
+     */
+    explicit CanonicalEncoder(std::vector<std::uint8_t>* output);
+    /**
+     * @brief Creates the canonical form of the AST with the given root
+     * @a node.
+     * @param[in] node The root of the AST.
+     * @return The root of the canonical AST.
+     */
+    static ast::ExpressionNode canonicalForm(const ast::ExpressionNode& node);
+    /**
+     * @brief Calculates the hash of the canonical form of the AST with the
+     * given root @a node, which is the same for equivalent ASTs.
+     * @param[in] node The root of the AST.
+     * @return The hash value.
+     */
+    static std::size_t structuralHash(const ast::ExpressionNode& node);
+    /**
+     * @brief Calculates the hash of a canonical form written by a
+     * CanonicalEncoder.
+     * @param[in] encoding The canonical form.
+     * @return The hash value.
+     */
+    static std::size_t hash(const std::vector<std::uint8_t>& encoding);
+
+    using AstEncoder::visit;
+    /**
+     * @{
+     * @brief Writes the canonical form of the given @a node.
+     * @param[in] node The node which should be written.
+     */
+    void visit(const ast::ExpressionNode* node) override;
+    void visit(const ast::RawStringNode* node) override;
+    void visit(const ast::LiteralNode* node) override;
+    void visit(const ast::IndexExpressionNode* node) override;
+    void visit(const ast::HashWildcardNode* node) override;
+    /** @}*/
+
+private:
+    /**
+     * @brief Returns the node which the given @a node is equivalent to, after
+     * leaving out the parentheses and the current nodes around it.
+     * @param[in] node The node of the AST.
+     * @return The equivalent node.
+     */
+    static const ast::ExpressionNode* canonicalNode(
+        const ast::ExpressionNode* node);
+    /**
+     * @brief Checks whether the given @a node is equivalent to the current
+     * node.
+     * @param[in] node The node of the AST.
+     * @return Returns true if the @a node refers to the current node,
+     * otherwise false.
+     */
+    static bool isCurrentNode(const ast::ExpressionNode* node);
+    /**
+     * @brief Writes the left side of an index expression or a hash wildcard,
+     * which is left out if it refers to the current node.
+     * @param[in] node The left side of the node.
+     */
+    void writeLeftExpression(const ast::ExpressionNode* node);
+};
+}} // namespace jmespath::interpreter
+#endif // CANONICALENCODER_H
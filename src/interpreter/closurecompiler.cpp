@@ -0,0 +1,737 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "src/interpreter/closurecompiler.h"
+#include "src/ast/allnodes.h"
+#include "jmespath/exceptions.h"
+
+namespace jmespath { namespace interpreter {
+
+namespace {
+/**
+ * @brief Extracts the value of the @a expression if it's a constant string.
+ * @param[in] expression An expression.
+ * @param[out] value The value of the string.
+ * @return Returns true if the @a expression is a raw string or a string
+ * literal, otherwise returns false.
+ */
+bool makeConstantString(const ast::ExpressionNode* expression, String* value)
+{
+    if (auto node = boost::get<ast::RawStringNode>(&expression->value))
+    {
+        *value = node->rawString;
+        return true;
+    }
+    if (auto node = boost::get<ast::LiteralNode>(&expression->value))
+    {
+        // invalid literals are reported when they're evaluated
+        Json literal = Json::parse(node->literal, nullptr, false);
+        if (literal.is_string())
+        {
+            *value = literal.get<String>();
+            return true;
+        }
+        return false;
+    }
+    if (auto node = boost::get<ast::ParenExpressionNode>(&expression->value))
+    {
+        return makeConstantString(&node->expression, value);
+    }
+    return false;
+}
+
+/**
+ * @brief Evaluates to the @a context.
+ * @param[in] context The context of the evaluation.
+ * @return A reference to the @a context.
+ */
+ContextValue identity(const Json& context, Interpreter*)
+{
+    return assignContextValue(context);
+}
+} // anonymous namespace
+
+Closure ClosureCompiler::compile(const ast::ExpressionNode *expression)
+{
+    visit(expression);
+    return std::move(m_closure);
+}
+
+void ClosureCompiler::visit(const ast::AbstractNode *node)
+{
+    node->accept(this);
+}
+
+void ClosureCompiler::visit(const ast::ExpressionNode *node)
+{
+    // empty expressions evaluate to their context
+    if (node->isNull())
+    {
+        m_closure = identity;
+        return;
+    }
+    node->accept(this);
+}
+
+void ClosureCompiler::visit(const ast::IdentifierNode *node)
+{
+    m_closure = [identifier = node->identifier](const Json& context,
+                                                Interpreter*) -> ContextValue {
+        // evaluete the identifier if the context holds an object
+        if (context.is_object())
+        {
+            auto it = context.find(identifier);
+            if (it != context.end())
+            {
+                return assignContextValue(*it);
+            }
+        }
+        // otherwise evaluate to null
+        return {};
+    };
+}
+
+void ClosureCompiler::visit(const ast::RawStringNode *node)
+{
+    m_closure = [value = Json(node->rawString)](const Json&,
+                                                Interpreter*) -> ContextValue {
+        return assignContextValue(value);
+    };
+}
+
+void ClosureCompiler::visit(const ast::LiteralNode *node)
+{
+    // parse the literal in advance if it's valid, otherwise report the error
+    // when it's evaluated
+    Json value;
+    try
+    {
+        value = Json::parse(node->literal);
+    }
+    catch (const nlohmann::json::exception&)
+    {
+        m_closure = interpret(node);
+        return;
+    }
+    m_closure = [value = std::move(value)](const Json&,
+                                           Interpreter*) -> ContextValue {
+        return assignContextValue(value);
+    };
+}
+
+void ClosureCompiler::visit(const ast::SubexpressionNode *node)
+{
+    // evaluate the right expression on the result of the left expression
+    m_closure = [left = compile(&node->leftExpression),
+                 right = compile(&node->rightExpression)](
+            const Json& context, Interpreter* interpreter) {
+        return applyClosure(left(context, interpreter),
+                            [&](const Json& leftResult) {
+            return right(leftResult, interpreter);
+        });
+    };
+}
+
+void ClosureCompiler::visit(const ast::IndexExpressionNode *node)
+{
+    Closure left = compile(&node->leftExpression);
+    const auto& bracket = node->bracketSpecifier.value;
+    // evaluate array item expressions
+    if (auto arrayItem = boost::get<ast::ArrayItemNode>(&bracket))
+    {
+        m_closure = [left, index = arrayItem->index](
+                const Json& context, Interpreter* interpreter) {
+            return applyClosure(left(context, interpreter),
+                                [&](const Json& array) -> ContextValue {
+                // evaluate the array item expression if the context holds
+                // an array and the index is not out of range
+                if (array.is_array())
+                {
+                    auto arrayIndex = index;
+                    if (arrayIndex < 0)
+                    {
+                        arrayIndex += array.size();
+                    }
+                    if ((arrayIndex >= 0) && (arrayIndex < array.size()))
+                    {
+                        return assignContextValue(
+                            array[static_cast<size_t>(arrayIndex)]);
+                    }
+                }
+                // otherwise evaluate to null
+                return {};
+            });
+        };
+        return;
+    }
+
+    // items of projections are passed without changes if the projection
+    // doesn't have a right side expression
+    Closure right;
+    if (!node->rightExpression.isNull())
+    {
+        right = compile(&node->rightExpression);
+    }
+    // select every item of list wildcard projections
+    if (boost::get<ast::ListWildcardNode>(&bracket))
+    {
+        m_closure = makeProjection(std::move(left),
+                                   [](const Json& array,
+                                      Interpreter*,
+                                      const auto& project) {
+            if (!array.is_array())
+            {
+                return false;
+            }
+            for (const auto& item: array)
+            {
+                project(item);
+            }
+            return true;
+        }, std::move(right));
+    }
+    // select the items of the sub arrays in flatten projections
+    else if (boost::get<ast::FlattenOperatorNode>(&bracket))
+    {
+        m_closure = makeProjection(std::move(left),
+                                   [](const Json& array,
+                                      Interpreter*,
+                                      const auto& project) {
+            if (!array.is_array())
+            {
+                return false;
+            }
+            for (const auto& item: array)
+            {
+                if (item.is_array())
+                {
+                    for (const auto& subItem: item)
+                    {
+                        project(subItem);
+                    }
+                }
+                else
+                {
+                    project(item);
+                }
+            }
+            return true;
+        }, std::move(right));
+    }
+    // select the items of slice projections
+    else if (auto slice = boost::get<ast::SliceExpressionNode>(&bracket))
+    {
+        m_closure = makeProjection(std::move(left),
+                                   [slice](const Json& array,
+                                           Interpreter* interpreter,
+                                           const auto& project) {
+            if (!array.is_array())
+            {
+                return false;
+            }
+            Index startIndex = 0;
+            Index stopIndex = 0;
+            Index step = 1;
+            interpreter->sliceBounds(slice, array.size(),
+                                     &startIndex, &stopIndex, &step);
+            for (auto i = startIndex;
+                 step > 0 ? (i < stopIndex) : (i > stopIndex);
+                 i += step)
+            {
+                project(array[static_cast<size_t>(i)]);
+            }
+            return true;
+        }, std::move(right));
+    }
+    // select the items which satisfy the condition of filter projections
+    else if (auto filter = boost::get<ast::FilterExpressionNode>(&bracket))
+    {
+        m_closure = makeProjection(std::move(left),
+                                   [condition = compile(&filter->expression)](
+                                       const Json& array,
+                                       Interpreter* interpreter,
+                                       const auto& project) {
+            if (!array.is_array())
+            {
+                return false;
+            }
+            for (const auto& item: array)
+            {
+                if (interpreter->toBoolean(
+                        getJsonValue(condition(item, interpreter))))
+                {
+                    project(item);
+                }
+            }
+            return true;
+        }, std::move(right));
+    }
+    else
+    {
+        m_closure = interpret(node);
+    }
+}
+
+void ClosureCompiler::visit(const ast::ArrayItemNode *)
+{
+    // compiled by visit(const ast::IndexExpressionNode*)
+}
+
+void ClosureCompiler::visit(const ast::FlattenOperatorNode *)
+{
+    // compiled by visit(const ast::IndexExpressionNode*)
+}
+
+void ClosureCompiler::visit(const ast::BracketSpecifierNode *)
+{
+    // compiled by visit(const ast::IndexExpressionNode*)
+}
+
+void ClosureCompiler::visit(const ast::SliceExpressionNode *)
+{
+    // compiled by visit(const ast::IndexExpressionNode*)
+}
+
+void ClosureCompiler::visit(const ast::ListWildcardNode *)
+{
+    // compiled by visit(const ast::IndexExpressionNode*)
+}
+
+void ClosureCompiler::visit(const ast::HashWildcardNode *node)
+{
+    Closure left = compile(&node->leftExpression);
+    Closure right;
+    if (!node->rightExpression.isNull())
+    {
+        right = compile(&node->rightExpression);
+    }
+    // project the values of objects
+    m_closure = makeProjection(std::move(left),
+                               [](const Json& object,
+                                  Interpreter*,
+                                  const auto& project) {
+        if (!object.is_object())
+        {
+            return false;
+        }
+        for (const auto& value: object)
+        {
+            project(value);
+        }
+        return true;
+    }, std::move(right));
+}
+
+void ClosureCompiler::visit(const ast::MultiselectListNode *node)
+{
+    std::vector<Closure> expressions;
+    expressions.reserve(node->expressions.size());
+    for (const auto& expression: node->expressions)
+    {
+        expressions.push_back(compile(&expression));
+    }
+    m_closure = [expressions = std::move(expressions)](
+            const Json& context, Interpreter* interpreter) -> ContextValue {
+        // evaluate to null if the context is null
+        if (context.is_null())
+        {
+            return {};
+        }
+        // otherwise collect the results of the subexpressions
+        Json result(Json::value_t::array);
+        auto& resultItems = result.get_ref<Json::array_t&>();
+        resultItems.reserve(expressions.size());
+        for (const auto& expression: expressions)
+        {
+            resultItems.push_back(
+                takeJsonValue(expression(context, interpreter)));
+        }
+        return result;
+    };
+}
+
+void ClosureCompiler::visit(const ast::MultiselectHashNode *node)
+{
+    std::vector<std::pair<String, Closure>> expressions;
+    expressions.reserve(node->expressions.size());
+    for (const auto& keyValuePair: node->expressions)
+    {
+        expressions.emplace_back(keyValuePair.first.identifier,
+                                 compile(&keyValuePair.second));
+    }
+    m_closure = [expressions = std::move(expressions)](
+            const Json& context, Interpreter* interpreter) -> ContextValue {
+        // evaluate to null if the context is null
+        if (context.is_null())
+        {
+            return {};
+        }
+        // otherwise collect the results of the subexpressions
+        Json result(Json::value_t::object);
+        auto& resultItems = result.get_ref<Json::object_t&>();
+        for (const auto& keyValuePair: expressions)
+        {
+            assignObjectItem(resultItems, keyValuePair.first,
+                             takeJsonValue(keyValuePair.second(context,
+                                                               interpreter)));
+        }
+        return result;
+    };
+}
+
+void ClosureCompiler::visit(const ast::NotExpressionNode *node)
+{
+    m_closure = [expression = compile(&node->expression)](
+            const Json& context, Interpreter* interpreter) -> ContextValue {
+        return Json(!interpreter->toBoolean(
+                        getJsonValue(expression(context, interpreter))));
+    };
+}
+
+void ClosureCompiler::visit(const ast::ComparatorExpressionNode *node)
+{
+    using Comparator = ast::ComparatorExpressionNode::Comparator;
+
+    Closure left = compile(&node->leftExpression);
+    Closure right = compile(&node->rightExpression);
+    switch (node->comparator)
+    {
+    case Comparator::Equal:
+        m_closure = makeEqualityComparator<true>(std::move(left),
+                                                 std::move(right));
+        break;
+    case Comparator::NotEqual:
+        m_closure = makeEqualityComparator<false>(std::move(left),
+                                                  std::move(right));
+        break;
+    case Comparator::Less:
+        m_closure = makeOrderingComparator<std::less<Json>>(
+            std::move(left), std::move(right));
+        break;
+    case Comparator::LessOrEqual:
+        m_closure = makeOrderingComparator<std::less_equal<Json>>(
+            std::move(left), std::move(right));
+        break;
+    case Comparator::GreaterOrEqual:
+        m_closure = makeOrderingComparator<std::greater_equal<Json>>(
+            std::move(left), std::move(right));
+        break;
+    case Comparator::Greater:
+        m_closure = makeOrderingComparator<std::greater<Json>>(
+            std::move(left), std::move(right));
+        break;
+    default:
+        // report unhandled operators when the expression is evaluated
+        m_closure = interpret(node);
+    }
+}
+
+void ClosureCompiler::visit(const ast::OrExpressionNode *node)
+{
+    m_closure = makeLogicOperator(node, true);
+}
+
+void ClosureCompiler::visit(const ast::AndExpressionNode *node)
+{
+    m_closure = makeLogicOperator(node, false);
+}
+
+void ClosureCompiler::visit(const ast::ParenExpressionNode *node)
+{
+    visit(&node->expression);
+}
+
+void ClosureCompiler::visit(const ast::PipeExpressionNode *node)
+{
+    // if the right expression only depends on the first few items of the
+    // array produced by the left expression, then the interpreter can stop
+    // the evaluation of the left expression early
+    if (Interpreter::resultLimit(&node->rightExpression)
+        && Interpreter::isStreamable(&node->leftExpression))
+    {
+        m_closure = interpret(node);
+        return;
+    }
+    // evaluate the right expression on the result of the left expression
+    m_closure = [left = compile(&node->leftExpression),
+                 right = compile(&node->rightExpression)](
+            const Json& context, Interpreter* interpreter) {
+        return applyClosure(left(context, interpreter),
+                            [&](const Json& leftResult) {
+            return right(leftResult, interpreter);
+        });
+    };
+}
+
+void ClosureCompiler::visit(const ast::CurrentNode *)
+{
+    m_closure = identity;
+}
+
+void ClosureCompiler::visit(const ast::FilterExpressionNode *)
+{
+    // compiled by visit(const ast::IndexExpressionNode*)
+}
+
+void ClosureCompiler::visit(const ast::FunctionExpressionNode *node)
+{
+    // compile the JSON expression arguments, while expression type arguments
+    // are passed to the function as they are
+    std::vector<Closure> arguments;
+    arguments.reserve(node->arguments.size());
+    for (const auto& argument: node->arguments)
+    {
+        if (auto expression = boost::get<ast::ExpressionNode>(&argument))
+        {
+            arguments.push_back(compile(expression));
+        }
+        else
+        {
+            arguments.emplace_back();
+        }
+    }
+    // prepare the search for the constant second argument of the string
+    // matching functions, expression type subjects are rejected by
+    // evaluateFunction
+    String needle;
+    if (node->arguments.size() == 2
+        && arguments[0]
+        && arguments[1]
+        && makeConstantString(&boost::get<ast::ExpressionNode>(
+                                  node->arguments[1]), &needle))
+    {
+        if (node->functionName == "contains")
+        {
+            m_closure = makeStringMatcher(node, std::move(arguments[0]),
+                                          SubstringSearcher{needle},
+                                          &SubstringSearcher::isFoundIn);
+            return;
+        }
+        if (node->functionName == "starts_with")
+        {
+            m_closure = makeStringMatcher(node, std::move(arguments[0]),
+                                          SubstringSearcher{needle},
+                                          &SubstringSearcher::isPrefixOf);
+            return;
+        }
+        if (node->functionName == "ends_with")
+        {
+            m_closure = makeStringMatcher(node, std::move(arguments[0]),
+                                          SubstringSearcher{needle},
+                                          &SubstringSearcher::isSuffixOf);
+            return;
+        }
+    }
+    // resolve native functions when the expression is compiled, they can't
+    // have the same name as a built in function
+    const auto& registry = FunctionRegistry::instance();
+    auto generation = registry.generation();
+    if (auto nativeFunction = registry.find(node->functionName))
+    {
+        m_closure = [node,
+                     generation,
+                     nativeFunction,
+                     arguments = std::move(arguments)](
+                const Json& context, Interpreter* interpreter) -> ContextValue {
+            auto evaluateArgument = [&](size_t index) {
+                return arguments[index](context, interpreter);
+            };
+            // if a function has been registered since the expression was
+            // compiled, resolve the function again like the interpreter does
+            if (FunctionRegistry::instance().generation() == generation)
+            {
+                interpreter->callNativeFunction(*nativeFunction, node,
+                                                evaluateArgument);
+            }
+            else
+            {
+                interpreter->evaluateFunction(node, evaluateArgument);
+            }
+            return std::move(interpreter->m_context);
+        };
+        return;
+    }
+    m_closure = [node, arguments = std::move(arguments)](
+            const Json& context, Interpreter* interpreter) -> ContextValue {
+        // evaluate the function with the compiled arguments and take its
+        // result from the interpreter
+        interpreter->evaluateFunction(node, [&](size_t index) {
+            return arguments[index](context, interpreter);
+        });
+        return std::move(interpreter->m_context);
+    };
+}
+
+void ClosureCompiler::visit(const ast::ExpressionArgumentNode *)
+{
+    // compiled by visit(const ast::FunctionExpressionNode*)
+}
+
+template <typename NodeT>
+Closure ClosureCompiler::interpret(const NodeT *node) const
+{
+    return [node](const Json& context, Interpreter* interpreter) {
+        interpreter->setContext(context);
+        interpreter->visit(node);
+        return std::move(interpreter->currentContextValue());
+    };
+}
+
+template <typename SelectorT>
+Closure ClosureCompiler::makeProjection(Closure left,
+                                        SelectorT selector,
+                                        Closure right) const
+{
+    return [left = std::move(left),
+            selector = std::move(selector),
+            right = std::move(right)](
+            const Json& context, Interpreter* interpreter) {
+        return applyClosure(left(context, interpreter),
+                            [&](const Json& source) -> ContextValue {
+            Json result(Json::value_t::array);
+            auto& resultItems = result.get_ref<Json::array_t&>();
+            bool isProjected = selector(source, interpreter,
+                                        [&](const Json& item) {
+                if (!right)
+                {
+                    if (!item.is_null())
+                    {
+                        resultItems.push_back(item);
+                    }
+                    return;
+                }
+                // evaluate the right side expression on the item and append
+                // the result if it's not null
+                ContextValue itemResult = right(item, interpreter);
+                if (auto itemValue = getOwnedJsonValue(itemResult))
+                {
+                    if (!itemValue->is_null())
+                    {
+                        resultItems.push_back(std::move(*itemValue));
+                    }
+                }
+                else if (!getJsonValue(itemResult).is_null())
+                {
+                    resultItems.push_back(getJsonValue(itemResult));
+                }
+            });
+            // evaluate to null if the selector couldn't be applied
+            if (!isProjected)
+            {
+                return {};
+            }
+            return result;
+        });
+    };
+}
+
+Closure ClosureCompiler::makeStringMatcher(
+    const ast::FunctionExpressionNode *node,
+    Closure subject,
+    SubstringSearcher searcher,
+    bool (SubstringSearcher::*match)(const String&) const) const
+{
+    Json needle = searcher.needle();
+    return [node, subject = std::move(subject),
+            searcher = std::move(searcher),
+            needle = std::move(needle), match](
+            const Json& context, Interpreter* interpreter) -> ContextValue {
+        ContextValue subjectResult = subject(context, interpreter);
+        const Json& subjectValue = getJsonValue(subjectResult);
+        if (subjectValue.is_string())
+        {
+            return Json((searcher.*match)(
+                subjectValue.get_ref<const String&>()));
+        }
+        // let the function handle the other types of subjects, like arrays
+        // for contains or the reporting of invalid arguments
+        interpreter->evaluateFunction(node, [&](size_t index) -> ContextValue {
+            if (index == 0)
+            {
+                return std::move(subjectResult);
+            }
+            return assignContextValue(needle);
+        });
+        return std::move(interpreter->m_context);
+    };
+}
+
+Closure ClosureCompiler::makeLogicOperator(
+    const ast::BinaryExpressionNode *node,
+    bool shortCircuitValue)
+{
+    return [left = compile(&node->leftExpression),
+            right = compile(&node->rightExpression),
+            shortCircuitValue](const Json& context, Interpreter* interpreter) {
+        // evaluate the left expression and return its result if it's enough
+        // for producing the final result
+        ContextValue leftResult = left(context, interpreter);
+        if (interpreter->toBoolean(getJsonValue(leftResult))
+            == shortCircuitValue)
+        {
+            return leftResult;
+        }
+        // otherwise evaluate the right side expression
+        return right(context, interpreter);
+    };
+}
+
+template <bool isEqual>
+Closure ClosureCompiler::makeEqualityComparator(Closure left,
+                                                Closure right) const
+{
+    return [left = std::move(left), right = std::move(right)](
+            const Json& context, Interpreter* interpreter) -> ContextValue {
+        // the context remains valid while both sides are evaluated, so the
+        // results don't need to be copied
+        ContextValue leftResult = left(context, interpreter);
+        ContextValue rightResult = right(context, interpreter);
+        return Json((getJsonValue(leftResult) == getJsonValue(rightResult))
+                    == isEqual);
+    };
+}
+
+template <typename ComparatorT>
+Closure ClosureCompiler::makeOrderingComparator(Closure left,
+                                                Closure right) const
+{
+    return [left = std::move(left), right = std::move(right)](
+            const Json& context, Interpreter* interpreter) -> ContextValue {
+        ContextValue leftResult = left(context, interpreter);
+        ContextValue rightResult = right(context, interpreter);
+        const Json& leftValue = getJsonValue(leftResult);
+        const Json& rightValue = getJsonValue(rightResult);
+        // if a non number is involved in an ordering comparison the result
+        // should be null
+        if (!leftValue.is_number() || !rightValue.is_number())
+        {
+            return {};
+        }
+        return Json(ComparatorT{}(leftValue, rightValue));
+    };
+}
+}} // namespace jmespath::interpreter
@@ -0,0 +1,200 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef CLOSURECOMPILER_H
+#define CLOSURECOMPILER_H
+#include "src/interpreter/abstractvisitor.h"
+#include "src/interpreter/interpreter.h"
+#include "src/interpreter/substringsearcher.h"
+#include "jmespath/types.h"
+#include <functional>
+
+namespace jmespath { namespace interpreter {
+
+/**
+ * @brief Function which evaluates a compiled expression on the given context.
+ *
+ * The result either holds a value or a reference to the context, to a
+ * descendant of the context or to a value owned by the closure. The
+ * interpreter is used for evaluating built in functions.
+ */
+using Closure = std::function<ContextValue(const Json&, Interpreter*)>;
+
+/**
+ * @brief The ClosureCompiler class compiles the AST into a tree of closures.
+ *
+ * Every node is turned into a closure which is specialized on the type of
+ * the node and which holds its operands already prepared for evaluation, like
+ * the names of identifiers, the parsed values of literals and the closures of
+ * the child expressions. Evaluating the closures avoids the visitation of the
+ * nodes and of the context values, since the context of a closure is always a
+ * constant reference.
+ * @note The closures refer to the nodes of the compiled AST, so the AST must
+ * outlive them.
+ */
+class ClosureCompiler : public AbstractVisitor
+{
+public:
+    /**
+     * @brief Compiles the given @a expression into a closure.
+     * @param[in] expression The root of the AST.
+     * @return The closure which evaluates the @a expression.
+     */
+    Closure compile(const ast::ExpressionNode* expression);
+
+    /**
+     * @brief Compile the given @a node into a closure.
+     * @param[in] node Pointer to the node
+     * @{
+     */
+    void visit(const ast::AbstractNode *node) override;
+    void visit(const ast::ExpressionNode *node) override;
+    void visit(const ast::IdentifierNode *node) override;
+    void visit(const ast::RawStringNode *node) override;
+    void visit(const ast::LiteralNode* node) override;
+    void visit(const ast::SubexpressionNode* node) override;
+    void visit(const ast::IndexExpressionNode* node) override;
+    void visit(const ast::ArrayItemNode*) override;
+    void visit(const ast::FlattenOperatorNode*) override;
+    void visit(const ast::BracketSpecifierNode*) override;
+    void visit(const ast::SliceExpressionNode*) override;
+    void visit(const ast::ListWildcardNode*) override;
+    void visit(const ast::HashWildcardNode* node) override;
+    void visit(const ast::MultiselectListNode* node) override;
+    void visit(const ast::MultiselectHashNode* node) override;
+    void visit(const ast::NotExpressionNode* node) override;
+    void visit(const ast::ComparatorExpressionNode* node) override;
+    void visit(const ast::OrExpressionNode* node) override;
+    void visit(const ast::AndExpressionNode* node) override;
+    void visit(const ast::ParenExpressionNode* node) override;
+    void visit(const ast::PipeExpressionNode* node) override;
+    void visit(const ast::CurrentNode*) override;
+    void visit(const ast::FilterExpressionNode*) override;
+    void visit(const ast::FunctionExpressionNode* node) override;
+    void visit(const ast::ExpressionArgumentNode*) override;
+    /** @}*/
+
+private:
+    /**
+     * @brief The closure of the last compiled node.
+     */
+    Closure m_closure;
+
+    /**
+     * @brief Creates a closure which evaluates the @a node with the
+     * interpreter.
+     * @param[in] node The node which should be interpreted.
+     * @tparam NodeT The type of the @a node.
+     * @return The closure which interprets the @a node.
+     */
+    template <typename NodeT>
+    Closure interpret(const NodeT* node) const;
+    /**
+     * @brief Creates a closure which evaluates the projection of the
+     * @a right expression on the items selected by the @a selector from the
+     * result of the @a left expression.
+     * @param[in] left The closure of the left expression.
+     * @param[in] selector A function object which receives the result of the
+     * left expression, the interpreter and a callback. It should invoke the
+     * callback with every item that should be projected, and return false if
+     * the result of the left expression can't be projected.
+     * @param[in] right The closure of the projected expression or an empty
+     * closure if the items should be projected without changes.
+     * @tparam SelectorT The type of the @a selector.
+     * @return The closure of the projection.
+     */
+    template <typename SelectorT>
+    Closure makeProjection(Closure left, SelectorT selector,
+                           Closure right) const;
+    /**
+     * @brief Creates a closure which evaluates the string matching function
+     * @a node, whose second argument is a constant string.
+     * @param[in] node The node of the function.
+     * @param[in] subject The closure of the first argument.
+     * @param[in] searcher The searcher of the constant second argument.
+     * @param[in] match The member function of the @a searcher which matches
+     * the string subjects.
+     * @return The closure of the function.
+     */
+    Closure makeStringMatcher(
+        const ast::FunctionExpressionNode* node,
+        Closure subject,
+        SubstringSearcher searcher,
+        bool (SubstringSearcher::*match)(const String&) const) const;
+    /**
+     * @brief Creates a closure which evaluates the logic operator @a node.
+     * @param[in] node The node of the logic operator.
+     * @param[in] shortCircuitValue The boolean value of the left side result
+     * for which the right side expression isn't evaluated.
+     * @return The closure of the logic operator.
+     */
+    Closure makeLogicOperator(const ast::BinaryExpressionNode* node,
+                              bool shortCircuitValue);
+    /**
+     * @brief Creates a closure which checks whether the results of the
+     * @a left and @a right closures are equal.
+     * @param[in] left The closure of the left expression.
+     * @param[in] right The closure of the right expression.
+     * @tparam isEqual The result of the comparison for equal values.
+     * @return The closure of the comparator expression.
+     */
+    template <bool isEqual>
+    Closure makeEqualityComparator(Closure left, Closure right) const;
+    /**
+     * @brief Creates a closure which compares the order of the results of
+     * the @a left and @a right closures.
+     * @param[in] left The closure of the left expression.
+     * @param[in] right The closure of the right expression.
+     * @tparam ComparatorT The function object type used for comparing the
+     * results.
+     * @return The closure of the comparator expression.
+     */
+    template <typename ComparatorT>
+    Closure makeOrderingComparator(Closure left, Closure right) const;
+};
+
+/**
+ * @brief Evaluates the @a closure on the given @a contextValue.
+ *
+ * If the @a contextValue holds a value, then the references in the result
+ * are replaced with shared references, since they might refer to the
+ * @a contextValue.
+ * @param[in] contextValue The context of the evaluation.
+ * @param[in] closure A function object which accepts a constant reference to
+ * a @ref Json value and returns a @ref ContextValue.
+ * @tparam ClosureT The type of the @a closure.
+ * @return The result of the evaluation.
+ */
+template <typename ClosureT>
+inline ContextValue applyClosure(ContextValue&& contextValue,
+                                 ClosureT&& closure)
+{
+    ContextValue result = closure(getJsonValue(contextValue));
+    return detachResult(std::move(contextValue), std::move(result));
+}
+}} // namespace jmespath::interpreter
+#endif // CLOSURECOMPILER_H
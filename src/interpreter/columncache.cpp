@@ -0,0 +1,111 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "src/interpreter/columncache.h"
+#include <boost/algorithm/cxx11/all_of.hpp>
+
+namespace jmespath { namespace interpreter {
+
+namespace alg = boost::algorithm;
+
+constexpr size_t ColumnCache::minimumColumnLength;
+
+ColumnCache::ColumnCache(const Json &document)
+{
+    collectColumnarArrays(document);
+}
+
+bool ColumnCache::isColumnarArray(const Json &array) const
+{
+    return m_columnarArrays.find(&array) != m_columnarArrays.cend();
+}
+
+const ColumnCache::Column* ColumnCache::column(const Json &array,
+                                               const String &field)
+{
+    // only create columns for arrays of objects
+    if (!isColumnarArray(array))
+    {
+        return nullptr;
+    }
+    // columns are created while the lock is held, so concurrent requests
+    // for the same column wait for it instead of creating it again
+    std::lock_guard<std::mutex> lock{m_mutex};
+    // return the column if it already exists
+    auto key = std::make_pair(&array, field);
+    auto it = m_columns.find(key);
+    if (it != m_columns.end())
+    {
+        return &it->second;
+    }
+    // otherwise create the column by looking up the field in each object
+    Column column;
+    column.reserve(array.size());
+    for (const Json& item: array)
+    {
+        auto fieldIt = item.find(field);
+        column.push_back(fieldIt != item.cend() ? &*fieldIt : nullptr);
+    }
+    return &m_columns.emplace(std::move(key), std::move(column)).first->second;
+}
+
+size_t ColumnCache::size() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_columns.size();
+}
+
+void ColumnCache::clear()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_columns.clear();
+}
+
+void ColumnCache::collectColumnarArrays(const Json &value)
+{
+    if (value.is_array())
+    {
+        // store the address of long enough arrays of objects
+        if ((value.size() >= minimumColumnLength)
+            && alg::all_of(value, [](const Json& item) {
+                return item.is_object();
+            }))
+        {
+            m_columnarArrays.insert(&value);
+        }
+    }
+    else if (!value.is_object())
+    {
+        return;
+    }
+    // search for arrays in the items of arrays and objects
+    for (const Json& item: value)
+    {
+        collectColumnarArrays(item);
+    }
+}
+}} // namespace jmespath::interpreter
@@ -0,0 +1,125 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef COLUMNCACHE_H
+#define COLUMNCACHE_H
+#include "jmespath/types.h"
+#include <map>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace jmespath { namespace interpreter {
+
+/**
+ * @brief The ColumnCache class stores the columnar representation of arrays
+ * of objects.
+ *
+ * The values of a field of the objects in an array are stored in a column,
+ * which is a vector containing pointers to the field's value in each object
+ * in the same order as the objects are stored in the array, or `nullptr` if
+ * an object has no such field. The columns are created lazily on the first
+ * request. The arrays of objects which can be stored in columns are
+ * collected when the cache is constructed, and the columns are keyed by the
+ * address of the array, so the document must not be modified or destroyed
+ * while the cache is in use.
+ * @note The columns can be requested concurrently from multiple threads,
+ * the cache creates a column only once and never modifies it afterwards.
+ */
+class ColumnCache
+{
+public:
+    /**
+     * @brief The type of a column, which holds pointers to the values of a
+     * field.
+     */
+    using Column = std::vector<const Json*>;
+    /**
+     * @brief The minimum length of arrays which are stored in columns,
+     * shorter arrays can be searched more efficiently directly.
+     */
+    static constexpr size_t minimumColumnLength = 32;
+
+    /**
+     * @brief Constructs a ColumnCache object for the given @a document.
+     * @param[in] document The @ref Json document whose arrays of objects
+     * should be stored in columns.
+     */
+    explicit ColumnCache(const Json& document);
+    /**
+     * @brief Checks whether @a array is an array of the document which can be
+     * stored in columns.
+     * @param[in] array A @ref Json value.
+     * @return Returns true if @a array is an array of objects in the document
+     * which is long enough, otherwise returns false.
+     */
+    bool isColumnarArray(const Json& array) const;
+    /**
+     * @brief Returns the column of the values of the @a field in the objects
+     * of the @a array.
+     * @param[in] array A @ref Json array.
+     * @param[in] field The name of a field.
+     * @return Pointer to the column or `nullptr` if the @a array can't be
+     * stored in columns.
+     */
+    const Column* column(const Json& array, const String& field);
+    /**
+     * @brief Returns the number of columns stored in the cache.
+     * @return The number of columns.
+     */
+    size_t size() const;
+    /**
+     * @brief Removes all columns from the cache, which invalidates the
+     * columns returned so far, so it shouldn't be called while the cache is
+     * in use.
+     */
+    void clear();
+
+private:
+    /**
+     * @brief The addresses of the arrays of the document which can be stored
+     * in columns.
+     */
+    std::unordered_set<const Json*> m_columnarArrays;
+    /**
+     * @brief Stores the columns by the address of the array and by the name
+     * of the field.
+     */
+    std::map<std::pair<const Json*, String>, Column> m_columns;
+    /**
+     * @brief Serializes the access to @ref m_columns.
+     */
+    mutable std::mutex m_mutex;
+    /**
+     * @brief Collects the arrays of objects from the @a value and its
+     * descendants which can be stored in columns.
+     * @param[in] value A @ref Json value.
+     */
+    void collectColumnarArrays(const Json& value);
+};
+}} // namespace jmespath::interpreter
+#endif // COLUMNCACHE_H
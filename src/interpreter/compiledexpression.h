@@ -0,0 +1,66 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef COMPILEDEXPRESSION_H
+#define COMPILEDEXPRESSION_H
+#include "src/interpreter/closurecompiler.h"
+
+namespace jmespath { namespace interpreter {
+
+/**
+ * @brief The CompiledExpression class stores the closure compiled from the
+ * AST of an expression.
+ * @note The AST must outlive the compiled expression.
+ */
+class CompiledExpression
+{
+public:
+    /**
+     * @brief Constructs a CompiledExpression object by compiling the
+     * @a expression.
+     * @param[in] expression The root of the AST.
+     */
+    explicit CompiledExpression(const ast::ExpressionNode& expression);
+    /**
+     * @brief Evaluates the expression on the @a document.
+     * @param[in] document The input JSON document.
+     * @param[in] interpreter The interpreter used for evaluating built in
+     * functions and the nodes which aren't compiled.
+     * @return The result of the evaluation, which might refer to the
+     * @a document or to values owned by the compiled expression.
+     */
+    ContextValue evaluate(const Json& document,
+                          Interpreter* interpreter) const;
+
+private:
+    /**
+     * @brief The closure of the root of the AST.
+     */
+    Closure m_closure;
+};
+}} // namespace jmespath::interpreter
+#endif // COMPILEDEXPRESSION_H
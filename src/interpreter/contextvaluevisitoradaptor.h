@@ -88,6 +88,26 @@ public:
         m_visitor(std::move(value));
     }
 
+    /**
+     * @brief Calls the visitor object with the rvalue reference of the
+     * @ref Json value to which @a value refers to if it's not shared with
+     * anything else, or with the rvalue reference of its copy otherwise.
+     * @param[in] value A @ref JsonPtr value.
+     */
+    void operator()(JsonPtr& value)
+    {
+        if (value.use_count() == 1)
+        {
+            // shared values are created by makeSharedJson as non-const
+            // objects
+            m_visitor(std::move(const_cast<Json&>(*value)));
+        }
+        else
+        {
+            m_visitor(Json(*value));
+        }
+    }
+
 private:
     /**
      * @brief The visitor object to which the calls will be forwarded.
@@ -0,0 +1,313 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "src/interpreter/dependencyanalyzer.h"
+#include "src/ast/allnodes.h"
+#include <algorithm>
+
+namespace jmespath { namespace interpreter {
+
+bool Dependency::operator==(const Dependency &other) const
+{
+    return (path == other.path) && (isDeep == other.isDeep);
+}
+
+bool Dependency::isAffectedBy(const std::vector<String> &pointer) const
+{
+    // the changed location and the dependency should be on the same path
+    size_t length = std::min(pointer.size(), path.size());
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (path[i] && (*path[i] != pointer[i]))
+        {
+            return false;
+        }
+    }
+    // changing the value at the location of the dependency or at any of its
+    // parents affects the dependency, while changes inside the value only
+    // affect deep dependencies
+    return (pointer.size() <= path.size()) || isDeep;
+}
+
+std::vector<Dependency> DependencyAnalyzer::analyze(
+    const ast::ExpressionNode *expression)
+{
+    m_dependencies.clear();
+    // start at the root of the document
+    m_location = Location::value_type{};
+    visit(expression);
+    // the result depends on the whole value it evaluates to
+    useValue();
+    return std::move(m_dependencies);
+}
+
+void DependencyAnalyzer::visit(const ast::AbstractNode *node)
+{
+    node->accept(this);
+}
+
+void DependencyAnalyzer::visit(const ast::ExpressionNode *node)
+{
+    node->accept(this);
+}
+
+void DependencyAnalyzer::visit(const ast::IdentifierNode *node)
+{
+    if (m_location)
+    {
+        m_location->push_back(node->identifier);
+    }
+}
+
+void DependencyAnalyzer::visit(const ast::RawStringNode *)
+{
+    // raw strings don't depend on the document
+    m_location = boost::none;
+}
+
+void DependencyAnalyzer::visit(const ast::LiteralNode *)
+{
+    // literals don't depend on the document
+    m_location = boost::none;
+}
+
+void DependencyAnalyzer::visit(const ast::SubexpressionNode *node)
+{
+    visit(&node->leftExpression);
+    visit(&node->rightExpression);
+}
+
+void DependencyAnalyzer::visit(const ast::IndexExpressionNode *node)
+{
+    visit(&node->leftExpression);
+    const auto& bracket = node->bracketSpecifier.value;
+    if (node->isProjection())
+    {
+        auto filter = boost::get<ast::FilterExpressionNode>(&bracket);
+        analyzeProjection(
+            boost::get<ast::FlattenOperatorNode>(&bracket) != nullptr,
+            filter ? &filter->expression : nullptr,
+            &node->rightExpression);
+    }
+    // an array item might be at any index after the array is changed
+    else if (m_location)
+    {
+        m_location->push_back(boost::none);
+    }
+}
+
+void DependencyAnalyzer::visit(const ast::ArrayItemNode *)
+{
+    // analyzed by visit(const ast::IndexExpressionNode*)
+}
+
+void DependencyAnalyzer::visit(const ast::FlattenOperatorNode *)
+{
+    // analyzed by visit(const ast::IndexExpressionNode*)
+}
+
+void DependencyAnalyzer::visit(const ast::BracketSpecifierNode *)
+{
+    // analyzed by visit(const ast::IndexExpressionNode*)
+}
+
+void DependencyAnalyzer::visit(const ast::SliceExpressionNode *)
+{
+    // analyzed by visit(const ast::IndexExpressionNode*)
+}
+
+void DependencyAnalyzer::visit(const ast::ListWildcardNode *)
+{
+    // analyzed by visit(const ast::IndexExpressionNode*)
+}
+
+void DependencyAnalyzer::visit(const ast::HashWildcardNode *node)
+{
+    visit(&node->leftExpression);
+    analyzeProjection(false, nullptr, &node->rightExpression);
+}
+
+void DependencyAnalyzer::visit(const ast::MultiselectListNode *node)
+{
+    // the result is null if the context is null
+    addDependency(false);
+    Location context = m_location;
+    for (const auto& expression: node->expressions)
+    {
+        m_location = context;
+        visit(&expression);
+        useValue();
+    }
+}
+
+void DependencyAnalyzer::visit(const ast::MultiselectHashNode *node)
+{
+    // the result is null if the context is null
+    addDependency(false);
+    Location context = m_location;
+    for (const auto& keyValuePair: node->expressions)
+    {
+        m_location = context;
+        visit(&keyValuePair.second);
+        useValue();
+    }
+}
+
+void DependencyAnalyzer::visit(const ast::NotExpressionNode *node)
+{
+    visit(&node->expression);
+    useValue();
+}
+
+void DependencyAnalyzer::visit(const ast::ComparatorExpressionNode *node)
+{
+    Location context = m_location;
+    visit(&node->leftExpression);
+    useValue();
+    m_location = std::move(context);
+    visit(&node->rightExpression);
+    useValue();
+}
+
+void DependencyAnalyzer::visit(const ast::OrExpressionNode *node)
+{
+    // the result is either the left or the right side result
+    Location context = m_location;
+    visit(&node->leftExpression);
+    useValue();
+    m_location = std::move(context);
+    visit(&node->rightExpression);
+    useValue();
+}
+
+void DependencyAnalyzer::visit(const ast::AndExpressionNode *node)
+{
+    // the result is either the left or the right side result
+    Location context = m_location;
+    visit(&node->leftExpression);
+    useValue();
+    m_location = std::move(context);
+    visit(&node->rightExpression);
+    useValue();
+}
+
+void DependencyAnalyzer::visit(const ast::ParenExpressionNode *node)
+{
+    visit(&node->expression);
+}
+
+void DependencyAnalyzer::visit(const ast::PipeExpressionNode *node)
+{
+    visit(&node->leftExpression);
+    visit(&node->rightExpression);
+}
+
+void DependencyAnalyzer::visit(const ast::CurrentNode *)
+{
+    // the current node refers to the current location
+}
+
+void DependencyAnalyzer::visit(const ast::FilterExpressionNode *)
+{
+    // analyzed by visit(const ast::IndexExpressionNode*)
+}
+
+void DependencyAnalyzer::visit(const ast::FunctionExpressionNode *node)
+{
+    // functions use their arguments as a whole, and expression arguments are
+    // evaluated on the items of the other arguments, so they don't have
+    // dependencies of their own
+    Location context = m_location;
+    for (const auto& argument: node->arguments)
+    {
+        if (auto expression = boost::get<ast::ExpressionNode>(&argument))
+        {
+            m_location = context;
+            visit(expression);
+            useValue();
+        }
+    }
+    m_location = boost::none;
+}
+
+void DependencyAnalyzer::visit(const ast::ExpressionArgumentNode *)
+{
+    // analyzed by visit(const ast::FunctionExpressionNode*)
+}
+
+void DependencyAnalyzer::addDependency(bool isDeep)
+{
+    if (m_location)
+    {
+        Dependency dependency{*m_location, isDeep};
+        if (std::find(m_dependencies.cbegin(),
+                      m_dependencies.cend(),
+                      dependency) == m_dependencies.cend())
+        {
+            m_dependencies.push_back(std::move(dependency));
+        }
+    }
+}
+
+void DependencyAnalyzer::useValue()
+{
+    addDependency();
+    m_location = boost::none;
+}
+
+void DependencyAnalyzer::analyzeProjection(bool isFlattened,
+                                           const ast::ExpressionNode *filter,
+                                           const ast::ExpressionNode *expression)
+{
+    Location item;
+    if (m_location)
+    {
+        // the items of flattened arrays might come from any depth
+        if (isFlattened)
+        {
+            addDependency();
+        }
+        // the result depends on the presence of the items, and the values of
+        // the items which are used by the filter and the projected expression
+        else
+        {
+            m_location->push_back(boost::none);
+            addDependency(false);
+            item = m_location;
+        }
+    }
+    if (filter)
+    {
+        m_location = item;
+        visit(filter);
+        useValue();
+    }
+    m_location = std::move(item);
+    visit(expression);
+    useValue();
+}
+}} // namespace jmespath::interpreter
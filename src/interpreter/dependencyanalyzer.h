@@ -0,0 +1,172 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef DEPENDENCYANALYZER_H
+#define DEPENDENCYANALYZER_H
+#include "src/interpreter/abstractvisitor.h"
+#include "jmespath/types.h"
+#include <vector>
+#include <boost/optional.hpp>
+
+namespace jmespath { namespace interpreter {
+
+/**
+ * @brief The Dependency struct describes a location in a document which the
+ * result of an expression depends on.
+ */
+struct Dependency
+{
+    /**
+     * @brief The type of the segments of the path, a field name or none
+     * which stands for any field name or array index.
+     */
+    using Segment = boost::optional<String>;
+    /**
+     * @brief The segments of the path from the root of the document.
+     */
+    std::vector<Segment> path;
+    /**
+     * @brief True if the result depends on the whole value at the location,
+     * or false if it only depends on the presence of the value.
+     */
+    bool isDeep{true};
+
+    /**
+     * @brief Equality compares this object to the @a other.
+     * @param[in] other The object that this object should be compared with.
+     * @return Returns true if this object is equal to the @a other,
+     * otherwise returns false.
+     */
+    bool operator==(const Dependency& other) const;
+    /**
+     * @brief Checks whether changing the value at the location described by
+     * the tokens of a JSON pointer might change the result of an expression
+     * which has this dependency.
+     * @param[in] pointer The reference tokens of a JSON pointer.
+     * @return Returns true if the change might affect the result, otherwise
+     * returns false.
+     */
+    bool isAffectedBy(const std::vector<String>& pointer) const;
+};
+
+/**
+ * @brief The DependencyAnalyzer class collects the locations of the
+ * document which the result of an expression depends on, without evaluating
+ * the expression.
+ *
+ * The analyzer follows the paths of field names and array indices starting
+ * from the root of the document. Every value which is used by the expression
+ * as a whole, like the results, the operands of comparisons and the arguments
+ * of functions, is recorded as a deep dependency, while the arrays and
+ * objects which are iterated over by projections are recorded as shallow
+ * dependencies on the presence of their items. Array indices are recorded as
+ * matching any index, since inserting or removing items shifts the indices
+ * of the following items. The collected dependencies are conservative, the
+ * result of the expression can only change if the document changes at a
+ * location which affects one of the dependencies.
+ */
+class DependencyAnalyzer : public AbstractVisitor
+{
+public:
+    /**
+     * @brief Collects the dependencies of the @a expression.
+     * @param[in] expression The root of the AST.
+     * @return The dependencies of the result of the @a expression.
+     */
+    std::vector<Dependency> analyze(const ast::ExpressionNode* expression);
+
+    /**
+     * @brief Analyze the given @a node on the current location.
+     * @param[in] node Pointer to the node
+     * @{
+     */
+    void visit(const ast::AbstractNode *node) override;
+    void visit(const ast::ExpressionNode *node) override;
+    void visit(const ast::IdentifierNode *node) override;
+    void visit(const ast::RawStringNode *node) override;
+    void visit(const ast::LiteralNode* node) override;
+    void visit(const ast::SubexpressionNode* node) override;
+    void visit(const ast::IndexExpressionNode* node) override;
+    void visit(const ast::ArrayItemNode*) override;
+    void visit(const ast::FlattenOperatorNode*) override;
+    void visit(const ast::BracketSpecifierNode*) override;
+    void visit(const ast::SliceExpressionNode*) override;
+    void visit(const ast::ListWildcardNode*) override;
+    void visit(const ast::HashWildcardNode* node) override;
+    void visit(const ast::MultiselectListNode* node) override;
+    void visit(const ast::MultiselectHashNode* node) override;
+    void visit(const ast::NotExpressionNode* node) override;
+    void visit(const ast::ComparatorExpressionNode* node) override;
+    void visit(const ast::OrExpressionNode* node) override;
+    void visit(const ast::AndExpressionNode* node) override;
+    void visit(const ast::ParenExpressionNode* node) override;
+    void visit(const ast::PipeExpressionNode* node) override;
+    void visit(const ast::CurrentNode*) override;
+    void visit(const ast::FilterExpressionNode*) override;
+    void visit(const ast::FunctionExpressionNode* node) override;
+    void visit(const ast::ExpressionArgumentNode*) override;
+    /** @}*/
+
+private:
+    /**
+     * @brief The type of locations in the document.
+     */
+    using Location = boost::optional<std::vector<Dependency::Segment>>;
+    /**
+     * @brief The location of the current value in the document, or none if
+     * the current value is created by the expression.
+     */
+    Location m_location;
+    /**
+     * @brief The collected dependencies.
+     */
+    std::vector<Dependency> m_dependencies;
+
+    /**
+     * @brief Records a dependency on the current location if it's known.
+     * @param[in] isDeep Specifies whether the dependency is deep.
+     */
+    void addDependency(bool isDeep = true);
+    /**
+     * @brief Records that the current value is used as a whole and
+     * continues with a value created by the expression.
+     */
+    void useValue();
+    /**
+     * @brief Analyzes a projection of the current value.
+     * @param[in] isFlattened True if the items of the current value are
+     * flattened before they're projected.
+     * @param[in] filter The filtering condition of the projection or
+     * `nullptr`.
+     * @param[in] expression The expression evaluated on the items.
+     */
+    void analyzeProjection(bool isFlattened,
+                           const ast::ExpressionNode* filter,
+                           const ast::ExpressionNode* expression);
+};
+}} // namespace jmespath::interpreter
+#endif // DEPENDENCYANALYZER_H
@@ -0,0 +1,190 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "src/interpreter/extremevalue.h"
+#include <algorithm>
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JMESPATH_EXTREME_VALUE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace jmespath { namespace interpreter {
+
+namespace {
+/**
+ * @brief Returns the smaller of @a left and @a right if @a FindSmallest is
+ * true, otherwise returns the larger one.
+ */
+template <bool FindSmallest, typename T>
+inline T extremeOf(T left, T right)
+{
+    return FindSmallest ? std::min(left, right) : std::max(left, right);
+}
+
+/**
+ * @brief Reduces the @a values one by one, starting with the @a result.
+ * @param[in] values The address of the values.
+ * @param[in] size The number of values.
+ * @param[in] result The extreme value of the preceding values.
+ * @return The largest or the smallest value.
+ */
+template <bool FindSmallest, typename T>
+T scalarExtremeValue(const T* values, size_t size, T result)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        result = extremeOf<FindSmallest>(result, values[i]);
+    }
+    return result;
+}
+
+#ifdef JMESPATH_EXTREME_VALUE_SSE2
+/**
+ * @brief Compares the signed 64-bit integers in the lanes of @a left and
+ * @a right, since SSE2 can only compare 32-bit integers.
+ * @return The lanes where @a left is greater than @a right are set to -1,
+ * the rest of them to 0.
+ */
+inline __m128i isGreater(__m128i left, __m128i right)
+{
+    // the higher halves decide the result unless they're equal, in which
+    // case the lower halves are compared as unsigned integers, whose result
+    // is the borrow into the higher half of the difference
+    __m128i result = _mm_and_si128(_mm_cmpeq_epi32(left, right),
+                                   _mm_sub_epi64(right, left));
+    result = _mm_or_si128(result, _mm_cmpgt_epi32(left, right));
+    // copy the results of the higher halves into the lower halves
+    return _mm_shuffle_epi32(result, _MM_SHUFFLE(3, 3, 1, 1));
+}
+
+/**
+ * @brief Returns the smaller or the larger integers in the lanes of @a left
+ * and @a right.
+ */
+template <bool FindSmallest>
+inline __m128i extremeOf(__m128i left, __m128i right)
+{
+    const __m128i mask = FindSmallest ? isGreater(left, right)
+                                      : isGreater(right, left);
+    return _mm_or_si128(_mm_and_si128(mask, right),
+                        _mm_andnot_si128(mask, left));
+}
+
+/**
+ * @brief Returns the smaller or the larger floating point numbers in the
+ * lanes of @a left and @a right.
+ */
+template <bool FindSmallest>
+inline __m128d extremeOf(__m128d left, __m128d right)
+{
+    return FindSmallest ? _mm_min_pd(left, right) : _mm_max_pd(left, right);
+}
+
+/**
+ * @brief Loads two values from the possibly unaligned address @a values.
+ */
+inline __m128i loadLanes(const std::int64_t* values)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+}
+
+/**
+ * @brief Loads two values from the possibly unaligned address @a values.
+ */
+inline __m128d loadLanes(const double* values)
+{
+    return _mm_loadu_pd(values);
+}
+
+/**
+ * @brief Stores the two lanes of @a lanes at @a values.
+ */
+inline void storeLanes(std::int64_t* values, __m128i lanes)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(values), lanes);
+}
+
+/**
+ * @brief Stores the two lanes of @a lanes at @a values.
+ */
+inline void storeLanes(double* values, __m128d lanes)
+{
+    _mm_storeu_pd(values, lanes);
+}
+#endif
+
+/**
+ * @brief Finds the largest or the smallest of the @a values.
+ * @param[in] values The address of the values.
+ * @param[in] size The number of values, at least 1.
+ * @return The largest or the smallest value.
+ */
+template <bool FindSmallest, typename T>
+T extremeValue(const T* values, size_t size)
+{
+#ifdef JMESPATH_EXTREME_VALUE_SSE2
+    // two registers are reduced independently, so consecutive comparisons
+    // don't have to wait for each other
+    const size_t blockSize = 4;
+    if (size >= blockSize)
+    {
+        auto first = loadLanes(values);
+        auto second = loadLanes(values + 2);
+        size_t offset = blockSize;
+        for (; offset + blockSize <= size; offset += blockSize)
+        {
+            first = extremeOf<FindSmallest>(first, loadLanes(values + offset));
+            second = extremeOf<FindSmallest>(second,
+                                             loadLanes(values + offset + 2));
+        }
+        T lanes[2];
+        storeLanes(lanes, extremeOf<FindSmallest>(first, second));
+        return scalarExtremeValue<FindSmallest>(
+            values + offset,
+            size - offset,
+            extremeOf<FindSmallest>(lanes[0], lanes[1]));
+    }
+#endif
+    return scalarExtremeValue<FindSmallest>(values + 1, size - 1, values[0]);
+}
+} // anonymous namespace
+
+std::int64_t extremeValue(const std::int64_t* values,
+                          size_t size,
+                          bool findSmallest)
+{
+    return findSmallest ? extremeValue<true>(values, size)
+                        : extremeValue<false>(values, size);
+}
+
+double extremeValue(const double* values, size_t size, bool findSmallest)
+{
+    return findSmallest ? extremeValue<true>(values, size)
+                        : extremeValue<false>(values, size);
+}
+}} // namespace jmespath::interpreter
@@ -0,0 +1,64 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef EXTREMEVALUE_H
+#define EXTREMEVALUE_H
+#include <cstddef>
+#include <cstdint>
+
+namespace jmespath { namespace interpreter {
+
+/**
+ * @brief Finds the largest or the smallest of the integer @a values.
+ *
+ * The values are compared in multiple lanes at once, and only the lanes are
+ * compared with each other at the end.
+ * @param[in] values The address of the values.
+ * @param[in] size The number of values, which should be at least 1.
+ * @param[in] findSmallest If true then the smallest value is returned
+ * instead of the largest.
+ * @return The largest or the smallest value.
+ */
+std::int64_t extremeValue(const std::int64_t* values,
+                          size_t size,
+                          bool findSmallest);
+
+/**
+ * @brief Finds the largest or the smallest of the floating point @a values.
+ *
+ * The values are compared in multiple lanes at once, and only the lanes are
+ * compared with each other at the end.
+ * @param[in] values The address of the values.
+ * @param[in] size The number of values, which should be at least 1.
+ * @param[in] findSmallest If true then the smallest value is returned
+ * instead of the largest.
+ * @return The largest or the smallest value, which is undefined if the
+ * @a values contain NaN.
+ */
+double extremeValue(const double* values, size_t size, bool findSmallest);
+}} // namespace jmespath::interpreter
+#endif // EXTREMEVALUE_H
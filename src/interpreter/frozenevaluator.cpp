@@ -0,0 +1,800 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "src/interpreter/frozenevaluator.h"
+#include "src/ast/allnodes.h"
+#include "jmespath/exceptions.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace jmespath { namespace interpreter {
+
+FrozenEvaluator::FrozenEvaluator(const FrozenLayout &layout,
+                                 Interpreter *interpreter)
+    : AbstractVisitor{},
+      m_layout(layout),
+      m_interpreter(interpreter),
+      m_value(FrozenRef{FrozenLayout::root()})
+{
+}
+
+Json FrozenEvaluator::evaluate(const ast::ExpressionNode *expression)
+{
+    m_value = FrozenRef{FrozenLayout::root()};
+    visit(expression);
+    return toJson(std::move(m_value));
+}
+
+void FrozenEvaluator::visit(const ast::AbstractNode *node)
+{
+    node->accept(this);
+}
+
+void FrozenEvaluator::visit(const ast::ExpressionNode *node)
+{
+    // once the current value is converted into Json, the rest of the
+    // expression is evaluated by the interpreter
+    if (boost::get<Json>(&m_value))
+    {
+        interpret(node);
+        return;
+    }
+    node->accept(this);
+}
+
+void FrozenEvaluator::visit(const ast::IdentifierNode *node)
+{
+    const auto& value = boost::get<FrozenRef>(m_value);
+    std::uint32_t member;
+    if (m_layout.entry(value.index).type == FrozenLayout::Type::Object
+        && m_layout.find(value.index, node->identifier, &member))
+    {
+        m_value = FrozenRef{member};
+    }
+    else
+    {
+        m_value = Json{};
+    }
+}
+
+void FrozenEvaluator::visit(const ast::RawStringNode *node)
+{
+    // raw strings don't depend on the context
+    m_value = Json{};
+    interpret(node);
+}
+
+void FrozenEvaluator::visit(const ast::LiteralNode *node)
+{
+    // literals don't depend on the context
+    m_value = Json{};
+    interpret(node);
+}
+
+void FrozenEvaluator::visit(const ast::SubexpressionNode *node)
+{
+    visit(&node->leftExpression);
+    visit(&node->rightExpression);
+}
+
+void FrozenEvaluator::visit(const ast::IndexExpressionNode *node)
+{
+    // evaluate projections by streaming the items of the array through the
+    // bracket specifier and the right side expression
+    if (node->isProjection())
+    {
+        collectItems([&](const ItemSink& sink) {
+            return streamProjection(node, &node->leftExpression, sink);
+        }, std::numeric_limits<size_t>::max());
+        return;
+    }
+    // evaluate the left side expression
+    visit(&node->leftExpression);
+    // look up array items directly in the layout
+    auto arrayItem = boost::get<ast::ArrayItemNode>(
+        &node->bracketSpecifier.value);
+    auto value = boost::get<FrozenRef>(&m_value);
+    if (arrayItem && value)
+    {
+        const auto& entry = m_layout.entry(value->index);
+        if (entry.type != FrozenLayout::Type::Array)
+        {
+            m_value = Json{};
+            return;
+        }
+        // normalize the index value
+        auto arrayIndex = arrayItem->index;
+        if (arrayIndex < 0)
+        {
+            arrayIndex += entry.size;
+        }
+        if ((arrayIndex >= 0) && (arrayIndex < entry.size))
+        {
+            auto position = static_cast<size_t>(arrayIndex);
+            m_value = FrozenRef{m_layout.item(value->index, position)};
+        }
+        else
+        {
+            m_value = Json{};
+        }
+        return;
+    }
+    // otherwise evaluate the bracket specifier with the interpreter
+    interpretRightSide(node);
+}
+
+void FrozenEvaluator::visit(const ast::ArrayItemNode *)
+{
+    // evaluated by visit(const ast::IndexExpressionNode*)
+}
+
+void FrozenEvaluator::visit(const ast::FlattenOperatorNode *)
+{
+    // evaluated by the interpreter
+}
+
+void FrozenEvaluator::visit(const ast::BracketSpecifierNode *)
+{
+    // evaluated by visit(const ast::IndexExpressionNode*)
+}
+
+void FrozenEvaluator::visit(const ast::SliceExpressionNode *)
+{
+    // evaluated by the interpreter
+}
+
+void FrozenEvaluator::visit(const ast::ListWildcardNode *)
+{
+    // evaluated by the interpreter
+}
+
+void FrozenEvaluator::visit(const ast::HashWildcardNode *node)
+{
+    visit(&node->leftExpression);
+    auto value = boost::get<FrozenRef>(&m_value);
+    if (!value)
+    {
+        interpretRightSide(node);
+        return;
+    }
+    // project the values of objects in the layout one by one
+    const auto& entry = m_layout.entry(value->index);
+    if (entry.type != FrozenLayout::Type::Object)
+    {
+        m_value = Json{};
+        return;
+    }
+    std::uint32_t object = value->index;
+    collectItems([&](const ItemSink& sink) {
+        for (size_t i = 0; i < entry.size; ++i)
+        {
+            if (!projectItem(&node->rightExpression,
+                             FrozenRef{m_layout.member(object, i).value},
+                             sink))
+            {
+                break;
+            }
+        }
+        return true;
+    }, std::numeric_limits<size_t>::max());
+}
+
+void FrozenEvaluator::visit(const ast::MultiselectListNode *node)
+{
+    // evaluate to null if the context is null
+    if (isNull(m_value))
+    {
+        m_value = Json{};
+        return;
+    }
+    Value context = m_value;
+    Json result(Json::value_t::array);
+    auto& resultItems = result.get_ref<Json::array_t&>();
+    resultItems.reserve(node->expressions.size());
+    for (const auto& expression: node->expressions)
+    {
+        m_value = context;
+        visit(&expression);
+        resultItems.push_back(toJson(std::move(m_value)));
+    }
+    m_value = std::move(result);
+}
+
+void FrozenEvaluator::visit(const ast::MultiselectHashNode *node)
+{
+    // evaluate to null if the context is null
+    if (isNull(m_value))
+    {
+        m_value = Json{};
+        return;
+    }
+    Value context = m_value;
+    Json result(Json::value_t::object);
+    auto& resultItems = result.get_ref<Json::object_t&>();
+    for (const auto& keyValuePair: node->expressions)
+    {
+        m_value = context;
+        visit(&keyValuePair.second);
+        assignObjectItem(resultItems, keyValuePair.first.identifier,
+                         toJson(std::move(m_value)));
+    }
+    m_value = std::move(result);
+}
+
+void FrozenEvaluator::visit(const ast::NotExpressionNode *node)
+{
+    visit(&node->expression);
+    m_value = Json(!toBoolean(m_value));
+}
+
+void FrozenEvaluator::visit(const ast::ComparatorExpressionNode *node)
+{
+    using Comparator = ast::ComparatorExpressionNode::Comparator;
+
+    if (node->comparator == Comparator::Unknown)
+    {
+        BOOST_THROW_EXCEPTION(InvalidAgrument{});
+    }
+    // evaluate both sides on the same context
+    Value context = m_value;
+    visit(&node->leftExpression);
+    Json leftResult = toJson(std::move(m_value));
+    m_value = std::move(context);
+    visit(&node->rightExpression);
+    Json rightResult = toJson(std::move(m_value));
+
+    if (node->comparator == Comparator::Equal)
+    {
+        m_value = Json(leftResult == rightResult);
+    }
+    else if (node->comparator == Comparator::NotEqual)
+    {
+        m_value = Json(leftResult != rightResult);
+    }
+    // if a non number is involved in an ordering comparison the result
+    // should be null
+    else if (!leftResult.is_number() || !rightResult.is_number())
+    {
+        m_value = Json{};
+    }
+    else if (node->comparator == Comparator::Less)
+    {
+        m_value = Json(leftResult < rightResult);
+    }
+    else if (node->comparator == Comparator::LessOrEqual)
+    {
+        m_value = Json(leftResult <= rightResult);
+    }
+    else if (node->comparator == Comparator::GreaterOrEqual)
+    {
+        m_value = Json(leftResult >= rightResult);
+    }
+    else
+    {
+        m_value = Json(leftResult > rightResult);
+    }
+}
+
+void FrozenEvaluator::visit(const ast::OrExpressionNode *node)
+{
+    // return with the left side result if it's true
+    Value context = m_value;
+    visit(&node->leftExpression);
+    if (!toBoolean(m_value))
+    {
+        m_value = std::move(context);
+        visit(&node->rightExpression);
+    }
+}
+
+void FrozenEvaluator::visit(const ast::AndExpressionNode *node)
+{
+    // return with the left side result if it's false
+    Value context = m_value;
+    visit(&node->leftExpression);
+    if (toBoolean(m_value))
+    {
+        m_value = std::move(context);
+        visit(&node->rightExpression);
+    }
+}
+
+void FrozenEvaluator::visit(const ast::ParenExpressionNode *node)
+{
+    visit(&node->expression);
+}
+
+void FrozenEvaluator::visit(const ast::PipeExpressionNode *node)
+{
+    // if the right expression only depends on the first few items of the
+    // array produced by the left expression, then stop the evaluation of the
+    // left expression once these items are available
+    auto limit = Interpreter::resultLimit(&node->rightExpression);
+    if (limit && Interpreter::isStreamable(&node->leftExpression))
+    {
+        collectItems([&](const ItemSink& sink) {
+            return streamArray(&node->leftExpression, sink);
+        }, *limit);
+    }
+    // otherwise evaluate the left expression in its entirety
+    else
+    {
+        visit(&node->leftExpression);
+    }
+    visit(&node->rightExpression);
+}
+
+void FrozenEvaluator::visit(const ast::CurrentNode *)
+{
+}
+
+void FrozenEvaluator::visit(const ast::FilterExpressionNode *)
+{
+    // evaluated by the interpreter
+}
+
+void FrozenEvaluator::visit(const ast::FunctionExpressionNode *node)
+{
+    // the length of the values in the layout is known without converting
+    // them, and the length of ASCII strings without counting their code
+    // points
+    if (node->functionName == "length" && node->arguments.size() == 1)
+    {
+        if (auto argument = boost::get<ast::ExpressionNode>(
+                &node->arguments[0]))
+        {
+            visit(argument);
+            if (auto valueRef = boost::get<FrozenRef>(&m_value))
+            {
+                const auto& entry = m_layout.entry(valueRef->index);
+                if (entry.type == FrozenLayout::Type::String)
+                {
+                    m_value = Json(m_layout.codePointCount(valueRef->index));
+                    return;
+                }
+                if (entry.type == FrozenLayout::Type::Array
+                    || entry.type == FrozenLayout::Type::Object)
+                {
+                    m_value = Json(entry.size);
+                    return;
+                }
+            }
+            // the interpreter reports the invalid arguments
+            Value argumentValue = std::move(m_value);
+            m_interpreter->evaluateFunction(node, [&](size_t) {
+                return ContextValue{toJson(std::move(argumentValue))};
+            });
+            takeInterpreterResult();
+            return;
+        }
+    }
+    // evaluate the expression arguments on the items in the layout
+    if (evaluateItemFunction(node))
+    {
+        return;
+    }
+    // evaluate the JSON expression arguments on the layout and convert only
+    // their results into Json values
+    Value context = m_value;
+    m_interpreter->evaluateFunction(node, [&](size_t index) {
+        m_value = context;
+        visit(&boost::get<ast::ExpressionNode>(node->arguments[index]));
+        return ContextValue{toJson(std::move(m_value))};
+    });
+    takeInterpreterResult();
+}
+
+void FrozenEvaluator::visit(const ast::ExpressionArgumentNode *)
+{
+    // evaluated by the interpreter
+}
+
+bool FrozenEvaluator::streamArray(const ast::ExpressionNode *expression,
+                                  const ItemSink &sink)
+{
+    // stream the results of the sub expression of parenthesized expressions
+    if (auto node = boost::get<ast::ParenExpressionNode>(&expression->value))
+    {
+        return streamArray(&node->expression, sink);
+    }
+    // stream the results of the projection
+    if (auto node = boost::get<ast::IndexExpressionNode>(&expression->value))
+    {
+        return streamProjection(node, &node->leftExpression, sink);
+    }
+    // stream the results of the projection at the end of the pipe expression
+    auto node = boost::get<ast::PipeExpressionNode>(&expression->value);
+    auto rightNode = boost::get<ast::IndexExpressionNode>(
+        &node->rightExpression.value);
+    // the projection is applied directly on the result of the left expression
+    // if it doesn't have a left expression of its own, so the left
+    // expression can be streamed too
+    if (rightNode->leftExpression.isNull())
+    {
+        return streamProjection(rightNode, &node->leftExpression, sink);
+    }
+    // otherwise evaluate the left expression and project the right
+    visit(&node->leftExpression);
+    return streamProjection(rightNode, &rightNode->leftExpression, sink);
+}
+
+bool FrozenEvaluator::streamProjection(const ast::IndexExpressionNode *node,
+                                       const ast::ExpressionNode *source,
+                                       const ItemSink &sink)
+{
+    const auto& bracket = node->bracketSpecifier.value;
+    auto filter = boost::get<ast::FilterExpressionNode>(&bracket);
+    auto slice = boost::get<ast::SliceExpressionNode>(&bracket);
+    bool isFlatten = boost::get<ast::FlattenOperatorNode>(&bracket) != nullptr;
+
+    // evaluates the right side expression on an item
+    ItemSink projectionSink = [&](Value&& item) {
+        return projectItem(&node->rightExpression, std::move(item), sink);
+    };
+    // applies the bracket specifier on an item of the source array, slices
+    // are applied while iterating over the source array
+    ItemSink bracketSink = [&](Value&& item) {
+        // skip the item if it doesn't satisfy the filtering condition
+        if (filter)
+        {
+            m_value = item;
+            visit(&filter->expression);
+            if (!toBoolean(m_value))
+            {
+                return true;
+            }
+        }
+        // project the items of the item if it's an array that should be
+        // flattened
+        else if (isFlatten && isArray(item))
+        {
+            return streamItems(std::move(item), nullptr, projectionSink);
+        }
+        return projectItem(&node->rightExpression, std::move(item), sink);
+    };
+
+    // if the source is streamable and the bracket specifier can be applied
+    // without knowing the length of the array, then stream the items of the
+    // source through the bracket specifier
+    if (Interpreter::isStreamable(source)
+        && m_interpreter->acceptsStreamedItems(node->bracketSpecifier))
+    {
+        if (!slice)
+        {
+            return streamArray(source, bracketSink);
+        }
+        // select the items of the slice by counting the items of the source
+        auto start = static_cast<size_t>(slice->start.value_or(0));
+        auto step = static_cast<size_t>(slice->step.value_or(1));
+        auto stop = slice->stop ? static_cast<size_t>(*slice->stop)
+                                : std::numeric_limits<size_t>::max();
+        size_t index = 0;
+        return streamArray(source, [&](Value&& item) {
+            if (index >= stop)
+            {
+                return false;
+            }
+            bool isSelected = (index >= start)
+                && ((index - start) % step == 0);
+            ++index;
+            if (isSelected && !bracketSink(std::move(item)))
+            {
+                return false;
+            }
+            return index < stop;
+        });
+    }
+
+    // otherwise evaluate the source array
+    visit(source);
+    Value sourceValue{std::move(m_value)};
+    if (!isArray(sourceValue))
+    {
+        return false;
+    }
+    // and pass its items through the bracket specifier
+    streamItems(std::move(sourceValue), slice, bracketSink);
+    return true;
+}
+
+bool FrozenEvaluator::streamItems(Value &&array,
+                                  const ast::SliceExpressionNode *slice,
+                                  const ItemSink &sink)
+{
+    // refer to the items of arrays in the layout and move the items of Json
+    // arrays
+    auto frozenArray = boost::get<FrozenRef>(&array);
+    auto jsonArray = boost::get<Json>(&array);
+    size_t size = frozenArray ? m_layout.entry(frozenArray->index).size
+                              : jsonArray->size();
+    auto item = [&](size_t position) -> Value {
+        if (frozenArray)
+        {
+            return FrozenRef{m_layout.item(frozenArray->index, position)};
+        }
+        return std::move((*jsonArray)[position]);
+    };
+    // pass the items selected by the slice
+    if (slice)
+    {
+        Index start = 0;
+        Index stop = 0;
+        Index step = 1;
+        m_interpreter->sliceBounds(slice, size, &start, &stop, &step);
+        for (auto i = start;
+             step > 0 ? (i < stop) : (i > stop);
+             i += step)
+        {
+            if (!sink(item(static_cast<size_t>(i))))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    // or pass every item
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (!sink(item(i)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FrozenEvaluator::projectItem(const ast::ExpressionNode *expression,
+                                  Value &&item,
+                                  const ItemSink &sink)
+{
+    // evaluate the right side expression on the item
+    m_value = std::move(item);
+    visit(expression);
+    // skip null results
+    if (isNull(m_value))
+    {
+        return true;
+    }
+    // move the result out of the current value before passing it to the
+    // sink, since the sink might evaluate further expressions
+    Value result{std::move(m_value)};
+    return sink(std::move(result));
+}
+
+template <typename ProducerT>
+void FrozenEvaluator::collectItems(ProducerT &&producer, size_t limit)
+{
+    // create the array of results and convert the items until the limit is
+    // reached
+    Json result(Json::value_t::array);
+    auto& resultItems = result.get_ref<Json::array_t&>();
+    bool isArrayResult = producer([&](Value&& item) {
+        resultItems.push_back(toJson(std::move(item)));
+        return resultItems.size() < limit;
+    });
+    // evaluate to the array of results or to null
+    if (isArrayResult)
+    {
+        m_value = std::move(result);
+    }
+    else
+    {
+        m_value = Json{};
+    }
+}
+
+bool FrozenEvaluator::evaluateItemFunction(
+    const ast::FunctionExpressionNode *node)
+{
+    const auto& name = node->functionName;
+    bool isMap = (name == "map");
+    bool isSortBy = (name == "sort_by");
+    bool isMaxBy = (name == "max_by");
+    bool isMinBy = (name == "min_by");
+    if (!(isMap || isSortBy || isMaxBy || isMinBy)
+        || node->arguments.size() != 2)
+    {
+        return false;
+    }
+    // map takes the expression argument first, while the rest of the
+    // functions take the array first
+    size_t arrayPosition = isMap ? 1 : 0;
+    auto arrayArgument = boost::get<ast::ExpressionNode>(
+        &node->arguments[arrayPosition]);
+    auto expressionArgument = boost::get<ast::ExpressionArgumentNode>(
+        &node->arguments[1 - arrayPosition]);
+    if (!arrayArgument || !expressionArgument)
+    {
+        return false;
+    }
+    visit(arrayArgument);
+    auto array = boost::get<FrozenRef>(&m_value);
+    if (!array || m_layout.entry(array->index).type
+        != FrozenLayout::Type::Array)
+    {
+        // the interpreter evaluates the function on converted values and
+        // reports the invalid arguments
+        Value argumentValue = std::move(m_value);
+        m_interpreter->evaluateFunction(node, [&](size_t) {
+            return ContextValue{toJson(std::move(argumentValue))};
+        });
+        takeInterpreterResult();
+        return true;
+    }
+    std::uint32_t arrayIndex = array->index;
+    const auto& expression = expressionArgument->expression;
+    std::vector<Json> results = evaluateOnItems(&expression,
+                                                arrayIndex,
+                                                !isMap,
+                                                isSortBy);
+    // the results of map are the results of the expression
+    if (isMap)
+    {
+        m_value = Json(std::move(results));
+        return true;
+    }
+    // the result of max_by and min_by is the first item with the largest or
+    // smallest result, which can keep referring to the layout
+    if (isMaxBy || isMinBy)
+    {
+        if (results.empty())
+        {
+            m_value = Json{};
+            return true;
+        }
+        auto it = isMaxBy ? std::max_element(results.cbegin(),
+                                             results.cend(),
+                                             std::less<Json>{})
+                          : std::max_element(results.cbegin(),
+                                             results.cend(),
+                                             std::greater<Json>{});
+        auto position = static_cast<size_t>(
+            std::distance(results.cbegin(), it));
+        m_value = FrozenRef{m_layout.item(arrayIndex, position)};
+        return true;
+    }
+    // sort the indices of the items based on the results of the expression
+    // and convert the items in sorted order
+    std::vector<size_t> indices(results.size());
+    std::iota(std::begin(indices), std::end(indices), 0);
+    std::stable_sort(std::begin(indices), std::end(indices),
+                     [&](size_t first, size_t second) {
+        return results[first] < results[second];
+    });
+    Json result(Json::value_t::array);
+    auto& resultItems = result.get_ref<Json::array_t&>();
+    resultItems.reserve(indices.size());
+    for (size_t index: indices)
+    {
+        resultItems.push_back(m_layout.toJson(m_layout.item(arrayIndex,
+                                                            index)));
+    }
+    m_value = std::move(result);
+    return true;
+}
+
+std::vector<Json> FrozenEvaluator::evaluateOnItems(
+    const ast::ExpressionNode *expression,
+    std::uint32_t array,
+    bool isSortKey,
+    bool isSameType)
+{
+    const auto& entry = m_layout.entry(array);
+    std::vector<Json> results;
+    results.reserve(entry.size);
+    for (size_t i = 0; i < entry.size; ++i)
+    {
+        m_value = FrozenRef{m_layout.item(array, i)};
+        visit(expression);
+        results.push_back(toJson(std::move(m_value)));
+        // sort keys must be numbers or strings, and they might also need to
+        // have the same type
+        const Json& key = results.back();
+        if ((isSortKey && !(key.is_number() || key.is_string()))
+            || (isSameType && key.type() != results.front().type()))
+        {
+            BOOST_THROW_EXCEPTION(InvalidFunctionArgumentType());
+        }
+    }
+    return results;
+}
+
+Json FrozenEvaluator::toJson(Value &&value) const
+{
+    if (auto frozenValue = boost::get<FrozenRef>(&value))
+    {
+        return m_layout.toJson(frozenValue->index);
+    }
+    return std::move(boost::get<Json>(value));
+}
+
+bool FrozenEvaluator::isNull(const Value &value) const
+{
+    if (auto frozenValue = boost::get<FrozenRef>(&value))
+    {
+        return m_layout.entry(frozenValue->index).type
+            == FrozenLayout::Type::Null;
+    }
+    return boost::get<Json>(value).is_null();
+}
+
+bool FrozenEvaluator::isArray(const Value &value) const
+{
+    if (auto frozenValue = boost::get<FrozenRef>(&value))
+    {
+        return m_layout.entry(frozenValue->index).type
+            == FrozenLayout::Type::Array;
+    }
+    return boost::get<Json>(value).is_array();
+}
+
+bool FrozenEvaluator::toBoolean(const Value &value) const
+{
+    if (auto frozenValue = boost::get<FrozenRef>(&value))
+    {
+        const auto& entry = m_layout.entry(frozenValue->index);
+        switch (entry.type)
+        {
+        case FrozenLayout::Type::Null:
+            return false;
+        case FrozenLayout::Type::Boolean:
+            return entry.payload != 0;
+        case FrozenLayout::Type::String:
+        case FrozenLayout::Type::Array:
+        case FrozenLayout::Type::Object:
+            return entry.size != 0;
+        default:
+            return true;
+        }
+    }
+    return m_interpreter->toBoolean(boost::get<Json>(value));
+}
+
+template <typename NodeT>
+void FrozenEvaluator::interpret(const NodeT *node)
+{
+    m_interpreter->setContext(toJson(std::move(m_value)));
+    m_interpreter->visit(node);
+    takeInterpreterResult();
+}
+
+template <typename NodeT>
+void FrozenEvaluator::interpretRightSide(const NodeT *node)
+{
+    m_interpreter->setContext(toJson(std::move(m_value)));
+    m_interpreter->evaluateRightSide(node);
+    takeInterpreterResult();
+}
+
+void FrozenEvaluator::takeInterpreterResult()
+{
+    m_value = takeJsonValue(std::move(m_interpreter->currentContextValue()));
+    // don't keep the moved from value in the context of the interpreter
+    m_interpreter->setContext(Json{});
+}
+}} // namespace jmespath::interpreter
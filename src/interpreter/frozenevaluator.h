@@ -0,0 +1,270 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef FROZENEVALUATOR_H
+#define FROZENEVALUATOR_H
+#include "src/interpreter/abstractvisitor.h"
+#include "src/interpreter/interpreter.h"
+#include "src/interpreter/frozenlayout.h"
+#include "jmespath/types.h"
+
+namespace jmespath { namespace interpreter {
+
+/**
+ * @brief The FrozenEvaluator class evaluates the AST on a document stored in
+ * a @ref FrozenLayout.
+ *
+ * Identifiers, array indices, sub expressions, pipes, projections,
+ * filters, multiselect expressions, logic operators and the arguments of
+ * function calls are evaluated directly on the layout, and their results keep
+ * referring to the values in the layout. Values are only converted into
+ * @ref Json values when they become part of a result, when they're compared
+ * or passed to a function. The expression arguments of `map`, `sort_by`,
+ * `max_by` and `min_by` are evaluated on the items in the layout, so only
+ * the results of the expressions and the selected items are converted.
+ * Projections stream their items just like the interpreter does, so pipes
+ * which only need the first few results stop early. Expressions evaluated
+ * on converted values are evaluated by the interpreter.
+ */
+class FrozenEvaluator : public AbstractVisitor
+{
+public:
+    /**
+     * @brief Constructs a FrozenEvaluator object.
+     * @param[in] layout The layout of the document.
+     * @param[in] interpreter The interpreter used for evaluating the
+     * expressions which aren't evaluated on the layout.
+     */
+    FrozenEvaluator(const FrozenLayout& layout, Interpreter* interpreter);
+    /**
+     * @brief Evaluates the @a expression on the root of the document.
+     * @param[in] expression The root of the AST.
+     * @return The result of the evaluation.
+     */
+    Json evaluate(const ast::ExpressionNode* expression);
+
+    /**
+     * @brief Evaluate the given @a node on the current value.
+     * @param[in] node Pointer to the node
+     * @{
+     */
+    void visit(const ast::AbstractNode *node) override;
+    void visit(const ast::ExpressionNode *node) override;
+    void visit(const ast::IdentifierNode *node) override;
+    void visit(const ast::RawStringNode *node) override;
+    void visit(const ast::LiteralNode* node) override;
+    void visit(const ast::SubexpressionNode* node) override;
+    void visit(const ast::IndexExpressionNode* node) override;
+    void visit(const ast::ArrayItemNode*) override;
+    void visit(const ast::FlattenOperatorNode*) override;
+    void visit(const ast::BracketSpecifierNode*) override;
+    void visit(const ast::SliceExpressionNode*) override;
+    void visit(const ast::ListWildcardNode*) override;
+    void visit(const ast::HashWildcardNode* node) override;
+    void visit(const ast::MultiselectListNode* node) override;
+    void visit(const ast::MultiselectHashNode* node) override;
+    void visit(const ast::NotExpressionNode* node) override;
+    void visit(const ast::ComparatorExpressionNode* node) override;
+    void visit(const ast::OrExpressionNode* node) override;
+    void visit(const ast::AndExpressionNode* node) override;
+    void visit(const ast::ParenExpressionNode* node) override;
+    void visit(const ast::PipeExpressionNode* node) override;
+    void visit(const ast::CurrentNode*) override;
+    void visit(const ast::FilterExpressionNode*) override;
+    void visit(const ast::FunctionExpressionNode* node) override;
+    void visit(const ast::ExpressionArgumentNode*) override;
+    /** @}*/
+
+private:
+    /**
+     * @brief Refers to a value in the layout by the index of its entry.
+     */
+    struct FrozenRef
+    {
+        std::uint32_t index;
+    };
+    /**
+     * @brief The result of an evaluation, which either refers to a value in
+     * the layout or holds a @ref Json value.
+     */
+    using Value = boost::variant<FrozenRef, Json>;
+    /**
+     * @brief Type of the functions which receive the items of a streamed
+     * array one by one, and return false if they don't need any more items.
+     */
+    using ItemSink = std::function<bool(Value&&)>;
+    /**
+     * @brief The layout of the document.
+     */
+    const FrozenLayout& m_layout;
+    /**
+     * @brief The interpreter used for evaluating the expressions which
+     * aren't evaluated on the layout.
+     */
+    Interpreter* m_interpreter;
+    /**
+     * @brief The current value, which is the context of the next evaluated
+     * node and the result of the last evaluated node.
+     */
+    Value m_value;
+
+    /**
+     * @brief Evaluates the streamable @a expression on the current value
+     * and passes the items of the resulting array to the @a sink as soon as
+     * they're evaluated, like Interpreter::streamArray.
+     * @param[in] expression A streamable expression.
+     * @param[in] sink The function which receives the items.
+     * @return Returns true if the result of the @a expression is an array,
+     * or false if it's null.
+     */
+    bool streamArray(const ast::ExpressionNode* expression,
+                     const ItemSink& sink);
+    /**
+     * @brief Evaluates the projection @a node on the array produced by the
+     * @a source expression and passes the results of the projection to the
+     * @a sink, like Interpreter::streamProjection.
+     * @param[in] node The projected index expression.
+     * @param[in] source The expression which produces the array that should
+     * be projected.
+     * @param[in] sink The function which receives the results of the
+     * projection.
+     * @return Returns true if the result of the projection is an array, or
+     * false if it's null.
+     */
+    bool streamProjection(const ast::IndexExpressionNode* node,
+                          const ast::ExpressionNode* source,
+                          const ItemSink& sink);
+    /**
+     * @brief Passes the items of the @a array to the @a sink, or only the
+     * items selected by the @a slice if it's not `nullptr`.
+     * @param[in] array An array in the layout or a @ref Json array.
+     * @param[in] slice The slice expression which selects the items or
+     * `nullptr`.
+     * @param[in] sink The function which receives the items.
+     * @return Returns false if the @a sink doesn't need any more items,
+     * otherwise returns true.
+     */
+    bool streamItems(Value&& array,
+                     const ast::SliceExpressionNode* slice,
+                     const ItemSink& sink);
+    /**
+     * @brief Evaluates the right side @a expression of a projection on the
+     * @a item and passes the result to the @a sink if it's not null.
+     * @param[in] expression The projected expression.
+     * @param[in] item The projected value.
+     * @param[in] sink The function which receives the result.
+     * @return Returns false if the @a sink doesn't need any more items,
+     * otherwise returns true.
+     */
+    bool projectItem(const ast::ExpressionNode* expression,
+                     Value&& item,
+                     const ItemSink& sink);
+    /**
+     * @brief Collects the items passed to an @ref ItemSink by the
+     * @a producer into an array and sets it as the current value.
+     * @param[in] producer A function which receives a sink and passes it the
+     * items of an array. It should return false if the result is null.
+     * @param[in] limit The maximum number of items that should be collected.
+     * @tparam ProducerT The type of the @a producer.
+     */
+    template <typename ProducerT>
+    void collectItems(ProducerT&& producer, size_t limit);
+    /**
+     * @brief Evaluates the `map`, `sort_by`, `max_by` and `min_by` functions
+     * on arrays in the layout, by evaluating their expression argument on
+     * the items in the layout.
+     * @param[in] node The function expression.
+     * @return Returns false if the @a node isn't a call of one of these
+     * functions with a JSON and an expression argument, in which case
+     * nothing is evaluated, otherwise returns true.
+     */
+    bool evaluateItemFunction(const ast::FunctionExpressionNode* node);
+    /**
+     * @brief Evaluates the @a expression on every item of the @a array in
+     * the layout and converts the results into @ref Json values.
+     * @param[in] expression The evaluated expression.
+     * @param[in] array The index of an array in the layout.
+     * @param[in] isSortKey If true, every result must be a number or a
+     * string.
+     * @param[in] isSameType If true, every result must have the same type.
+     * @return The results of the @a expression.
+     * @throws InvalidFunctionArgumentType If one of the results doesn't
+     * satisfy the requirements of @a isSortKey and @a isSameType.
+     */
+    std::vector<Json> evaluateOnItems(const ast::ExpressionNode* expression,
+                                      std::uint32_t array,
+                                      bool isSortKey,
+                                      bool isSameType);
+    /**
+     * @brief Converts the @a value into a @ref Json value.
+     * @param[in] value The value that should be converted.
+     * @return The @ref Json value.
+     */
+    Json toJson(Value&& value) const;
+    /**
+     * @brief Checks whether the @a value is null.
+     * @param[in] value A value.
+     * @return Returns true if the @a value is null, otherwise false.
+     */
+    bool isNull(const Value& value) const;
+    /**
+     * @brief Checks whether the @a value is an array.
+     * @param[in] value A value.
+     * @return Returns true if the @a value is an array, otherwise false.
+     */
+    bool isArray(const Value& value) const;
+    /**
+     * @brief Converts the @a value to a boolean according to the JMESPath
+     * rules of truthiness.
+     * @param[in] value A value.
+     * @return The truth value of the @a value.
+     */
+    bool toBoolean(const Value& value) const;
+    /**
+     * @brief Evaluates the @a node with the interpreter on the current value
+     * after converting it into a @ref Json value.
+     * @param[in] node The node that should be evaluated.
+     * @tparam NodeT The type of the @a node.
+     */
+    template <typename NodeT>
+    void interpret(const NodeT* node);
+    /**
+     * @brief Evaluates the right side of the @a node with the interpreter on
+     * the current value after converting it into a @ref Json value.
+     * @param[in] node An index expression or a hash wildcard expression.
+     * @tparam NodeT The type of the @a node.
+     */
+    template <typename NodeT>
+    void interpretRightSide(const NodeT* node);
+    /**
+     * @brief Takes the result of the last evaluation of the interpreter and
+     * sets it as the current value.
+     */
+    void takeInterpreterResult();
+};
+}} // namespace jmespath::interpreter
+#endif // FROZENEVALUATOR_H
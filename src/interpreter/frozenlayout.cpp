@@ -0,0 +1,646 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "src/interpreter/frozenlayout.h"
+#include "src/interpreter/utf8counter.h"
+#include "jmespath/exceptions.h"
+#include <algorithm>
+#include <limits>
+
+namespace jmespath { namespace interpreter {
+
+constexpr char FrozenLayout::magic[8];
+constexpr std::uint32_t FrozenLayout::byteOrderMark;
+constexpr std::uint32_t FrozenLayout::version;
+constexpr std::uint8_t FrozenLayout::asciiFlag;
+constexpr std::uint32_t FrozenLayout::maxDepth;
+
+namespace {
+/**
+ * @brief Returns the size of a table with @a count number of @a itemSize
+ * sized items, rounded up to a multiple of 8 bytes.
+ * @param[in] count The number of items.
+ * @param[in] itemSize The size of the items.
+ * @return The size of the table in bytes.
+ */
+std::uint64_t tableSize(std::uint64_t count, std::uint64_t itemSize)
+{
+    return (count * itemSize + 7) / 8 * 8;
+}
+
+/**
+ * @brief Checks whether the range of @a length items starting at @a offset
+ * is inside a table with @a count items, without overflowing.
+ * @param[in] offset The offset of the first item of the range.
+ * @param[in] length The number of items in the range.
+ * @param[in] count The number of items in the table.
+ * @return Returns true if the range is inside the table, otherwise false.
+ */
+bool isInTable(std::uint64_t offset, std::uint64_t length, std::uint64_t count)
+{
+    return offset <= count && length <= count - offset;
+}
+
+/**
+ * @brief Checks whether the key of the @a left member precedes the key of
+ * the @a right member, in the same order as the keys of Json objects.
+ * @param[in] strings The string pool of the layout.
+ * @param[in] left A member of an object.
+ * @param[in] right A member of an object.
+ * @return Returns true if the key of @a left is less than the key of
+ * @a right, otherwise false.
+ */
+bool isKeyLess(const char* strings,
+               const FrozenLayout::Member& left,
+               const FrozenLayout::Member& right)
+{
+    size_t length = std::min(left.keyLength, right.keyLength);
+    int result = std::char_traits<Char>::compare(strings + left.keyOffset,
+                                                 strings + right.keyOffset,
+                                                 length);
+    return result < 0 || (result == 0 && left.keyLength < right.keyLength);
+}
+
+/**
+ * @brief Throws a copy of the @a error as its dynamic type if it's one of the
+ * listed exception types, otherwise returns.
+ * @param[in] error An exception of nlohmann_json.
+ * @tparam ExceptionT The exception types to check in order.
+ */
+template <typename... ExceptionT>
+std::enable_if_t<sizeof...(ExceptionT) == 0>
+rethrowAs(const nlohmann::detail::exception&)
+{
+}
+template <typename ExceptionT, typename... RestT>
+void rethrowAs(const nlohmann::detail::exception& error)
+{
+    if (auto typedError = dynamic_cast<const ExceptionT*>(&error))
+    {
+        throw *typedError;
+    }
+    rethrowAs<RestT...>(error);
+}
+
+/**
+ * @brief Converts the @a count into the 32 bit fields of the layout.
+ * @param[in] count A number of values or a size.
+ * @return The @a count as a 32 bit unsigned integer.
+ * @throws InvalidValue If the @a count doesn't fit into 32 bits.
+ */
+std::uint32_t toFieldValue(std::uint64_t count)
+{
+    if (count > std::numeric_limits<std::uint32_t>::max())
+    {
+        BOOST_THROW_EXCEPTION(InvalidValue{});
+    }
+    return static_cast<std::uint32_t>(count);
+}
+} // anonymous namespace
+
+FrozenLayout::FrozenLayout(const unsigned char *buffer, size_t size)
+{
+    // check that the header is present and matches the current format
+    if (!buffer
+        || reinterpret_cast<std::uintptr_t>(buffer) % 8 != 0
+        || size < sizeof(Header))
+    {
+        BOOST_THROW_EXCEPTION(InvalidAgrument{});
+    }
+    const auto header = reinterpret_cast<const Header*>(buffer);
+    if (std::memcmp(header->magic, magic, sizeof(magic)) != 0
+        || header->byteOrderMark != byteOrderMark
+        || header->version != version
+        || header->entryCount == 0)
+    {
+        BOOST_THROW_EXCEPTION(InvalidAgrument{});
+    }
+    // check that the tables fit into the buffer, the counts are limited so
+    // the sizes of the tables can't overflow
+    const std::uint64_t maxCount = std::numeric_limits<std::uint32_t>::max();
+    if (header->entryCount > maxCount
+        || header->itemCount > maxCount
+        || header->memberCount > maxCount
+        || header->stringsSize > size)
+    {
+        BOOST_THROW_EXCEPTION(InvalidAgrument{});
+    }
+    std::uint64_t entriesOffset = sizeof(Header);
+    std::uint64_t itemsOffset = entriesOffset
+        + tableSize(header->entryCount, sizeof(Entry));
+    std::uint64_t membersOffset = itemsOffset
+        + tableSize(header->itemCount, sizeof(std::uint32_t));
+    std::uint64_t stringsOffset = membersOffset
+        + tableSize(header->memberCount, sizeof(Member));
+    if (stringsOffset + header->stringsSize > size)
+    {
+        BOOST_THROW_EXCEPTION(InvalidAgrument{});
+    }
+    m_header = header;
+    m_entries = reinterpret_cast<const Entry*>(buffer + entriesOffset);
+    m_items = reinterpret_cast<const std::uint32_t*>(buffer + itemsOffset);
+    m_members = reinterpret_cast<const Member*>(buffer + membersOffset);
+    m_strings = reinterpret_cast<const char*>(buffer + stringsOffset);
+}
+
+void FrozenLayout::validate() const
+{
+    const std::uint64_t entryCount = m_header->entryCount;
+    // the depth of every entry, children are always at least at depth 1, so
+    // entries at depth 0 don't belong to any container yet
+    std::vector<std::uint32_t> depths(entryCount, 0);
+    for (std::uint64_t index = 0; index < entryCount; ++index)
+    {
+        // the children are added after their containers in document order,
+        // so a child which precedes its container or which belongs to more
+        // than one container could only come from a corrupted buffer, and
+        // the depth of the container is known before its children are
+        // validated
+        auto validateChild = [&](std::uint32_t child) {
+            if (child <= index
+                || child >= entryCount
+                || depths[child] != 0
+                || depths[index] == maxDepth)
+            {
+                BOOST_THROW_EXCEPTION(InvalidAgrument{});
+            }
+            depths[child] = depths[index] + 1;
+        };
+        const Entry& value = m_entries[index];
+        // only string entries can have flags, and only the known ones
+        const std::uint8_t knownFlags = (value.type == Type::String)
+            ? asciiFlag : 0;
+        if (value.flags & ~knownFlags)
+        {
+            BOOST_THROW_EXCEPTION(InvalidAgrument{});
+        }
+        switch (value.type)
+        {
+        case Type::Null:
+        case Type::Boolean:
+        case Type::Integer:
+        case Type::Unsigned:
+        case Type::Float:
+            break;
+        case Type::String:
+            if (!isInTable(value.payload, value.size, m_header->stringsSize)
+                || ((value.flags & asciiFlag)
+                    && !isAscii(m_strings + value.payload, value.size)))
+            {
+                BOOST_THROW_EXCEPTION(InvalidAgrument{});
+            }
+            break;
+        case Type::Array:
+            if (!isInTable(value.payload, value.size, m_header->itemCount))
+            {
+                BOOST_THROW_EXCEPTION(InvalidAgrument{});
+            }
+            for (std::uint64_t i = 0; i < value.size; ++i)
+            {
+                validateChild(m_items[value.payload + i]);
+            }
+            break;
+        case Type::Object:
+            if (!isInTable(value.payload, value.size, m_header->memberCount))
+            {
+                BOOST_THROW_EXCEPTION(InvalidAgrument{});
+            }
+            for (std::uint64_t i = 0; i < value.size; ++i)
+            {
+                const Member& objectMember = m_members[value.payload + i];
+                // the keys must be strictly increasing for the binary
+                // search of find
+                if (!isInTable(objectMember.keyOffset,
+                               objectMember.keyLength,
+                               m_header->stringsSize)
+                    || (i > 0
+                        && !isKeyLess(m_strings,
+                                      m_members[value.payload + i - 1],
+                                      objectMember)))
+                {
+                    BOOST_THROW_EXCEPTION(InvalidAgrument{});
+                }
+                validateChild(objectMember.value);
+            }
+            break;
+        default:
+            BOOST_THROW_EXCEPTION(InvalidAgrument{});
+        }
+    }
+}
+
+bool FrozenLayout::find(std::uint32_t index,
+                        const String &key,
+                        std::uint32_t *value) const
+{
+    const Entry& object = m_entries[index];
+    const Member* first = m_members + object.payload;
+    const Member* last = first + object.size;
+    // the members are sorted by their keys in the same order as the keys
+    // of Json objects
+    auto compare = [this](const Member& member, const String& key) {
+        size_t length = std::min<size_t>(member.keyLength, key.size());
+        int result = std::char_traits<Char>::compare(
+            m_strings + member.keyOffset, key.data(), length);
+        return result < 0 || (result == 0 && member.keyLength < key.size());
+    };
+    const Member* it = std::lower_bound(first, last, key, compare);
+    if (it != last
+        && it->keyLength == key.size()
+        && std::char_traits<Char>::compare(m_strings + it->keyOffset,
+                                           key.data(), key.size()) == 0)
+    {
+        *value = it->value;
+        return true;
+    }
+    return false;
+}
+
+size_t FrozenLayout::codePointCount(std::uint32_t index) const
+{
+    const Entry& stringEntry = m_entries[index];
+    if (stringEntry.flags & asciiFlag)
+    {
+        return stringEntry.size;
+    }
+    return countCodePoints(m_strings + stringEntry.payload, stringEntry.size);
+}
+
+Json FrozenLayout::toJson(std::uint32_t index) const
+{
+    const Entry& value = m_entries[index];
+    switch (value.type)
+    {
+    case Type::Boolean:
+        return value.payload != 0;
+    case Type::Integer:
+        return static_cast<Json::number_integer_t>(value.payload);
+    case Type::Unsigned:
+        return static_cast<Json::number_unsigned_t>(value.payload);
+    case Type::Float:
+    {
+        Json::number_float_t number;
+        std::memcpy(&number, &value.payload, sizeof(number));
+        return number;
+    }
+    case Type::String:
+        return string(index);
+    case Type::Array:
+    {
+        Json result(Json::value_t::array);
+        auto& resultItems = result.get_ref<Json::array_t&>();
+        resultItems.reserve(value.size);
+        for (size_t i = 0; i < value.size; ++i)
+        {
+            resultItems.push_back(toJson(item(index, i)));
+        }
+        return result;
+    }
+    case Type::Object:
+    {
+        // the members are already sorted, so they can be appended to the end
+        // of the object
+        Json result(Json::value_t::object);
+        auto& resultItems = result.get_ref<Json::object_t&>();
+        for (size_t i = 0; i < value.size; ++i)
+        {
+            const Member& objectMember = member(index, i);
+            resultItems.emplace_hint(resultItems.end(),
+                                     key(objectMember),
+                                     toJson(objectMember.value));
+        }
+        return result;
+    }
+    default:
+        return {};
+    }
+}
+
+std::vector<std::uint64_t> FrozenLayoutBuilder::build(const Json &document)
+{
+    FrozenLayoutBuilder builder;
+    builder.add(document);
+    return builder.finish();
+}
+
+std::vector<std::uint64_t> FrozenLayoutBuilder::build(const String &text)
+{
+    FrozenLayoutBuilder builder;
+    Json::sax_parse(text, &builder);
+    return builder.finish();
+}
+
+std::vector<std::uint64_t> FrozenLayoutBuilder::build(
+    const std::uint8_t *data,
+    size_t size,
+    Json::input_format_t format)
+{
+    FrozenLayoutBuilder builder;
+    Json::sax_parse(data, data + size, &builder, format);
+    return builder.finish();
+}
+
+bool FrozenLayoutBuilder::null()
+{
+    addEntry(FrozenLayout::Type::Null, 0, 0);
+    return true;
+}
+
+bool FrozenLayoutBuilder::boolean(bool value)
+{
+    addEntry(FrozenLayout::Type::Boolean, 0, value ? 1 : 0);
+    return true;
+}
+
+bool FrozenLayoutBuilder::number_integer(Json::number_integer_t value)
+{
+    addEntry(FrozenLayout::Type::Integer, 0,
+             static_cast<std::uint64_t>(value));
+    return true;
+}
+
+bool FrozenLayoutBuilder::number_unsigned(Json::number_unsigned_t value)
+{
+    addEntry(FrozenLayout::Type::Unsigned, 0, value);
+    return true;
+}
+
+bool FrozenLayoutBuilder::number_float(Json::number_float_t value,
+                                       const String &)
+{
+    std::uint64_t payload;
+    std::memcpy(&payload, &value, sizeof(payload));
+    addEntry(FrozenLayout::Type::Float, 0, payload);
+    return true;
+}
+
+bool FrozenLayoutBuilder::string(String &value)
+{
+    addString(value);
+    return true;
+}
+
+bool FrozenLayoutBuilder::binary(std::vector<std::uint8_t> &)
+{
+    // binary values can't be represented in JSON, store them as null
+    return null();
+}
+
+bool FrozenLayoutBuilder::start_object(size_t)
+{
+    auto index = addEntry(FrozenLayout::Type::Object, 0, 0);
+    m_containers.push_back(Container{index, {}, {}});
+    return true;
+}
+
+bool FrozenLayoutBuilder::key(String &value)
+{
+    m_pendingKey.keyOffset = intern(value);
+    m_pendingKey.keyLength = toFieldValue(value.size());
+    return true;
+}
+
+bool FrozenLayoutBuilder::end_object()
+{
+    endContainer();
+    return true;
+}
+
+bool FrozenLayoutBuilder::start_array(size_t)
+{
+    auto index = addEntry(FrozenLayout::Type::Array, 0, 0);
+    m_containers.push_back(Container{index, {}, {}});
+    return true;
+}
+
+bool FrozenLayoutBuilder::end_array()
+{
+    endContainer();
+    return true;
+}
+
+bool FrozenLayoutBuilder::parse_error(size_t,
+                                      const String &,
+                                      const nlohmann::detail::exception &error)
+{
+    // report the error the same way as the DOM parser of nlohmann_json,
+    // without slicing it to the base exception type
+    rethrowAs<Json::parse_error,
+              Json::out_of_range,
+              Json::type_error,
+              Json::invalid_iterator,
+              Json::other_error>(error);
+    throw error;
+}
+
+void FrozenLayoutBuilder::add(const Json &value)
+{
+    switch (value.type())
+    {
+    case Json::value_t::boolean:
+        boolean(value.get<bool>());
+        break;
+    case Json::value_t::number_integer:
+        number_integer(value.get<Json::number_integer_t>());
+        break;
+    case Json::value_t::number_unsigned:
+        number_unsigned(value.get<Json::number_unsigned_t>());
+        break;
+    case Json::value_t::number_float:
+        number_float(value.get<Json::number_float_t>(), {});
+        break;
+    case Json::value_t::string:
+        addString(value.get_ref<const Json::string_t&>());
+        break;
+    case Json::value_t::array:
+        start_array(value.size());
+        for (const auto& item: value)
+        {
+            add(item);
+        }
+        endContainer();
+        break;
+    case Json::value_t::object:
+        start_object(value.size());
+        for (auto it = value.begin(); it != value.end(); ++it)
+        {
+            m_pendingKey.keyOffset = intern(it.key());
+            m_pendingKey.keyLength = toFieldValue(it.key().size());
+            add(it.value());
+        }
+        endContainer();
+        break;
+    default:
+        null();
+        break;
+    }
+}
+
+std::uint32_t FrozenLayoutBuilder::addEntry(FrozenLayout::Type type,
+                                            std::uint32_t size,
+                                            std::uint64_t payload)
+{
+    // the number of entries is limited like the sizes, so the index of the
+    // new entry fits into 32 bits too, and the depth is limited like in
+    // FrozenLayout::validate
+    toFieldValue(m_entries.size() + 1);
+    if (m_containers.size() > FrozenLayout::maxDepth)
+    {
+        BOOST_THROW_EXCEPTION(InvalidValue{});
+    }
+    auto index = static_cast<std::uint32_t>(m_entries.size());
+    FrozenLayout::Entry entry{};
+    entry.type = type;
+    entry.size = size;
+    entry.payload = payload;
+    m_entries.push_back(entry);
+    // register the entry as the child of the innermost container
+    if (!m_containers.empty())
+    {
+        Container& container = m_containers.back();
+        if (m_entries[container.index].type == FrozenLayout::Type::Object)
+        {
+            FrozenLayout::Member member = m_pendingKey;
+            member.value = index;
+            container.members.push_back(member);
+        }
+        else
+        {
+            container.items.push_back(index);
+        }
+    }
+    return index;
+}
+
+void FrozenLayoutBuilder::addString(const String &value)
+{
+    auto index = addEntry(FrozenLayout::Type::String,
+                          toFieldValue(value.size()),
+                          intern(value));
+    if (isAscii(value.data(), value.size()))
+    {
+        m_entries[index].flags |= FrozenLayout::asciiFlag;
+    }
+}
+
+std::uint64_t FrozenLayoutBuilder::intern(const String &value)
+{
+    auto it = m_stringOffsets.find(value);
+    if (it != m_stringOffsets.end())
+    {
+        return it->second;
+    }
+    std::uint64_t offset = m_strings.size();
+    m_strings.append(value);
+    m_stringOffsets.emplace(value, offset);
+    return offset;
+}
+
+void FrozenLayoutBuilder::endContainer()
+{
+    Container& container = m_containers.back();
+    FrozenLayout::Entry& entry = m_entries[container.index];
+    if (entry.type == FrozenLayout::Type::Object)
+    {
+        auto keyLess = [this](const FrozenLayout::Member& left,
+                              const FrozenLayout::Member& right) {
+            return m_strings.compare(left.keyOffset, left.keyLength,
+                                     m_strings,
+                                     right.keyOffset, right.keyLength) < 0;
+        };
+        // sort the members by their keys, and if a key occurs more than once
+        // keep only its last value like the DOM parser of nlohmann_json
+        auto& members = container.members;
+        std::stable_sort(members.begin(), members.end(), keyLess);
+        std::vector<FrozenLayout::Member> uniqueMembers;
+        uniqueMembers.reserve(members.size());
+        for (const auto& member: members)
+        {
+            if (!uniqueMembers.empty()
+                && !keyLess(uniqueMembers.back(), member))
+            {
+                uniqueMembers.back() = member;
+            }
+            else
+            {
+                uniqueMembers.push_back(member);
+            }
+        }
+        entry.size = toFieldValue(uniqueMembers.size());
+        entry.payload = m_members.size();
+        // the reader limits the number of members of the whole document too
+        toFieldValue(m_members.size() + uniqueMembers.size());
+        m_members.insert(m_members.end(),
+                         uniqueMembers.begin(),
+                         uniqueMembers.end());
+    }
+    else
+    {
+        entry.size = toFieldValue(container.items.size());
+        entry.payload = m_items.size();
+        // the reader limits the number of items of the whole document too
+        toFieldValue(m_items.size() + container.items.size());
+        m_items.insert(m_items.end(),
+                       container.items.begin(),
+                       container.items.end());
+    }
+    m_containers.pop_back();
+}
+
+std::vector<std::uint64_t> FrozenLayoutBuilder::finish() const
+{
+    FrozenLayout::Header header{};
+    std::memcpy(header.magic, FrozenLayout::magic, sizeof(header.magic));
+    header.byteOrderMark = FrozenLayout::byteOrderMark;
+    header.version = FrozenLayout::version;
+    header.entryCount = m_entries.size();
+    header.itemCount = m_items.size();
+    header.memberCount = m_members.size();
+    header.stringsSize = m_strings.size();
+    // copy the header and the tables into a buffer aligned to 8 bytes
+    std::uint64_t size = sizeof(header)
+        + tableSize(m_entries.size(), sizeof(FrozenLayout::Entry))
+        + tableSize(m_items.size(), sizeof(std::uint32_t))
+        + tableSize(m_members.size(), sizeof(FrozenLayout::Member))
+        + tableSize(m_strings.size(), sizeof(Char));
+    std::vector<std::uint64_t> buffer(size / 8);
+    auto bytes = reinterpret_cast<unsigned char*>(buffer.data());
+    std::memcpy(bytes, &header, sizeof(header));
+    bytes += sizeof(header);
+    std::memcpy(bytes, m_entries.data(),
+                m_entries.size() * sizeof(FrozenLayout::Entry));
+    bytes += tableSize(m_entries.size(), sizeof(FrozenLayout::Entry));
+    std::memcpy(bytes, m_items.data(),
+                m_items.size() * sizeof(std::uint32_t));
+    bytes += tableSize(m_items.size(), sizeof(std::uint32_t));
+    std::memcpy(bytes, m_members.data(),
+                m_members.size() * sizeof(FrozenLayout::Member));
+    bytes += tableSize(m_members.size(), sizeof(FrozenLayout::Member));
+    std::memcpy(bytes, m_strings.data(), m_strings.size());
+    return buffer;
+}
+}} // namespace jmespath::interpreter
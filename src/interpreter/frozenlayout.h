@@ -0,0 +1,408 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef FROZENLAYOUT_H
+#define FROZENLAYOUT_H
+#include "jmespath/types.h"
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace jmespath { namespace interpreter {
+
+/**
+ * @brief The FrozenLayout class provides access to the flat binary layout of
+ * an immutable JSON document.
+ *
+ * The layout is a single contiguous buffer which starts with a
+ * @ref FrozenLayout::Header followed by the tables of the document:
+ * - the entries of the values, one fixed size @ref FrozenLayout::Entry for
+ * every value in document order, with the root value as the first entry
+ * - the indices of the entries of the items of every array
+ * - the members of every object sorted by their keys
+ * - the string pool, which stores every distinct string and key only once
+ *
+ * Every reference inside the buffer is an offset or an index, so the buffer
+ * is position independent and can be copied, written to a file or mapped into
+ * memory without any changes.
+ * @note This class doesn't own the buffer, it must outlive the layout.
+ */
+class FrozenLayout
+{
+public:
+    /**
+     * @brief The types of the values stored in the layout.
+     */
+    enum class Type : std::uint8_t
+    {
+        Null,
+        Boolean,
+        Integer,
+        Unsigned,
+        Float,
+        String,
+        Array,
+        Object
+    };
+    /**
+     * @brief The Header struct describes the sizes of the tables in the
+     * buffer.
+     */
+    struct Header
+    {
+        /**
+         * @brief Identifies the format of the buffer.
+         */
+        char magic[8];
+        /**
+         * @brief Detects buffers created on a platform with a different byte
+         * order.
+         */
+        std::uint32_t byteOrderMark;
+        /**
+         * @brief The version of the format.
+         */
+        std::uint32_t version;
+        /**
+         * @brief The number of entries.
+         */
+        std::uint64_t entryCount;
+        /**
+         * @brief The number of array item indices.
+         */
+        std::uint64_t itemCount;
+        /**
+         * @brief The number of object members.
+         */
+        std::uint64_t memberCount;
+        /**
+         * @brief The size of the string pool in bytes.
+         */
+        std::uint64_t stringsSize;
+    };
+    /**
+     * @brief The Entry struct describes a single value.
+     *
+     * The @ref size is the length of strings and the number of items or
+     * members of arrays and objects. The @ref payload holds the value of
+     * booleans and numbers, the offset of strings in the string pool and the
+     * index of the first item or member of arrays and objects. The
+     * @ref flags describe the value further, like @ref asciiFlag.
+     */
+    struct Entry
+    {
+        Type type;
+        std::uint8_t flags;
+        std::uint8_t reserved[2];
+        std::uint32_t size;
+        std::uint64_t payload;
+    };
+    /**
+     * @brief The Member struct describes the key and the value of an object
+     * member.
+     */
+    struct Member
+    {
+        std::uint64_t keyOffset;
+        std::uint32_t keyLength;
+        std::uint32_t value;
+    };
+    /**
+     * @brief The expected value of @ref Header::magic.
+     */
+    static constexpr char magic[8] = {'J', 'M', 'E', 'S', 'F', 'R', 'Z', 0};
+    /**
+     * @brief The expected value of @ref Header::byteOrderMark.
+     */
+    static constexpr std::uint32_t byteOrderMark = 0x01020304;
+    /**
+     * @brief The current version of the format.
+     */
+    static constexpr std::uint32_t version = 1;
+    /**
+     * @brief Flag of the string entries which contain only ASCII
+     * characters, whose length is equal to the number of their code points.
+     */
+    static constexpr std::uint8_t asciiFlag = 0x01;
+    /**
+     * @brief The maximum nesting depth of the values, the root value is at
+     * depth 0.
+     */
+    static constexpr std::uint32_t maxDepth = 1000;
+
+    /**
+     * @brief Constructs a FrozenLayout object for the given @a buffer.
+     * @param[in] buffer The address of the buffer, it should be aligned to 8
+     * bytes.
+     * @param[in] size The size of the @a buffer in bytes.
+     * @throws InvalidAgrument If the header of the @a buffer isn't valid or
+     * the tables don't fit into the @a buffer.
+     * @note Only the header is validated, the entries are trusted unless
+     * @ref validate is called.
+     */
+    FrozenLayout(const unsigned char* buffer, size_t size);
+    /**
+     * @brief Validates every entry of the layout, so buffers which weren't
+     * created by @ref FrozenLayoutBuilder can be read safely.
+     *
+     * The strings, items and members referred by the entries must be inside
+     * their tables, and the children of every array and object must follow
+     * their container and belong to that container only, which rules out
+     * cycles, and the values can't be nested deeper than @ref maxDepth. The
+     * members of every object must be sorted by their keys without
+     * repeated keys, as @ref find expects. Only string entries can have
+     * flags, only the known ones, and strings flagged with @ref asciiFlag
+     * must contain only ASCII characters.
+     * @throws InvalidAgrument If any of the entries is invalid.
+     */
+    void validate() const;
+    /**
+     * @brief Returns the index of the root value, which is always the first
+     * entry.
+     * @return The index of the root value.
+     */
+    static constexpr std::uint32_t root()
+    {
+        return 0;
+    }
+    /**
+     * @brief Returns the entry of the value at @a index.
+     * @param[in] index The index of the value.
+     * @return Reference to the entry.
+     */
+    const Entry& entry(std::uint32_t index) const
+    {
+        return m_entries[index];
+    }
+    /**
+     * @brief Returns the index of the value of the item at @a position in the
+     * array at @a index.
+     * @param[in] index The index of an array.
+     * @param[in] position The position of the item in the array.
+     * @return The index of the item's value.
+     */
+    std::uint32_t item(std::uint32_t index, size_t position) const
+    {
+        return m_items[m_entries[index].payload + position];
+    }
+    /**
+     * @brief Returns the member at @a position in the object at @a index.
+     * @param[in] index The index of an object.
+     * @param[in] position The position of the member in the object.
+     * @return Reference to the member.
+     */
+    const Member& member(std::uint32_t index, size_t position) const
+    {
+        return m_members[m_entries[index].payload + position];
+    }
+    /**
+     * @brief Looks up the value of the member with the given @a key in the
+     * object at @a index with a binary search.
+     * @param[in] index The index of an object.
+     * @param[in] key The key of the member.
+     * @param[out] value The index of the member's value.
+     * @return Returns true if the object has such member, otherwise false.
+     */
+    bool find(std::uint32_t index,
+              const String& key,
+              std::uint32_t* value) const;
+    /**
+     * @brief Returns the string value at @a index.
+     * @param[in] index The index of a string.
+     * @return The value of the string.
+     */
+    String string(std::uint32_t index) const
+    {
+        const Entry& stringEntry = m_entries[index];
+        return String(m_strings + stringEntry.payload, stringEntry.size);
+    }
+    /**
+     * @brief Returns the number of code points in the string value at
+     * @a index without copying it.
+     * @param[in] index The index of a string.
+     * @return The length of the string in code points.
+     */
+    size_t codePointCount(std::uint32_t index) const;
+    /**
+     * @brief Returns the key of the @a member.
+     * @param[in] member A member of an object.
+     * @return The key of the member.
+     */
+    String key(const Member& member) const
+    {
+        return String(m_strings + member.keyOffset, member.keyLength);
+    }
+    /**
+     * @brief Converts the value at @a index and its descendants into a
+     * @ref Json value.
+     * @param[in] index The index of the value.
+     * @return The @ref Json value.
+     */
+    Json toJson(std::uint32_t index) const;
+
+private:
+    const Header* m_header;
+    const Entry* m_entries;
+    const std::uint32_t* m_items;
+    const Member* m_members;
+    const char* m_strings;
+};
+
+/**
+ * @brief The FrozenLayoutBuilder class creates the binary layout of JSON
+ * documents.
+ *
+ * Values can either be added as @ref Json values, or they can be added
+ * directly while parsing JSON text since the builder implements the
+ * interface of nlohmann_json's SAX parser. The counts and sizes stored in
+ * the layout are 32 bit values and the values can't be nested deeper than
+ * @ref FrozenLayout::maxDepth, documents which exceed them are rejected with
+ * @ref InvalidValue.
+ */
+class FrozenLayoutBuilder
+{
+public:
+    /**
+     * @brief Creates the layout of the @a document.
+     * @param[in] document A @ref Json value.
+     * @return The buffer containing the layout.
+     * @throws InvalidValue If the @a document is too large for the layout.
+     */
+    static std::vector<std::uint64_t> build(const Json& document);
+    /**
+     * @brief Creates the layout of the document described by the JSON
+     * @a text, without parsing it into a @ref Json value first.
+     * @param[in] text A JSON document.
+     * @return The buffer containing the layout.
+     * @throws nlohmann::json::parse_error If the @a text isn't valid JSON.
+     * @throws InvalidValue If the document is too large for the layout.
+     */
+    static std::vector<std::uint64_t> build(const String& text);
+    /**
+     * @brief Creates the layout of the document encoded in one of the
+     * binary formats supported by nlohmann_json, without decoding it into a
+     * @ref Json value first.
+     * @param[in] data The address of the encoded document.
+     * @param[in] size The size of the encoded document in bytes.
+     * @param[in] format The format of the encoded document.
+     * @return The buffer containing the layout.
+     * @throws nlohmann::json::parse_error If the @a data isn't a valid
+     * document in the given @a format.
+     * @throws InvalidValue If the document is too large for the layout.
+     */
+    static std::vector<std::uint64_t> build(const std::uint8_t* data,
+                                            size_t size,
+                                            Json::input_format_t format);
+
+    /**
+     * @brief Functions called by nlohmann_json's SAX parser.
+     * @{
+     */
+    bool null();
+    bool boolean(bool value);
+    bool number_integer(Json::number_integer_t value);
+    bool number_unsigned(Json::number_unsigned_t value);
+    bool number_float(Json::number_float_t value, const String&);
+    bool string(String& value);
+    bool binary(std::vector<std::uint8_t>&);
+    bool start_object(size_t);
+    bool key(String& value);
+    bool end_object();
+    bool start_array(size_t);
+    bool end_array();
+    bool parse_error(size_t, const String&,
+                     const nlohmann::detail::exception& error);
+    /** @}*/
+
+private:
+    /**
+     * @brief The Container struct holds the children of an array or object
+     * while they're being added.
+     */
+    struct Container
+    {
+        std::uint32_t index;
+        std::vector<std::uint32_t> items;
+        std::vector<FrozenLayout::Member> members;
+    };
+    std::vector<FrozenLayout::Entry> m_entries;
+    std::vector<std::uint32_t> m_items;
+    std::vector<FrozenLayout::Member> m_members;
+    String m_strings;
+    /**
+     * @brief Maps the strings in the string pool to their offset.
+     */
+    std::unordered_map<String, std::uint64_t> m_stringOffsets;
+    /**
+     * @brief The arrays and objects which are currently being added.
+     */
+    std::vector<Container> m_containers;
+    /**
+     * @brief The key of the next member of the innermost object.
+     */
+    FrozenLayout::Member m_pendingKey{};
+
+    /**
+     * @brief Adds the @a value and its descendants.
+     * @param[in] value A @ref Json value.
+     */
+    void add(const Json& value);
+    /**
+     * @brief Adds a new entry with the given @a type, @a size and
+     * @a payload, and registers it as a child of the innermost container.
+     * @return The index of the new entry.
+     */
+    std::uint32_t addEntry(FrozenLayout::Type type,
+                           std::uint32_t size,
+                           std::uint64_t payload);
+    /**
+     * @brief Adds a new string entry for the @a value, and flags it if it
+     * contains only ASCII characters.
+     * @param[in] value A string.
+     */
+    void addString(const String& value);
+    /**
+     * @brief Stores the @a value in the string pool if it's not already
+     * stored there.
+     * @param[in] value A string.
+     * @return The offset of the string in the pool.
+     */
+    std::uint64_t intern(const String& value);
+    /**
+     * @brief Finishes the innermost container by storing the list of its
+     * items or members.
+     */
+    void endContainer();
+    /**
+     * @brief Creates the buffer from the tables added so far.
+     * @return The buffer containing the layout.
+     */
+    std::vector<std::uint64_t> finish() const;
+};
+}} // namespace jmespath::interpreter
+#endif // FROZENLAYOUT_H
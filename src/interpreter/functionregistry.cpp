@@ -0,0 +1,62 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "src/interpreter/functionregistry.h"
+#include <mutex>
+
+namespace jmespath { namespace interpreter {
+
+FunctionRegistry &FunctionRegistry::instance()
+{
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wexit-time-destructors"
+    static FunctionRegistry s_registry;
+#pragma clang diagnostic pop
+    return s_registry;
+}
+
+void FunctionRegistry::add(
+    const String &name,
+    std::shared_ptr<const NativeFunctionDescriptor> descriptor)
+{
+    std::unique_lock<std::shared_timed_mutex> lock{m_mutex};
+    m_functions[name] = std::move(descriptor);
+    m_generation.fetch_add(1, std::memory_order_release);
+}
+
+std::shared_ptr<const NativeFunctionDescriptor> FunctionRegistry::find(
+    const String &name) const
+{
+    std::shared_lock<std::shared_timed_mutex> lock{m_mutex};
+    auto it = m_functions.find(name);
+    if (it == m_functions.cend())
+    {
+        return nullptr;
+    }
+    return it->second;
+}
+}} // namespace jmespath::interpreter
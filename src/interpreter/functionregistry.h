@@ -0,0 +1,123 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef FUNCTIONREGISTRY_H
+#define FUNCTIONREGISTRY_H
+#include "jmespath/types.h"
+#include "jmespath/nativefunction.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace jmespath { namespace interpreter {
+
+/**
+ * @brief The NativeFunctionDescriptor struct describes a registered native
+ * function.
+ */
+struct NativeFunctionDescriptor
+{
+    /**
+     * @brief The declared types of the arguments.
+     */
+    std::vector<ArgumentType> argumentTypes;
+    /**
+     * @brief True if the last argument can be repeated.
+     */
+    bool isVariadic;
+    /**
+     * @brief The implementation of the function.
+     */
+    NativeFunction function;
+};
+
+/**
+ * @brief The FunctionRegistry class stores the native functions registered
+ * by the users of the library.
+ *
+ * The registry is shared by every interpreter. The descriptors are never
+ * modified after they're registered, so once a descriptor is found, it can
+ * be used without holding the lock of the registry. Interpreters can cache
+ * the descriptors they found and check whether they're still current by
+ * comparing the @ref generation of the registry.
+ * @note This class is thread safe.
+ */
+class FunctionRegistry
+{
+public:
+    /**
+     * @brief Returns the registry shared by every interpreter.
+     * @return Reference to the registry.
+     */
+    static FunctionRegistry& instance();
+    /**
+     * @brief Adds the function described by the @a descriptor with the given
+     * @a name, replacing any previously registered function with the same
+     * name.
+     * @param[in] name The name of the function.
+     * @param[in] descriptor The descriptor of the function.
+     */
+    void add(const String& name,
+             std::shared_ptr<const NativeFunctionDescriptor> descriptor);
+    /**
+     * @brief Finds the function with the given @a name.
+     * @param[in] name The name of the function.
+     * @return The descriptor of the function, or `nullptr` if there's no
+     * function registered with the given @a name.
+     */
+    std::shared_ptr<const NativeFunctionDescriptor> find(
+        const String& name) const;
+    /**
+     * @brief Returns the number of times functions were added to the
+     * registry, which changes whenever the result of @ref find might change.
+     * @return The generation of the registry.
+     */
+    std::uint64_t generation() const
+    {
+        return m_generation.load(std::memory_order_acquire);
+    }
+
+private:
+    /**
+     * @brief Protects the map of functions.
+     */
+    mutable std::shared_timed_mutex m_mutex;
+    /**
+     * @brief Maps the names of the functions to their descriptors.
+     */
+    std::unordered_map<String,
+                       std::shared_ptr<const NativeFunctionDescriptor>>
+        m_functions;
+    /**
+     * @brief The number of times functions were added to the registry.
+     */
+    std::atomic<std::uint64_t> m_generation{0};
+};
+}} // namespace jmespath::interpreter
+#endif // FUNCTIONREGISTRY_H
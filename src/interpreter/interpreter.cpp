@@ -29,14 +29,19 @@
 #include "src/ast/allnodes.h"
 #include "jmespath/exceptions.h"
 #include "src/interpreter/contextvaluevisitoradaptor.h"
+#include "src/interpreter/extremevalue.h"
+#include "src/interpreter/substringsearcher.h"
+#include "src/interpreter/utf8counter.h"
+#include <cmath>
 #include <numeric>
+#include <limits>
 #include <boost/range.hpp>
 #include <boost/range/algorithm.hpp>
 #include <boost/range/numeric.hpp>
 #include <boost/algorithm/cxx11/any_of.hpp>
 #include <boost/algorithm/string.hpp>
-#include <boost/hana.hpp>
 #include <boost/type_index.hpp>
+#include <boost/utility/string_view.hpp>
 
 namespace jmespath { namespace interpreter {
 
@@ -45,9 +50,26 @@ namespace alg = boost::algorithm;
 
 Interpreter::Interpreter()
     : AbstractVisitor{}
+{
+}
+
+const Interpreter::FunctionMap &Interpreter::functionMap()
+{
+    // the table is created once on first use and isn't modified afterwards,
+    // so it can be shared by the interpreters of every thread
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wexit-time-destructors"
+    static const FunctionMap s_functionMap = makeFunctionMap();
+#pragma clang diagnostic pop
+    return s_functionMap;
+}
+
+Interpreter::FunctionMap Interpreter::makeFunctionMap()
 {
     // initialize JMESPath function name to function implementation mapping
     using std::placeholders::_1;
+    using std::placeholders::_2;
+    using std::placeholders::_3;
     using std::bind;
     using Descriptor = FunctionDescriptor;
     using FunctionType = void(Interpreter::*)(FunctionArgumentList&);
@@ -67,79 +89,80 @@ Interpreter::Interpreter()
     auto valuesPtr = static_cast<FunctionType>(&Interpreter::values);
     auto maxPtr = static_cast<MaxFunctionType>(&Interpreter::max);
     auto maxByPtr = static_cast<MaxFunctionType>(&Interpreter::maxBy);
-    m_functionMap = {
-        {"abs", Descriptor{exactlyOne, true,
-                           bind(&Interpreter::abs, this, _1)}},
-        {"avg",  Descriptor{exactlyOne, true,
-                            bind(&Interpreter::avg, this, _1)}},
-        {"contains", Descriptor{exactlyTwo, false,
-                                bind(&Interpreter::contains, this, _1)}},
-        {"ceil", Descriptor{exactlyOne, true,
-                            bind(&Interpreter::ceil, this, _1)}},
-        {"ends_with", Descriptor{exactlyTwo, false,
-                                 bind(&Interpreter::endsWith, this, _1)}},
-        {"floor", Descriptor{exactlyOne, true,
-                             bind(&Interpreter::floor, this, _1)}},
-        {"join", Descriptor{exactlyTwo, false,
-                            bind(&Interpreter::join, this, _1)}},
-        {"keys", Descriptor{exactlyOne, true,
-                            bind(&Interpreter::keys, this, _1)}},
-        {"length", Descriptor{exactlyOne, true,
-                              bind(&Interpreter::length, this, _1)}},
-        {"map", Descriptor{exactlyTwo, true,
-                           bind(mapPtr, this, _1)}},
-        {"max", Descriptor{exactlyOne, true,
-                           bind(maxPtr, this, _1, std::less<Json>{})}},
-        {"max_by", Descriptor{exactlyTwo, true,
-                              bind(maxByPtr, this, _1, std::less<Json>{})}},
-        {"merge", Descriptor{zeroOrMore, false,
-                             bind(&Interpreter::merge, this, _1)}},
-        {"min", Descriptor{exactlyOne, true,
-                           bind(maxPtr, this, _1, std::greater<Json>{})}},
-        {"min_by", Descriptor{exactlyTwo, true,
-                              bind(maxByPtr, this, _1, std::greater<Json>{})}},
-        {"not_null", Descriptor{oneOrMore, false,
-                                bind(&Interpreter::notNull, this, _1)}},
-        {"reverse", Descriptor{exactlyOne, true,
-                               bind(reversePtr, this, _1)}},
-        {"sort",  Descriptor{exactlyOne, true,
-                             bind(sortPtr, this, _1)}},
-        {"sort_by", Descriptor{exactlyTwo, true,
-                               bind(sortByPtr, this, _1)}},
-        {"starts_with", Descriptor{exactlyTwo, false,
-                                   bind(&Interpreter::startsWith, this, _1)}},
-        {"sum", Descriptor{exactlyOne, true,
-                           bind(&Interpreter::sum, this, _1)}},
-        {"to_array", Descriptor{exactlyOne, true,
-                                bind(toArrayPtr, this, _1)}},
-        {"to_string", Descriptor{exactlyOne, true,
-                                 bind(toStringPtr, this, _1)}},
-        {"to_number", Descriptor{exactlyOne, true,
-                                 bind(toNumberPtr, this, _1)}},
-        {"type", Descriptor{exactlyOne, true,
-                            bind(&Interpreter::type, this, _1)}},
-        {"values", Descriptor{exactlyOne, true,
-                              bind(valuesPtr, this, _1)}}
+    return {
+        {"abs", Descriptor{exactlyOne,
+                           bind(&Interpreter::abs, _1, _2)}},
+        {"avg",  Descriptor{exactlyOne,
+                            bind(&Interpreter::avg, _1, _2)}},
+        {"contains", Descriptor{exactlyTwo,
+                                bind(&Interpreter::contains, _1, _2)}},
+        {"ceil", Descriptor{exactlyOne,
+                            bind(&Interpreter::ceil, _1, _2)}},
+        {"ends_with", Descriptor{exactlyTwo,
+                                 bind(&Interpreter::endsWith, _1, _2)}},
+        {"floor", Descriptor{exactlyOne,
+                             bind(&Interpreter::floor, _1, _2)}},
+        {"join", Descriptor{exactlyTwo,
+                            bind(&Interpreter::join, _1, _2)}},
+        {"keys", Descriptor{exactlyOne,
+                            bind(&Interpreter::keys, _1, _2)}},
+        {"length", Descriptor{exactlyOne,
+                              bind(&Interpreter::length, _1, _2)}},
+        {"map", Descriptor{exactlyTwo,
+                           bind(mapPtr, _1, _2)}},
+        {"max", Descriptor{exactlyOne,
+                           bind(maxPtr, _1, _2, std::less<Json>{})}},
+        {"max_by", Descriptor{exactlyTwo,
+                              bind(maxByPtr, _1, _2, std::less<Json>{})}},
+        {"merge", Descriptor{zeroOrMore,
+                             bind(&Interpreter::merge, _1, _2)}},
+        {"min", Descriptor{exactlyOne,
+                           bind(maxPtr, _1, _2, std::greater<Json>{})}},
+        {"min_by", Descriptor{exactlyTwo,
+                              bind(maxByPtr, _1, _2, std::greater<Json>{})}},
+        {"not_null", Descriptor{oneOrMore, {},
+                                bind(&Interpreter::notNull, _1, _2, _3)}},
+        {"reverse", Descriptor{exactlyOne,
+                               bind(reversePtr, _1, _2)}},
+        {"sort",  Descriptor{exactlyOne,
+                             bind(sortPtr, _1, _2)}},
+        {"sort_by", Descriptor{exactlyTwo,
+                               bind(sortByPtr, _1, _2)}},
+        {"starts_with", Descriptor{exactlyTwo,
+                                   bind(&Interpreter::startsWith, _1, _2)}},
+        {"sum", Descriptor{exactlyOne,
+                           bind(&Interpreter::sum, _1, _2)}},
+        {"to_array", Descriptor{exactlyOne,
+                                bind(toArrayPtr, _1, _2)}},
+        {"to_string", Descriptor{exactlyOne,
+                                 bind(toStringPtr, _1, _2)}},
+        {"to_number", Descriptor{exactlyOne,
+                                 bind(toNumberPtr, _1, _2)}},
+        {"type", Descriptor{exactlyOne,
+                            bind(&Interpreter::type, _1, _2)}},
+        {"values", Descriptor{exactlyOne,
+                              bind(valuesPtr, _1, _2)}}
     };
 }
 
 void Interpreter::evaluateProjection(const ast::ExpressionNode *expression)
 {
-    using std::placeholders::_1;
     // move the current context into a temporary variable in case it holds
     // a value, since the context member variable will get overwritten during
     // the evaluation of the projection
     ContextValue contextValue {std::move(m_context)};
 
-    // project the expression with either an lvalue const ref or rvalue ref
-    // context
-    auto visitor = makeVisitor(
-        std::bind(&Interpreter::evaluateProjection<const Json&>,
-                  this, expression, _1),
-        std::bind(&Interpreter::evaluateProjection<Json&&>,
-                  this, expression, _1)
-    );
-    boost::apply_visitor(visitor, contextValue);
+    // project the expression with an rvalue ref context if the value is owned
+    // by the context, or with an lvalue const ref context otherwise, which
+    // stays valid while the temporary variable is alive
+    if (auto value = getOwnedJsonValue(contextValue))
+    {
+        evaluateProjection(expression, std::move(*value));
+    }
+    else
+    {
+        evaluateProjection(expression, getJsonValue(contextValue));
+    }
 }
 
 template <typename JsonT>
@@ -160,9 +183,17 @@ void Interpreter::evaluateProjection(const ast::ExpressionNode* expression,
             std::bind(static_cast<void(Json::*)(Json&&)>(&Json::push_back),
                       &result, _1)
         );
+        // look up the fields of the items from columns if possible
+        boost::optional<ColumnCursor> cursor;
+        makeColumnCursor(&cursor, context);
+        size_t index = 0;
         // iterate over the array
         for (auto& item: context)
         {
+            if (cursor)
+            {
+                cursor->setIndex(index++);
+            }
             // move the item into the context or create an lvalue reference
             // depending on the type of the context variable
             m_context = assignContextValue(std::move(item));
@@ -199,6 +230,21 @@ void Interpreter::visit(const ast::ExpressionNode *node)
 void Interpreter::visit(const ast::IdentifierNode *node)
 {
     using std::placeholders::_1;
+    // look up the value from a column if the context is an item of a
+    // columnar array
+    const Json* columnValue = nullptr;
+    if (m_columnCursor && m_columnCursor->lookup(node, m_context, &columnValue))
+    {
+        if (columnValue)
+        {
+            m_context = assignContextValue(*columnValue);
+        }
+        else
+        {
+            m_context = {};
+        }
+        return;
+    }
     using LvalueType = void(Interpreter::*)(const ast::IdentifierNode*,
                                              const Json&);
     using RvalueType = void(Interpreter::*)(const ast::IdentifierNode*,
@@ -219,15 +265,16 @@ void Interpreter::visit(const ast::IdentifierNode *node, JsonT &&context)
     // evaluete the identifier if the context holds an object
     if (context.is_object())
     {
-        try
+        // look up the field without raising exceptions for missing fields,
+        // which are common in projections over sparse objects
+        auto it = context.find(node->identifier);
+        if (it != context.end())
         {
             // assign either a const reference of the result or move the result
             // into the context depending on the type of the context parameter
-            m_context = assignContextValue(std::move(
-                                                context.at(node->identifier)));
+            m_context = assignContextValue(std::move(*it));
             return;
         }
-        catch (const nlohmann::json::out_of_range&) {}
     }
     // otherwise evaluate to null
     m_context = {};
@@ -250,18 +297,37 @@ void Interpreter::visit(const ast::SubexpressionNode *node)
 
 void Interpreter::visit(const ast::IndexExpressionNode *node)
 {
+    // evaluate projections by streaming the items of the array through the
+    // bracket specifier and the right side expression
+    if (node->isProjection())
+    {
+        collectItems([&](const ItemSink& sink) {
+            return streamProjection(node, &node->leftExpression, sink);
+        }, std::numeric_limits<size_t>::max());
+        return;
+    }
     // evaluate the left side expression
     visit(&node->leftExpression);
+    // evaluate the bracket specifier on the result
+    evaluateRightSide(node);
+}
+
+void Interpreter::evaluateRightSide(const ast::IndexExpressionNode *node)
+{
+    // evaluate projections by streaming the items of the context through the
+    // bracket specifier and the right side expression
+    if (node->isProjection())
+    {
+        const ast::ExpressionNode currentExpression;
+        collectItems([&](const ItemSink& sink) {
+            return streamProjection(node, &currentExpression, sink);
+        }, std::numeric_limits<size_t>::max());
+    }
     // evaluate the index expression if the context holds an array
-    if (getJsonValue(m_context).is_array())
+    else if (getJsonValue(m_context).is_array())
     {
         // evaluate the bracket specifier
         visit(&node->bracketSpecifier);
-        // if the index expression also defines a projection then evaluate it
-        if (node->isProjection())
-        {
-            evaluateProjection(&node->rightExpression);
-        }
     }
     // otherwise evaluate to null
     else
@@ -397,33 +463,7 @@ void Interpreter::visit(const ast::SliceExpressionNode* node, JsonT&& context)
         Index startIndex = 0;
         Index stopIndex = 0;
         Index step = 1;
-        size_t length = context.size();
-
-        // verify the validity of slice indeces and normalize their values
-        if (node->step)
-        {
-            if (*node->step == 0)
-            {
-                BOOST_THROW_EXCEPTION(InvalidValue{});
-            }
-            step = *node->step;
-        }
-        if (!node->start)
-        {
-            startIndex = step < 0 ? length - 1: 0;
-        }
-        else
-        {
-            startIndex = adjustSliceEndpoint(length, *node->start, step);
-        }
-        if (!node->stop)
-        {
-            stopIndex = step < 0 ? -1 : Index{length};
-        }
-        else
-        {
-            stopIndex = adjustSliceEndpoint(length, *node->stop, step);
-        }
+        sliceBounds(node, context.size(), &startIndex, &stopIndex, &step);
 
         // create the array of results
         Json result(Json::value_t::array);
@@ -458,14 +498,20 @@ void Interpreter::visit(const ast::ListWildcardNode*)
 }
 
 void Interpreter::visit(const ast::HashWildcardNode *node)
+{
+    // evaluate the left side expression
+    visit(&node->leftExpression);
+    // evaluate the hash wildcard on the result
+    evaluateRightSide(node);
+}
+
+void Interpreter::evaluateRightSide(const ast::HashWildcardNode *node)
 {
     using std::placeholders::_1;
     using LvalueType = void(Interpreter::*)(const ast::HashWildcardNode*,
                                              const Json&);
     using RvalueType = void(Interpreter::*)(const ast::HashWildcardNode*,
                                              Json&&);
-    // evaluate the left side expression
-    visit(&node->leftExpression);
     auto visitor = makeVisitor(
         std::bind(static_cast<LvalueType>(&Interpreter::visit<const Json&>),
                   this, node, _1),
@@ -508,6 +554,8 @@ void Interpreter::visit(const ast::MultiselectListNode *node)
     {
         // create the array of results
         Json result(Json::value_t::array);
+        auto& resultItems = result.get_ref<Json::array_t&>();
+        resultItems.reserve(node->expressions.size());
         // move the current context into a temporary variable in case it holds
         // a value, since the context member variable will get overwritten
         // during  the evaluation of sub expressions
@@ -519,8 +567,9 @@ void Interpreter::visit(const ast::MultiselectListNode *node)
             m_context = assignContextValue(getJsonValue(contextValue));
             // evaluate the subexpression
             visit(&expression);
-            // copy the result of the subexpression into the list of results
-            result.push_back(getJsonValue(m_context));
+            // move the result of the subexpression into the list of results
+            // if it's owned by the context, or copy it otherwise
+            resultItems.push_back(takeJsonValue(std::move(m_context)));
         }
         // set the results of the projection
         m_context = std::move(result);
@@ -532,8 +581,9 @@ void Interpreter::visit(const ast::MultiselectHashNode *node)
     // evaluate the multiselect hash opration if the context doesn't holds null
     if (!getJsonValue(m_context).is_null())
     {
-        // create the array of results
+        // create the object of results
         Json result(Json::value_t::object);
+        auto& resultItems = result.get_ref<Json::object_t&>();
         // move the current context into a temporary variable in case it holds
         // a value, since the context member variable will get overwritten
         // during the evaluation of sub expressions
@@ -545,9 +595,10 @@ void Interpreter::visit(const ast::MultiselectHashNode *node)
             m_context = assignContextValue(getJsonValue(contextValue));
             // evaluate the subexpression
             visit(&keyValuePair.second);
-            // add a copy of the result of the sub expression as the value
-            // for the key of the subexpression
-            result[keyValuePair.first.identifier] = getJsonValue(m_context);
+            // add the result of the sub expression as the value for the key
+            // of the subexpression, moving it if it's owned by the context
+            assignObjectItem(resultItems, keyValuePair.first.identifier,
+                             takeJsonValue(std::move(m_context)));
         }
         // set the results of the projection
         m_context = std::move(result);
@@ -580,21 +631,13 @@ void Interpreter::visit(const ast::ComparatorExpressionNode *node)
     visit(&node->leftExpression);
     // move the left side results into a temporary variable
     ContextValue leftResultContext {std::move(m_context)};
-    // if the context of the comparator expression holds a value but the
-    // evaluation of the left side expression resulted in a const lvalue
-    // ref then make a copy of the result, to avoid referring to a value that
-    // can get potentially destroyed while evaluating the right side expression
-    auto visitor = boost::hana::overload(
-        [&leftResultContext](Json&, const JsonRef& leftResult) {
-            leftResultContext = leftResult.get();
-        },
-        [](auto, auto) {}
-    );
-    boost::apply_visitor(visitor, contextValue, leftResultContext);
     const Json& leftResult = getJsonValue(leftResultContext);
 
-    // set the context for the right side expression
-    m_context = std::move(contextValue);
+    // use a const lvalue reference as the context for the right side
+    // expression as well, so the context outlives the evaluation of the right
+    // side, and the left side result can keep referring into it without
+    // being copied
+    m_context = assignContextValue(getJsonValue(contextValue));
     // evaluate the right expression
     visit(&node->rightExpression);
     const Json& rightResult = getJsonValue(m_context);
@@ -673,15 +716,10 @@ void Interpreter::evaluateLogicOperator(
     {
         // if the context of the logic operator holds a value but the
         // evaluation of the left side expression resulted in a const lvalue
-        // ref then make a copy of the result, to avoid referring to a soon
-        // to be destroyed value
-        auto visitor = boost::hana::overload(
-            [this](Json&, const JsonRef& leftResult) {
-                m_context = leftResult.get();
-            },
-            [](auto, auto) {}
-        );
-        boost::apply_visitor(visitor, contextValue, m_context);
+        // ref then share the context with the result, to avoid referring to a
+        // soon to be destroyed value
+        m_context = detachResult(std::move(contextValue),
+                                 std::move(m_context));
     }
 }
 
@@ -693,8 +731,22 @@ void Interpreter::visit(const ast::ParenExpressionNode *node)
 
 void Interpreter::visit(const ast::PipeExpressionNode *node)
 {
-    // evaluate the left followed by the right expression
-    visit(&node->leftExpression);
+    // if the right expression only depends on the first few items of the
+    // array produced by the left expression, then stop the evaluation of the
+    // left expression once these items are available
+    auto limit = resultLimit(&node->rightExpression);
+    if (limit && isStreamable(&node->leftExpression))
+    {
+        collectItems([&](const ItemSink& sink) {
+            return streamArray(&node->leftExpression, sink);
+        }, *limit);
+    }
+    // otherwise evaluate the left expression in its entirety
+    else
+    {
+        visit(&node->leftExpression);
+    }
+    // evaluate the right expression on the result of the left expression
     visit(&node->rightExpression);
 }
 
@@ -732,13 +784,21 @@ void Interpreter::visit(const ast::FilterExpressionNode* node, JsonT&& context)
     {
         // create the array of results
         Json result(Json::value_t::array);
+        // look up the fields of the items from columns if possible
+        boost::optional<ColumnCursor> cursor;
+        makeColumnCursor(&cursor, context);
+        size_t index = 0;
         // move or copy every item the context array which satisfies the
         // filtering condition
         std::copy_if(std::make_move_iterator(std::begin(context)),
                      std::make_move_iterator(std::end(context)),
                      std::back_inserter(result),
-                     [this, &node](const Json& item)
+                     [this, &node, &cursor, &index](const Json& item)
         {
+            if (cursor)
+            {
+                cursor->setIndex(index++);
+            }
             // assign a const lvalue ref of the item to the context
             m_context = assignContextValue(item);
             // evaluate the filtering condition
@@ -759,45 +819,546 @@ void Interpreter::visit(const ast::FilterExpressionNode* node, JsonT&& context)
 
 void Interpreter::visit(const ast::FunctionExpressionNode *node)
 {
-    // throw an error if the function doesn't exists
-    auto it = m_functionMap.find(node->functionName);
-    if (it == m_functionMap.end())
+    // functions with a single JSON expression argument evaluate it on the
+    // current context, so the function receives the context's value
+    // without copying it
+    auto jsonArgumentCount = rng::count_if(node->arguments,
+                                           [](const auto& argument) {
+        return boost::get<ast::ExpressionNode>(&argument) != nullptr;
+    });
+    if (jsonArgumentCount <= 1)
     {
-        BOOST_THROW_EXCEPTION(UnknownFunction()
-                              << InfoFunctionName(node->functionName));
+        evaluateFunction(node, [&](size_t index) {
+            visit(&boost::get<ast::ExpressionNode>(node->arguments[index]));
+            return ContextValue{std::move(m_context)};
+        });
+        return;
     }
+    // otherwise evaluate every argument on the current context, which is
+    // moved into a temporary variable in case it holds a value
+    ContextValue contextValue{std::move(m_context)};
+    evaluateFunction(node, [&](size_t index) {
+        m_context = assignContextValue(getJsonValue(contextValue));
+        visit(&boost::get<ast::ExpressionNode>(node->arguments[index]));
+        return ContextValue{std::move(m_context)};
+    });
+    // share the temporary context with the result if it refers to it
+    m_context = detachResult(std::move(contextValue), std::move(m_context));
+}
 
+void Interpreter::visit(const ast::ExpressionArgumentNode *)
+{
+}
+
+void Interpreter::evaluateFunction(const ast::FunctionExpressionNode *node,
+                                   const ArgumentEvaluator &evaluateArgument)
+{
+    // call the native function with the given name if it's not a built in
+    // function, or throw an error if the function doesn't exists
+    const auto& functions = functionMap();
+    auto it = functions.find(node->functionName);
+    if (it == functions.end())
+    {
+        if (auto nativeFunction = cachedNativeFunction(node))
+        {
+            callNativeFunction(*nativeFunction, node, evaluateArgument);
+        }
+        else
+        {
+            // keep the descriptor alive during the call, even if it's not
+            // cached
+            auto descriptor = findNativeFunction(node);
+            callNativeFunction(*descriptor, node, evaluateArgument);
+        }
+        return;
+    }
     const auto& descriptor = it->second;
-    const auto& argumentArityValidator = std::get<0>(descriptor);
-    bool singleContextValueArgument = std::get<1>(descriptor);
-    const auto& function = std::get<2>(descriptor);
+    const auto& arguments = node->arguments;
     // validate that the function has been called with the appropriate
     // number of arguments
-    if (!argumentArityValidator(node->arguments.size()))
+    if (!descriptor.isArityValid(arguments.size()))
     {
         BOOST_THROW_EXCEPTION(InvalidFunctionArgumentArity());
     }
+    // functions which evaluate their arguments lazily receive the
+    // unevaluated arguments
+    if (descriptor.lazyFunction)
+    {
+        descriptor.lazyFunction(this, arguments, evaluateArgument);
+        return;
+    }
+    // evaluate the JSON expression arguments, while expression type
+    // arguments are passed to the function as they are
+    FunctionArgumentList argumentList;
+    argumentList.reserve(arguments.size());
+    for (size_t i = 0; i < arguments.size(); ++i)
+    {
+        if (boost::get<ast::ExpressionNode>(&arguments[i]))
+        {
+            argumentList.emplace_back(evaluateArgument(i));
+        }
+        else if (auto expression = boost::get<ast::ExpressionArgumentNode>(
+                     &arguments[i]))
+        {
+            argumentList.emplace_back(expression->expression);
+        }
+        else
+        {
+            argumentList.emplace_back();
+        }
+    }
+    // evaluate the function
+    descriptor.function(this, argumentList);
+}
 
-    // if the function needs more than a single ContextValue
-    // argument
-    std::shared_ptr<ContextValue> contextValue;
-    if (!singleContextValueArgument)
+const NativeFunctionDescriptor* Interpreter::cachedNativeFunction(
+    const ast::FunctionExpressionNode *node) const
+{
+    // the descriptor resolved earlier by the node is outdated if a function
+    // has been registered since then, or if the node has been replaced by
+    // another one at the same address
+    auto it = m_nativeFunctions.find(node);
+    if (it != m_nativeFunctions.end()
+        && it->second.generation == FunctionRegistry::instance().generation()
+        && it->second.functionName == node->functionName)
     {
-        // move the current context into a temporary variable in
-        // case it holds a value
-        contextValue = std::make_shared<ContextValue>(std::move(m_context));
+        return it->second.descriptor.get();
     }
+    return nullptr;
+}
 
-    // evaluate the functins arguments
-    FunctionArgumentList argumentList = evaluateArguments(
-        node->arguments,
-        contextValue);
-    // evaluate the function
-    function(argumentList);
+std::shared_ptr<const NativeFunctionDescriptor>
+Interpreter::findNativeFunction(const ast::FunctionExpressionNode *node)
+{
+    const auto& registry = FunctionRegistry::instance();
+    auto generation = registry.generation();
+    auto nativeFunction = registry.find(node->functionName);
+    if (!nativeFunction)
+    {
+        BOOST_THROW_EXCEPTION(UnknownFunction()
+                              << InfoFunctionName(node->functionName));
+    }
+    // dropping the cached entries only costs a lookup for the nodes which
+    // are still in use, but the descriptors of the native functions which
+    // are being called must stay cached until they return
+    const size_t maxCachedFunctions = 256;
+    if (m_nativeFunctions.size() >= maxCachedFunctions
+        && !m_nativeFunctions.count(node))
+    {
+        if (m_nativeCallDepth != 0)
+        {
+            return nativeFunction;
+        }
+        m_nativeFunctions.clear();
+    }
+    m_nativeFunctions[node] = NativeFunctionCacheEntry{node->functionName,
+                                                       generation,
+                                                       nativeFunction};
+    return nativeFunction;
 }
 
-void Interpreter::visit(const ast::ExpressionArgumentNode *)
+void Interpreter::callNativeFunction(
+    const NativeFunctionDescriptor &descriptor,
+    const ast::FunctionExpressionNode *node,
+    const ArgumentEvaluator &evaluateArgument)
+{
+    struct CallDepthGuard
+    {
+        size_t& depth;
+        ~CallDepthGuard()
+        {
+            --depth;
+        }
+    } guard{++m_nativeCallDepth};
+    const auto& arguments = node->arguments;
+    const auto& argumentTypes = descriptor.argumentTypes;
+    // validate that the function has been called with the declared number of
+    // arguments, the last argument of variadic functions can be omitted or
+    // repeated
+    bool isArityValid = descriptor.isVariadic
+        ? (arguments.size() + 1 >= argumentTypes.size())
+        : (arguments.size() == argumentTypes.size());
+    if (!isArityValid)
+    {
+        BOOST_THROW_EXCEPTION(InvalidFunctionArgumentArity());
+    }
+    // evaluate the arguments and validate their types, the values of the
+    // arguments are kept alive until the function returns
+    std::vector<ContextValue> values;
+    values.reserve(arguments.size());
+    for (size_t i = 0; i < arguments.size(); ++i)
+    {
+        if (!boost::get<ast::ExpressionNode>(&arguments[i]))
+        {
+            BOOST_THROW_EXCEPTION(InvalidFunctionArgumentType());
+        }
+        values.push_back(evaluateArgument(i));
+        auto type = argumentTypes[std::min(i, argumentTypes.size() - 1)];
+        const Json& value = getJsonValue(values.back());
+        bool isTypeValid = (type == ArgumentType::Any)
+            || (type == ArgumentType::Null && value.is_null())
+            || (type == ArgumentType::Boolean && value.is_boolean())
+            || (type == ArgumentType::Number && value.is_number())
+            || (type == ArgumentType::String && value.is_string())
+            || (type == ArgumentType::Array && value.is_array())
+            || (type == ArgumentType::Object && value.is_object());
+        if (!isTypeValid)
+        {
+            BOOST_THROW_EXCEPTION(InvalidFunctionArgumentType());
+        }
+    }
+    // pass references to the values of the document and to the temporary
+    // values, which can be moved by the function
+    std::vector<NativeArgument> nativeArguments;
+    nativeArguments.reserve(values.size());
+    for (auto& value: values)
+    {
+        if (auto ownedValue = getOwnedJsonValue(value))
+        {
+            nativeArguments.emplace_back(std::move(*ownedValue));
+        }
+        else
+        {
+            nativeArguments.emplace_back(getJsonValue(value));
+        }
+    }
+    m_context = descriptor.function(nativeArguments);
+}
+
+bool Interpreter::hasBuiltInFunction(const String &name)
+{
+    return functionMap().find(name) != functionMap().cend();
+}
+
+bool Interpreter::isStreamable(const ast::ExpressionNode *expression)
+{
+    // parenthesized expressions are streamable if their sub expression is
+    if (auto node = boost::get<ast::ParenExpressionNode>(&expression->value))
+    {
+        return isStreamable(&node->expression);
+    }
+    // projections are streamable
+    if (auto node = boost::get<ast::IndexExpressionNode>(&expression->value))
+    {
+        return node->isProjection();
+    }
+    // pipe expressions are streamable if they end in a projection
+    if (auto node = boost::get<ast::PipeExpressionNode>(&expression->value))
+    {
+        auto rightNode = boost::get<ast::IndexExpressionNode>(
+            &node->rightExpression.value);
+        return rightNode && rightNode->isProjection();
+    }
+    return false;
+}
+
+bool Interpreter::streamArray(const ast::ExpressionNode *expression,
+                              const ItemSink &sink)
+{
+    // stream the results of the sub expression of parenthesized expressions
+    if (auto node = boost::get<ast::ParenExpressionNode>(&expression->value))
+    {
+        return streamArray(&node->expression, sink);
+    }
+    // stream the results of the projection
+    if (auto node = boost::get<ast::IndexExpressionNode>(&expression->value))
+    {
+        return streamProjection(node, &node->leftExpression, sink);
+    }
+    // stream the results of the projection at the end of the pipe expression
+    auto node = boost::get<ast::PipeExpressionNode>(&expression->value);
+    auto rightNode = boost::get<ast::IndexExpressionNode>(
+        &node->rightExpression.value);
+    // the projection is applied directly on the result of the left expression
+    // if it doesn't have a left expression of its own, so the left
+    // expression can be streamed too
+    if (rightNode->leftExpression.isNull())
+    {
+        return streamProjection(rightNode, &node->leftExpression, sink);
+    }
+    // otherwise evaluate the left expression and project the right
+    visit(&node->leftExpression);
+    return streamProjection(rightNode, &rightNode->leftExpression, sink);
+}
+
+bool Interpreter::streamProjection(const ast::IndexExpressionNode *node,
+                                   const ast::ExpressionNode *source,
+                                   const ItemSink &sink)
 {
+    const auto& bracket = node->bracketSpecifier.value;
+    auto filter = boost::get<ast::FilterExpressionNode>(&bracket);
+    auto slice = boost::get<ast::SliceExpressionNode>(&bracket);
+    bool isFlatten = boost::get<ast::FlattenOperatorNode>(&bracket) != nullptr;
+
+    // evaluates the right side expression on an item
+    ItemSink projectionSink = [&](ContextValue&& item) {
+        return projectItem(node, std::move(item), sink);
+    };
+    // applies the bracket specifier on an item of the source array, slices
+    // are applied while iterating over the source array
+    ItemSink bracketSink = [&](ContextValue&& item) {
+        // skip the item if it doesn't satisfy the filtering condition
+        if (filter)
+        {
+            m_context = assignContextValue(getJsonValue(item));
+            visit(&filter->expression);
+            if (!toBoolean(getJsonValue(m_context)))
+            {
+                return true;
+            }
+        }
+        // project the items of the item if it's an array that should be
+        // flattened
+        else if (isFlatten && getJsonValue(item).is_array())
+        {
+            if (auto ownedItem = getOwnedJsonValue(item))
+            {
+                return streamItems(std::move(*ownedItem),
+                                   nullptr,
+                                   projectionSink);
+            }
+            return streamItems(getJsonValue(item), nullptr, projectionSink);
+        }
+        return projectItem(node, std::move(item), sink);
+    };
+
+    // if the source is streamable and the bracket specifier can be applied
+    // without knowing the length of the array, then stream the items of the
+    // source through the bracket specifier
+    if (isStreamable(source) && acceptsStreamedItems(node->bracketSpecifier))
+    {
+        if (!slice)
+        {
+            return streamArray(source, bracketSink);
+        }
+        // select the items of the slice by counting the items of the source
+        auto start = static_cast<size_t>(slice->start.value_or(0));
+        auto step = static_cast<size_t>(slice->step.value_or(1));
+        auto stop = slice->stop ? static_cast<size_t>(*slice->stop)
+                                : std::numeric_limits<size_t>::max();
+        size_t index = 0;
+        return streamArray(source, [&](ContextValue&& item) {
+            if (index >= stop)
+            {
+                return false;
+            }
+            bool isSelected = (index >= start)
+                && ((index - start) % step == 0);
+            ++index;
+            if (isSelected && !bracketSink(std::move(item)))
+            {
+                return false;
+            }
+            return index < stop;
+        });
+    }
+
+    // otherwise evaluate the source array
+    visit(source);
+    ContextValue sourceValue{std::move(m_context)};
+    if (!getJsonValue(sourceValue).is_array())
+    {
+        return false;
+    }
+    // and pass its items through the bracket specifier
+    if (auto ownedSource = getOwnedJsonValue(sourceValue))
+    {
+        streamItems(std::move(*ownedSource), slice, bracketSink);
+    }
+    else
+    {
+        streamItems(getJsonValue(sourceValue), slice, bracketSink);
+    }
+    return true;
+}
+
+template <typename JsonT>
+bool Interpreter::streamItems(JsonT&& array,
+                              const ast::SliceExpressionNode *slice,
+                              const ItemSink &sink)
+{
+    // look up the fields of the items from columns if possible
+    boost::optional<ColumnCursor> cursor;
+    makeColumnCursor(&cursor, array);
+    // pass the items selected by the slice
+    if (slice)
+    {
+        Index startIndex = 0;
+        Index stopIndex = 0;
+        Index step = 1;
+        sliceBounds(slice, array.size(), &startIndex, &stopIndex, &step);
+        for (auto i = startIndex;
+             step > 0 ? (i < stopIndex) : (i > stopIndex);
+             i += step)
+        {
+            // pass a const reference of the item or move it depending on
+            // the type of the array
+            size_t arrayIndex = static_cast<size_t>(i);
+            if (cursor)
+            {
+                cursor->setIndex(arrayIndex);
+            }
+            if (!sink(assignContextValue(std::move(array[arrayIndex]))))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    // or pass every item
+    size_t index = 0;
+    for (auto& item: array)
+    {
+        if (cursor)
+        {
+            cursor->setIndex(index++);
+        }
+        if (!sink(assignContextValue(std::move(item))))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Interpreter::projectItem(const ast::IndexExpressionNode *node,
+                              ContextValue &&item,
+                              const ItemSink &sink)
+{
+    // evaluate the right side expression on the item
+    m_context = std::move(item);
+    visit(&node->rightExpression);
+    // skip null results
+    if (getJsonValue(m_context).is_null())
+    {
+        return true;
+    }
+    // move the result out of the context before passing it to the sink, since
+    // the sink might evaluate further expressions
+    ContextValue result{std::move(m_context)};
+    return sink(std::move(result));
+}
+
+bool Interpreter::acceptsStreamedItems(
+    const ast::BracketSpecifierNode &bracket) const
+{
+    // slices can only be applied on streamed items if they don't refer to
+    // the end of the array
+    if (auto slice = boost::get<ast::SliceExpressionNode>(&bracket.value))
+    {
+        return (!slice->start || (*slice->start >= 0))
+            && (!slice->stop || (*slice->stop >= 0))
+            && (!slice->step || (*slice->step > 0));
+    }
+    return true;
+}
+
+template <typename ProducerT>
+void Interpreter::collectItems(ProducerT &&producer, size_t limit)
+{
+    // create the array of results
+    Json result(Json::value_t::array);
+    auto& resultItems = result.get_ref<Json::array_t&>();
+    // append a copy of the items if they're lvalue references or move them
+    // otherwise, until the limit is reached
+    bool isArray = producer([&](ContextValue&& item) {
+        resultItems.push_back(takeJsonValue(std::move(item)));
+        return resultItems.size() < limit;
+    });
+    // evaluate to the array of results or to null
+    if (isArray)
+    {
+        m_context = std::move(result);
+    }
+    else
+    {
+        m_context = {};
+    }
+}
+
+boost::optional<size_t> Interpreter::resultLimit(
+    const ast::ExpressionNode *expression)
+{
+    // the left side of subexpressions and pipe expressions is evaluated on the
+    // input and the right side on the result of the left side
+    if (auto node = boost::get<ast::SubexpressionNode>(&expression->value))
+    {
+        return resultLimit(&node->leftExpression);
+    }
+    if (auto node = boost::get<ast::PipeExpressionNode>(&expression->value))
+    {
+        return resultLimit(&node->leftExpression);
+    }
+    if (auto node = boost::get<ast::ParenExpressionNode>(&expression->value))
+    {
+        return resultLimit(&node->expression);
+    }
+    auto node = boost::get<ast::IndexExpressionNode>(&expression->value);
+    if (!node)
+    {
+        return {};
+    }
+    // the same applies to the left side of index expressions
+    if (!node->leftExpression.isNull())
+    {
+        return resultLimit(&node->leftExpression);
+    }
+    const auto& bracket = node->bracketSpecifier.value;
+    constexpr auto maxLimit = std::numeric_limits<size_t>::max();
+    // an array item expression depends only on the items up to its index
+    if (auto arrayItem = boost::get<ast::ArrayItemNode>(&bracket))
+    {
+        if ((arrayItem->index >= 0) && (arrayItem->index < maxLimit))
+        {
+            return static_cast<size_t>(arrayItem->index) + 1;
+        }
+    }
+    // and a slice with a positive step only depends on the items up to its
+    // stop index
+    else if (auto slice = boost::get<ast::SliceExpressionNode>(&bracket))
+    {
+        if (slice->stop && (*slice->stop > 0)
+            && (!slice->start || (*slice->start >= 0))
+            && (!slice->step || (*slice->step > 0)))
+        {
+            return static_cast<size_t>(*slice->stop);
+        }
+    }
+    return {};
+}
+
+void Interpreter::sliceBounds(const ast::SliceExpressionNode *node,
+                              size_t length,
+                              Index *start,
+                              Index *stop,
+                              Index *step) const
+{
+    *step = 1;
+    // verify the validity of slice indeces and normalize their values
+    if (node->step)
+    {
+        if (*node->step == 0)
+        {
+            BOOST_THROW_EXCEPTION(InvalidValue{});
+        }
+        *step = *node->step;
+    }
+    if (!node->start)
+    {
+        *start = *step < 0 ? length - 1: 0;
+    }
+    else
+    {
+        *start = adjustSliceEndpoint(length, *node->start, *step);
+    }
+    if (!node->stop)
+    {
+        *stop = *step < 0 ? -1 : Index{length};
+    }
+    else
+    {
+        *stop = adjustSliceEndpoint(length, *node->stop, *step);
+    }
 }
 
 Index Interpreter::adjustSliceEndpoint(size_t length,
@@ -828,48 +1389,6 @@ bool Interpreter::toBoolean(const Json &json) const
                 && !json.empty());
 }
 
-Interpreter::FunctionArgumentList
-Interpreter::evaluateArguments(
-    const FunctionExpressionArgumentList &arguments,
-    const std::shared_ptr<ContextValue>& contextValue)
-{
-    // create a list to hold the evaluated expression arguments
-    FunctionArgumentList argumentList;
-    // evaluate all the arguments and put the results into argumentList
-    rng::transform(arguments, std::back_inserter(argumentList),
-                   [&, this](const auto& argument)
-    {
-        // evaluate the current function argument
-        auto visitor = boost::hana::overload(
-            // evaluate expressions and return their results
-            [&, this](const ast::ExpressionNode& node) -> FunctionArgument {
-                if (contextValue)
-                {
-                    const Json& context = getJsonValue(*contextValue);
-                    // assign a const lvalue ref to the context
-                    m_context = assignContextValue(context);
-                }
-                // evaluate the expression
-                this->visit(&node);
-                // move the result
-                FunctionArgument result{std::move(m_context)};
-                return result;
-            },
-            // in case of expression argument nodes return the expression they
-            // hold so it can be evaluated inside a function
-            [](const ast::ExpressionArgumentNode& node) -> FunctionArgument {
-                return node.expression;
-            },
-            // ignore blank arguments
-            [](const boost::blank&) -> FunctionArgument {
-                return {};
-            }
-        );
-        return boost::apply_visitor(visitor, argument);
-    });
-    return argumentList;
-}
-
 template <typename T>
 T& Interpreter::getArgument(FunctionArgument& argument) const
 {
@@ -921,27 +1440,7 @@ void Interpreter::avg(FunctionArgumentList &arguments)
         if (!items.empty())
         {
             // calculate the sum of the array's items
-            double itemsSum = std::accumulate(items.cbegin(),
-                                              items.cend(),
-                                              0.0,
-                                              [](double sum,
-                                                 const Json& item) -> double
-            {
-                // add the value held by the item to the sum
-                if (item.is_number_integer())
-                {
-                    return sum + item.get<Json::number_integer_t>();
-                }
-                else if (item.is_number_float())
-                {
-                    return sum + item.get<Json::number_float_t>();
-                }
-                // or throw an exception if the current item is not a number
-                else
-                {
-                    BOOST_THROW_EXCEPTION(InvalidFunctionArgumentType());
-                }
-            });
+            double itemsSum = sumOfNumbers(items);
             // the final result is the sum divided by the number of items
             m_context = itemsSum / items.size();
         }
@@ -984,7 +1483,7 @@ void Interpreter::contains(FunctionArgumentList &arguments)
         // try to find the given item as a substring in subject
         const String& stringSubject = subject.get_ref<const String&>();
         const String& stringItem = item.get_ref<const String&>();
-        result = boost::contains(stringSubject, stringItem);
+        result = containsSubstring(stringSubject, stringItem);
     }
     // set the result
     m_context = result;
@@ -1104,13 +1603,12 @@ void Interpreter::length(FunctionArgumentList &arguments)
     // if it's a string
     if (subject.is_string())
     {
-        // calculate the distance between the two unicode iterators
+        // count the code points of the string
         // (since the expected string encoding is UTF-8 the number of
         // items isn't equals to the number of code points)
         const String& stringSubject = subject.get_ref<const String&>();
-        auto begin = UnicodeIteratorAdaptor(std::begin(stringSubject));
-        auto end = UnicodeIteratorAdaptor(std::end(stringSubject));
-        m_context = std::distance(begin, end);
+        m_context = countCodePoints(stringSubject.data(),
+                                    stringSubject.size());
     }
     // otherwise get the size of the array or object
     else
@@ -1221,17 +1719,24 @@ void Interpreter::mergeObject(Json* object, JsonT&& sourceObject)
     }
 }
 
-void Interpreter::notNull(FunctionArgumentList &arguments)
+void Interpreter::notNull(const FunctionExpressionArgumentList &arguments,
+                          const ArgumentEvaluator &evaluateArgument)
 {
-    // iterate over the arguments
-    for (auto& argument: arguments)
+    // only JSON expressions are accepted as arguments
+    bool hasInvalidArgument = alg::any_of(arguments, [](const auto& argument) {
+        return boost::get<ast::ExpressionNode>(&argument) == nullptr;
+    });
+    if (hasInvalidArgument)
+    {
+        BOOST_THROW_EXCEPTION(InvalidFunctionArgumentType());
+    }
+    // evaluate the arguments until a non null result is encountered
+    for (size_t i = 0; i < arguments.size(); ++i)
     {
-        // get the current argument
-        const Json& item = getJsonArgument(argument);
-        // if the current item is not null set it as the result
-        if (!item.is_null())
+        ContextValue result = evaluateArgument(i);
+        if (!getJsonValue(result).is_null())
         {
-            m_context = item;
+            m_context = std::move(result);
             return;
         }
     }
@@ -1307,24 +1812,24 @@ void Interpreter::sort(Json&& array)
 void Interpreter::sortBy(FunctionArgumentList &arguments)
 {
     using std::placeholders::_1;
-    using RvalueType = void(Interpreter::*)(const ast::ExpressionNode*,
-                                             Json&&);
     // get the first argument
     ContextValue& contextValue = getArgument<ContextValue>(arguments[0]);
     // get the second argument
     const ast::ExpressionNode& expression
             = getArgument<ast::ExpressionNode>(arguments[1]);
 
-    // create a visitor which will sort the argument if it's an rvalue
-    // or create a copy of it's argument and sort the copy
-    auto visitor = makeMoveOnlyVisitor(
-        std::bind(static_cast<RvalueType>(&Interpreter::sortBy),
-                  this, &expression, _1)
+    // evaluate the sort_by function with either const lvalue ref to the array
+    // or as an rvalue ref, the sort keys are evaluated on the original items
+    // and only the results are copied if it's an lvalue ref
+    auto visitor = makeVisitor(
+        std::bind(&Interpreter::sortBy<const Json&>, this, &expression, _1),
+        std::bind(&Interpreter::sortBy<Json&&>, this, &expression, _1)
     );
     boost::apply_visitor(visitor, contextValue);
 }
 
-void Interpreter::sortBy(const ast::ExpressionNode* expression, Json&& array)
+template <typename JsonT>
+void Interpreter::sortBy(const ast::ExpressionNode* expression, JsonT&& array)
 {
     // throw an exception if the subject is not an array
     if (!array.is_array())
@@ -1332,15 +1837,21 @@ void Interpreter::sortBy(const ast::ExpressionNode* expression, Json&& array)
         BOOST_THROW_EXCEPTION(InvalidFunctionArgumentType());
     }
 
-    // create an object for calculating array item hashes
-    std::hash<Json> hasher;
-    // create a map for storing the results of the evaluated expression by
-    // the hash value of the item
-    std::unordered_map<size_t, Json> expressionResultsMap;
+    // create a vector for storing the results of the evaluated expression
+    // for every item
+    std::vector<ContextValue> expressionResults;
+    expressionResults.reserve(array.size());
     auto firstItemType = Json::value_t::discarded;
+    // look up the fields of the items from columns if possible
+    boost::optional<ColumnCursor> cursor;
+    makeColumnCursor(&cursor, array);
     // iterate over the items of the array
-    for (auto& item: array)
+    for (const auto& item: array)
     {
+        if (cursor)
+        {
+            cursor->setIndex(expressionResults.size());
+        }
         // visit the mapped expression with the item as the context
         m_context = assignContextValue(item);
         visit(expression);
@@ -1363,19 +1874,30 @@ void Interpreter::sortBy(const ast::ExpressionNode* expression, Json&& array)
             BOOST_THROW_EXCEPTION(InvalidFunctionArgumentType());
         }
         // store the result of the expression
-        expressionResultsMap[hasher(item)] = resultValue;
+        expressionResults.push_back(std::move(m_context));
     }
 
-    // sort the items of the array based on the results of the expression
+    // sort the indices of the items based on the results of the expression
     // evaluated on them
-    std::sort(std::begin(array), std::end(array),
-              [&](const auto& first, const auto& second) -> bool
+    std::vector<size_t> indices(expressionResults.size());
+    std::iota(std::begin(indices), std::end(indices), 0);
+    std::stable_sort(std::begin(indices), std::end(indices),
+                     [&](size_t first, size_t second) -> bool
     {
-        return (expressionResultsMap[hasher(first)]
-                < expressionResultsMap[hasher(second)]);
+        return (getJsonValue(expressionResults[first])
+                < getJsonValue(expressionResults[second]));
     });
+    // copy or move the items into the result in sorted order
+    Json result(Json::value_t::array);
+    auto& resultItems = result.get_ref<Json::array_t&>();
+    resultItems.reserve(indices.size());
+    for (size_t index: indices)
+    {
+        resultItems.push_back(std::move(
+            *(std::begin(array) + static_cast<std::ptrdiff_t>(index))));
+    }
     // set the result
-    m_context = std::move(array);
+    m_context = std::move(result);
 }
 
 void Interpreter::startsWith(FunctionArgumentList &arguments)
@@ -1403,25 +1925,7 @@ void Interpreter::sum(FunctionArgumentList &arguments)
     if (items.is_array())
     {
         // calculate the sum of the array's items
-        double itemsSum = std::accumulate(items.cbegin(),
-                                          items.cend(),
-                                          0.0,
-                                          [](double sum,
-                                             const Json& item) -> double
-        {
-            if (item.is_number_integer())
-            {
-                return sum + item.get<Json::number_integer_t>();
-            }
-            else if (item.is_number_float())
-            {
-                return sum + item.get<Json::number_float_t>();
-            }
-            else
-            {
-                BOOST_THROW_EXCEPTION(InvalidFunctionArgumentType());
-            }
-        });
+        double itemsSum = sumOfNumbers(items);
         // set the result
         m_context = itemsSum;
     }
@@ -1614,18 +2118,20 @@ void Interpreter::max(FunctionArgumentList &arguments,
 template <typename JsonT>
 void Interpreter::max(const JsonComparator* comparator, JsonT&& array)
 {
-    // throw an exception if the array is not homogenous
-    if (!isComparableArray(array))
+    // throw an exception if the argument is not an array
+    if (!array.is_array())
     {
         BOOST_THROW_EXCEPTION(InvalidFunctionArgumentType());
     }
 
-    // try to find the largest item in the array
-    auto it = rng::max_element(array, *comparator);
+    // try to find the largest item in the array, which also checks that
+    // the array is homogenous
+    auto index = largestItemIndex(array, *comparator);
     // if the item was found evaluate to that item
-    if (it != std::end(array))
+    if (index < array.size())
     {
-        m_context = assignContextValue(std::move(*it));
+        m_context = assignContextValue(std::move(*(std::begin(array)
+            + static_cast<std::ptrdiff_t>(index))));
     }
     // if the array was empty then evaluate to null
     else
@@ -1737,4 +2243,252 @@ bool Interpreter::isComparableArray(const Json &array) const
     }
     return result;
 }
+
+double Interpreter::sumOfNumbers(const Json &items) const
+{
+    double result = 0.0;
+    // add the items to the sum in their original order, unsigned values are
+    // converted to signed integers first just like Json::get would do it, so
+    // the result is identical to adding the items one by one
+    for (const Json& item: items.get_ref<const Json::array_t&>())
+    {
+        if (auto value = item.get_ptr<const Json::number_integer_t*>())
+        {
+            result += *value;
+        }
+        else if (auto value = item.get_ptr<const Json::number_unsigned_t*>())
+        {
+            result += static_cast<Json::number_integer_t>(*value);
+        }
+        else if (auto value = item.get_ptr<const Json::number_float_t*>())
+        {
+            result += *value;
+        }
+        // or throw an exception if the current item is not a number
+        else
+        {
+            BOOST_THROW_EXCEPTION(InvalidFunctionArgumentType());
+        }
+    }
+    return result;
+}
+
+size_t Interpreter::largestItemIndex(const Json &array,
+                                     const JsonComparator &comparator) const
+{
+    const Json::array_t& items = array.get_ref<const Json::array_t&>();
+    if (items.empty())
+    {
+        return items.size();
+    }
+    // the native values of the items can only be compared directly if the
+    // comparator is one of the builtin ones
+    bool isLess = comparator.target<std::less<Json>>() != nullptr;
+    bool isGreater = comparator.target<std::greater<Json>>() != nullptr;
+    if (!isLess && !isGreater)
+    {
+        // throw an exception if the array is not homogenous
+        if (!isComparableArray(array))
+        {
+            BOOST_THROW_EXCEPTION(InvalidFunctionArgumentType());
+        }
+    }
+    else
+    {
+        // find out the common representation of the items, and whether the
+        // array is homogenous in the same pass
+        constexpr auto maxInteger = static_cast<Json::number_unsigned_t>(
+            std::numeric_limits<Json::number_integer_t>::max());
+        bool hasInteger = false;
+        bool hasUnsigned = false;
+        bool hasLargeUnsigned = false;
+        bool hasFloat = false;
+        bool hasNan = false;
+        bool hasString = false;
+        bool hasOther = false;
+        for (const Json& item: items)
+        {
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wswitch-enum"
+            switch (item.type())
+            {
+            case Json::value_t::number_integer: hasInteger = true; break;
+            case Json::value_t::number_unsigned:
+                hasUnsigned = true;
+                hasLargeUnsigned = hasLargeUnsigned
+                    || (*item.get_ptr<const Json::number_unsigned_t*>()
+                        > maxInteger);
+                break;
+            case Json::value_t::number_float:
+                hasFloat = true;
+                hasNan = hasNan || std::isnan(
+                    *item.get_ptr<const Json::number_float_t*>());
+                break;
+            case Json::value_t::string: hasString = true; break;
+            default: hasOther = true;
+            }
+#pragma clang diagnostic pop
+        }
+        // throw an exception if the array is not homogenous
+        if (hasOther || (hasString && (hasInteger || hasUnsigned || hasFloat)))
+        {
+            BOOST_THROW_EXCEPTION(InvalidFunctionArgumentType());
+        }
+        // strings are compared lexicographically
+        if (hasString)
+        {
+            return extremeItemIndex(items, isGreater, [](const Json& item) {
+                return boost::string_view{item.get_ref<const String&>()};
+            });
+        }
+        // floats are only compared directly if there are no integers, since
+        // comparing two integers as floats could lose precision, and NaN
+        // values can only be handled by comparing them one by one
+        if (hasFloat && !hasInteger && !hasUnsigned && !hasNan)
+        {
+            return extremeNumberIndex(items, isGreater, [](const Json& item) {
+                return *item.get_ptr<const Json::number_float_t*>();
+            });
+        }
+        // unsigned values are compared to signed integers after converting
+        // them to signed integers, which is lossless as long as they fit
+        if (!hasFloat && !hasLargeUnsigned)
+        {
+            return extremeNumberIndex(items, isGreater, [](const Json& item) {
+                if (auto value = item.get_ptr<const Json::number_integer_t*>())
+                {
+                    return *value;
+                }
+                return static_cast<Json::number_integer_t>(
+                    *item.get_ptr<const Json::number_unsigned_t*>());
+            });
+        }
+        if (hasUnsigned && !hasInteger && !hasFloat)
+        {
+            return extremeItemIndex(items, isGreater, [](const Json& item) {
+                return *item.get_ptr<const Json::number_unsigned_t*>();
+            });
+        }
+        if (hasFloat && !hasInteger && !hasUnsigned)
+        {
+            return extremeItemIndex(items, isGreater, [](const Json& item) {
+                return *item.get_ptr<const Json::number_float_t*>();
+            });
+        }
+    }
+    // otherwise fall back to comparing the items as Json values
+    auto it = rng::max_element(items, comparator);
+    return static_cast<size_t>(std::distance(std::begin(items), it));
+}
+
+template <typename KeyFunctionT>
+size_t Interpreter::extremeItemIndex(const Json::array_t &items,
+                                     bool findSmallest,
+                                     KeyFunctionT &&keyFunction) const
+{
+    size_t result = 0;
+    auto extremeValue = keyFunction(items[0]);
+    for (size_t i = 1; i < items.size(); ++i)
+    {
+        auto value = keyFunction(items[i]);
+        // only replace the current extreme value if the item is strictly
+        // larger or smaller to find the first occurence like max_element
+        if (findSmallest ? (value < extremeValue) : (extremeValue < value))
+        {
+            extremeValue = value;
+            result = i;
+        }
+    }
+    return result;
+}
+
+template <typename KeyFunctionT>
+size_t Interpreter::extremeNumberIndex(const Json::array_t &items,
+                                       bool findSmallest,
+                                       KeyFunctionT &&keyFunction) const
+{
+    using Value = decltype(keyFunction(items[0]));
+    // the keys are copied into a contiguous buffer block by block, where
+    // their extreme value can be found with vector instructions
+    constexpr size_t blockSize = 256;
+    Value block[blockSize];
+    size_t result = 0;
+    Value extremeValue{};
+    for (size_t offset = 0; offset < items.size(); offset += blockSize)
+    {
+        const size_t size = std::min(blockSize, items.size() - offset);
+        for (size_t i = 0; i < size; ++i)
+        {
+            block[i] = keyFunction(items[offset + i]);
+        }
+        Value value = interpreter::extremeValue(block, size, findSmallest);
+        // only look for the position of the block's extreme value if it's
+        // strictly larger or smaller, to find the first occurence like
+        // max_element
+        if ((offset == 0) || (findSmallest ? (value < extremeValue)
+                                           : (extremeValue < value)))
+        {
+            extremeValue = value;
+            result = offset + static_cast<size_t>(
+                std::find(block, block + size, value) - block);
+        }
+    }
+    return result;
+}
+
+template <typename JsonT>
+void Interpreter::makeColumnCursor(boost::optional<ColumnCursor>* cursor,
+                                   JsonT&& array)
+{
+    // only the arrays of the document can have columns, which can only be
+    // referenced by lvalue refs
+    if (std::is_lvalue_reference<JsonT>::value
+        && m_columnCache
+        && m_columnCache->isColumnarArray(array))
+    {
+        cursor->emplace(this, array);
+    }
+}
+
+Interpreter::ColumnCursor::ColumnCursor(Interpreter *interpreter,
+                                        const Json &array)
+    : m_interpreter(interpreter),
+      m_previousCursor(interpreter->m_columnCursor),
+      m_array(&array)
+{
+    m_interpreter->m_columnCursor = this;
+}
+
+Interpreter::ColumnCursor::~ColumnCursor()
+{
+    m_interpreter->m_columnCursor = m_previousCursor;
+}
+
+bool Interpreter::ColumnCursor::lookup(const ast::IdentifierNode *node,
+                                       const ContextValue &context,
+                                       const Json **value)
+{
+    // the context must be a reference to the current item
+    const JsonRef* contextRef = boost::get<JsonRef>(&context);
+    if (!contextRef
+        || (&contextRef->get() != &(*m_array)[m_index]))
+    {
+        return false;
+    }
+    // find the column which was previously requested by the node
+    auto it = std::find_if(std::begin(m_columns), std::end(m_columns),
+                           [&](const auto& nodeColumn) {
+        return nodeColumn.first == node;
+    });
+    // or request it from the cache
+    if (it == std::end(m_columns))
+    {
+        auto column = m_interpreter->m_columnCache->column(*m_array,
+                                                           node->identifier);
+        it = m_columns.emplace(std::end(m_columns), node, column);
+    }
+    // look up the value from the column
+    *value = (*it->second)[m_index];
+    return true;
+}
 }} // namespace jmespath::interpreter
@@ -28,13 +28,17 @@
 #ifndef INTERPRETER_H
 #define INTERPRETER_H
 #include "src/interpreter/abstractvisitor.h"
+#include "src/interpreter/columncache.h"
+#include "src/interpreter/functionregistry.h"
 #include "jmespath/types.h"
 #include "src/ast/expressionnode.h"
 #include "src/ast/functionexpressionnode.h"
 #include <functional>
+#include <memory>
 #include <tuple>
 #include <unordered_map>
 #include <boost/variant.hpp>
+#include <boost/optional.hpp>
 
 namespace jmespath { namespace ast {
 
@@ -47,12 +51,32 @@ namespace jmespath { namespace interpreter {
  * @brief Copyable and assignable reference to a constant @ref Json value
  */
 using JsonRef = std::reference_wrapper<const Json>;
+/**
+ * @brief Shared reference to a constant @ref Json value, which keeps the
+ * value alive.
+ *
+ * It might refer to a value inside of a larger shared value, in which case it
+ * keeps the larger value alive. The shared values are always created as
+ * non-const objects by @ref makeSharedJson, so they can be moved from once
+ * they're no longer shared.
+ */
+using JsonPtr = std::shared_ptr<const Json>;
 /**
  * @brief Evaluation context type.
  *
- * It can hold either a @ref Json value or a @ref JsonRef.
+ * It can hold either a @ref Json value, a @ref JsonRef or a @ref JsonPtr.
  */
-using ContextValue = boost::variant<Json, JsonRef>;
+using ContextValue = boost::variant<Json, JsonRef, JsonPtr>;
+
+/**
+ * @brief Moves the given @a value into a new shared value.
+ * @param[in] value A @ref Json value.
+ * @return Returns a @ref JsonPtr which owns the moved @a value.
+ */
+inline JsonPtr makeSharedJson(Json&& value)
+{
+    return std::make_shared<Json>(std::move(value));
+}
 
 /**
  * @brief Convert the given @a value to something assignable to a @ref
@@ -82,9 +106,116 @@ inline JsonRef assignContextValue(const Json& value)
  */
 inline const Json& getJsonValue(const ContextValue& contextValue)
 {
-    return boost::apply_visitor([](const auto& value) -> const Json& {
+    if (auto value = boost::get<JsonPtr>(&contextValue))
+    {
+        return **value;
+    }
+    if (auto value = boost::get<JsonRef>(&contextValue))
+    {
+        return value->get();
+    }
+    return boost::get<Json>(contextValue);
+}
+
+/**
+ * @brief Get the @ref Json value held by the given @a contextValue if it's
+ * exclusively owned by the @a contextValue and can be moved from.
+ * @param[in] contextValue A @ref ContextValue variable.
+ * @return Returns a pointer to the @ref Json value if it's either held as a
+ * value or as a @ref JsonPtr which isn't shared with anything else, or nullptr
+ * otherwise.
+ */
+inline Json* getOwnedJsonValue(ContextValue& contextValue)
+{
+    if (auto value = boost::get<Json>(&contextValue))
+    {
         return value;
-    }, contextValue);
+    }
+    auto sharedValue = boost::get<JsonPtr>(&contextValue);
+    if (sharedValue && sharedValue->use_count() == 1)
+    {
+        // shared values are created by makeSharedJson as non-const objects
+        return const_cast<Json*>(sharedValue->get());
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Extract the @ref Json value held by the given @a contextValue,
+ * moving it if it's owned by the @a contextValue and copying it otherwise.
+ * @param[in] contextValue A @ref ContextValue variable.
+ * @return Returns the @ref Json value held by @a contextValue.
+ */
+inline Json takeJsonValue(ContextValue&& contextValue)
+{
+    if (auto value = getOwnedJsonValue(contextValue))
+    {
+        return std::move(*value);
+    }
+    return getJsonValue(contextValue);
+}
+
+/**
+ * @brief Makes the @a result of an evaluation on the given @a context
+ * independent of the lifetime of the @a context.
+ *
+ * If the @a context holds a value and the @a result refers to it or to one of
+ * its items, then instead of copying the referred value the @a context is
+ * moved into a shared value and the @a result is replaced with a
+ * @ref JsonPtr which refers to the same value and keeps the shared value
+ * alive. Moving a @ref Json value doesn't relocate its items, so the
+ * references to them remain valid.
+ * @param[in] context The context of the evaluation.
+ * @param[in] result The result of the evaluation.
+ * @return Returns the @a result which can outlive the @a context.
+ */
+inline ContextValue detachResult(ContextValue&& context,
+                                 ContextValue&& result)
+{
+    auto resultRef = boost::get<JsonRef>(&result);
+    if (!resultRef || boost::get<JsonRef>(&context))
+    {
+        return std::move(result);
+    }
+    const Json* resultValue = &resultRef->get();
+    JsonPtr owner;
+    if (auto value = boost::get<Json>(&context))
+    {
+        // if the result is the context itself then it can be moved
+        if (resultValue == value)
+        {
+            return std::move(*value);
+        }
+        owner = makeSharedJson(std::move(*value));
+    }
+    else
+    {
+        owner = std::move(boost::get<JsonPtr>(context));
+    }
+    return JsonPtr{std::move(owner), resultValue};
+}
+
+/**
+ * @brief Assigns the given @a value to the @a key in the @a object, replacing
+ * the previous value if the @a key is already present, without creating a
+ * default constructed value first.
+ * @param[in] object The object where the @a value should be inserted.
+ * @param[in] key The key of the @a value.
+ * @param[in] value The value to insert.
+ */
+inline void assignObjectItem(Json::object_t& object,
+                             const String& key,
+                             Json&& value)
+{
+    auto it = object.lower_bound(key);
+    if (it != object.end() && it->first == key)
+    {
+        it->second = std::move(value);
+    }
+    else
+    {
+        object.emplace_hint(it, key, std::move(value));
+    }
 }
 
 /**
@@ -108,6 +239,17 @@ public:
     setContext(JsonT&& value)
     {
         m_context = assignContextValue(std::forward<JsonT>(value));
+        m_columnCursor = nullptr;
+    }
+    /**
+     * @brief Sets the cache which should be used for looking up the fields
+     * of the objects in arrays while they're projected, filtered or sorted.
+     * @param[in] cache Pointer to the column cache of the document used as
+     * the context or `nullptr` if the fields should be looked up directly.
+     */
+    void setColumnCache(ColumnCache* cache)
+    {
+        m_columnCache = cache;
     }
     /**
      * @brief Returns the current evaluation context.
@@ -132,6 +274,64 @@ public:
      * @param[in] expression The expression that gets projected.
      */
     virtual void evaluateProjection(const ast::ExpressionNode* expression);
+    /**
+     * @brief Evaluates the bracket specifier and the right side expression of
+     * the index expression @a node, using the current context as the result
+     * of its left side expression.
+     * @param[in] node The index expression.
+     */
+    void evaluateRightSide(const ast::IndexExpressionNode* node);
+    /**
+     * @brief Evaluates the hash wildcard @a node and its right side
+     * expression, using the current context as the result of its left side
+     * expression.
+     * @param[in] node The hash wildcard expression.
+     */
+    void evaluateRightSide(const ast::HashWildcardNode* node);
+    /**
+     * @brief Function which returns the value of the JSON expression argument
+     * of a function call at the given index.
+     */
+    using ArgumentEvaluator = std::function<ContextValue(size_t)>;
+    /**
+     * @brief Evaluates the function call @a node and sets its result as the
+     * current context.
+     * @param[in] node The function expression.
+     * @param[in] evaluateArgument The function which evaluates the JSON
+     * expression arguments of the @a node. It's only called for the arguments
+     * that the function needs.
+     */
+    void evaluateFunction(const ast::FunctionExpressionNode* node,
+                          const ArgumentEvaluator& evaluateArgument);
+    /**
+     * @brief Calls the native function described by the @a descriptor for
+     * the function call @a node and sets its result as the current context.
+     * @param[in] descriptor The descriptor of the native function.
+     * @param[in] node The function expression.
+     * @param[in] evaluateArgument The function which evaluates the JSON
+     * expression arguments of the @a node.
+     * @throws InvalidFunctionArgumentArity If the number of arguments doesn't
+     * match the declaration of the function.
+     * @throws InvalidFunctionArgumentType If the type of an argument doesn't
+     * match the declaration of the function.
+     */
+    void callNativeFunction(const NativeFunctionDescriptor& descriptor,
+                            const ast::FunctionExpressionNode* node,
+                            const ArgumentEvaluator& evaluateArgument);
+    /**
+     * @brief Checks whether @a name is the name of a built in function.
+     * @param[in] name The name of a function.
+     * @return Returns true if @a name is the name of a built in function,
+     * otherwise returns false.
+     */
+    static bool hasBuiltInFunction(const String& name);
+    /**
+     * @brief Converts the @a json value to a boolean.
+     * @param[in] json The @ref Json value that needs to be converted.
+     * @return Returns false if @a json is a false like value (false, 0, empty
+     * list, empty object, empty string, null), otherwise returns true.
+     */
+    bool toBoolean(const Json& json) const;
 
     /**
      * @brief Evaluate the given @a node on the current context value.
@@ -166,6 +366,21 @@ public:
     /** @}*/
 
 private:
+    /**
+     * @brief The closures created by the compiler evaluate built in
+     * functions with the interpreter.
+     */
+    friend class ClosureCompiler;
+    /**
+     * @brief The evaluator of frozen documents uses the same rules of
+     * truthiness and slicing as the interpreter.
+     */
+    friend class FrozenEvaluator;
+    /**
+     * @brief The result writer streams the items of projections and the
+     * values of multiselect expressions into its output.
+     */
+    friend class ResultWriter;
     /**
      * @brief Type of the arguments in @ref FunctionArgumentList.
      */
@@ -177,43 +392,216 @@ private:
     using FunctionArgumentList = std::vector<FunctionArgument>;
     /**
      * @brief Function wrapper type to which JMESPath built in function
-     * implementations should conform to.
+     * implementations should conform to. The functions receive the
+     * interpreter which evaluates them as their first argument.
      */
-    using Function = std::function<void(FunctionArgumentList&)>;
+    using Function = std::function<void(Interpreter*, FunctionArgumentList&)>;
     /**
      * @brief The type of comparator functions used for comparing @ref Json
      * values.
      */
     using JsonComparator = std::function<bool(const Json&, const Json&)>;
     /**
-     * @brief Function argument arity validator predicate.
+     * @brief Function which receives the items of an array one by one while
+     * the array is being evaluated. It should return false if it doesn't need
+     * any more items.
      */
-    using ArgumentArityValidator = std::function<bool(const size_t&)>;
+    using ItemSink = std::function<bool(ContextValue&&)>;
     /**
-     * @brief Describes a built in function implementation.
-     *
-     * The tuple's first item is the comparator function used for comparing the
-     * actual number of arguments with the expected argument count, the second
-     * item marks whether the funciton needs a single @ref ContextValue or more,
-     * while the third item stores the callable functions wrapper.
+     * @brief Function argument arity validator predicate.
      */
-    using FunctionDescriptor = std::tuple<ArgumentArityValidator,
-                                          bool,
-                                          Function>;
+    using ArgumentArityValidator = std::function<bool(const size_t&)>;
     /**
      * @brief List of unevaluated function arguments.
      */
     using FunctionExpressionArgumentList
-        = std::vector<ast::FunctionExpressionNode::ArgumentType>;    
+        = std::vector<ast::FunctionExpressionNode::ArgumentType>;
     /**
-     * @brief Stores the evaluation context.
+     * @brief Function wrapper type of built in functions which receive their
+     * unevaluated arguments and evaluate only the ones they need.
      */
-    ContextValue m_context;
+    using LazyFunction = std::function<void(
+        Interpreter*,
+        const FunctionExpressionArgumentList&,
+        const ArgumentEvaluator&)>;
+    /**
+     * @brief The FunctionDescriptor struct describes a built in function
+     * implementation.
+     */
+    struct FunctionDescriptor
+    {
+        /**
+         * @brief Constructs a FunctionDescriptor object.
+         * @param[in] isArityValid The predicate which checks the number of
+         * arguments.
+         * @param[in] function The function wrapper.
+         * @param[in] lazyFunction The function wrapper of functions which
+         * evaluate their arguments lazily.
+         */
+        FunctionDescriptor(ArgumentArityValidator isArityValid,
+                           Function function,
+                           LazyFunction lazyFunction = {})
+            : isArityValid{std::move(isArityValid)},
+              function{std::move(function)},
+              lazyFunction{std::move(lazyFunction)}
+        {
+        }
+        /**
+         * @brief The predicate which checks the number of arguments of the
+         * function calls.
+         */
+        ArgumentArityValidator isArityValid;
+        /**
+         * @brief The callable function wrapper.
+         */
+        Function function;
+        /**
+         * @brief The callable function wrapper of functions which evaluate
+         * their arguments lazily, used instead of @ref function if it's set.
+         */
+        LazyFunction lazyFunction;
+    };
     /**
      * @brief Maps the JMESPath built in function names to their
      * implementations.
      */
-    std::unordered_map<String, FunctionDescriptor> m_functionMap;
+    using FunctionMap = std::unordered_map<String, FunctionDescriptor>;
+    /**
+     * @brief Stores the evaluation context.
+     */
+    ContextValue m_context;
+    /**
+     * @brief The ColumnCursor class tracks the item of an array of objects
+     * which is currently used as the evaluation context, so the fields of the
+     * item can be looked up from the columns of the array.
+     *
+     * The cursor makes itself the current cursor of the interpreter while
+     * it's alive, and restores the previous cursor when it's destroyed.
+     */
+    class ColumnCursor
+    {
+    public:
+        /**
+         * @brief Constructs a ColumnCursor object for the given @a array.
+         * @param[in] interpreter The interpreter which evaluates the items.
+         * @param[in] array A columnar @ref Json array.
+         */
+        ColumnCursor(Interpreter* interpreter, const Json& array);
+        /**
+         * @brief Destroys the cursor and restores the previous cursor of the
+         * interpreter.
+         */
+        ~ColumnCursor();
+        ColumnCursor(const ColumnCursor&) = delete;
+        ColumnCursor& operator= (const ColumnCursor&) = delete;
+        /**
+         * @brief Moves the cursor to the item of the array at @a index.
+         * @param[in] index The index of the item.
+         */
+        void setIndex(size_t index)
+        {
+            m_index = index;
+        }
+        /**
+         * @brief Looks up the value of the field described by @a node in the
+         * current item if the @a context refers to the current item.
+         * @param[in] node The identifier of the field.
+         * @param[in] context The current evaluation context.
+         * @param[out] value The address of the field's value or `nullptr` if
+         * the item doesn't has such field.
+         * @return Returns true if the field was looked up from a column,
+         * otherwise returns false.
+         */
+        bool lookup(const ast::IdentifierNode* node,
+                    const ContextValue& context,
+                    const Json** value);
+
+    private:
+        /**
+         * @brief The interpreter which evaluates the items.
+         */
+        Interpreter* m_interpreter;
+        /**
+         * @brief The previous cursor of the interpreter.
+         */
+        ColumnCursor* m_previousCursor;
+        /**
+         * @brief The array whose items are being evaluated.
+         */
+        const Json* m_array;
+        /**
+         * @brief The index of the current item.
+         */
+        size_t m_index{0};
+        /**
+         * @brief The columns of the array looked up so far by the identifier
+         * nodes which requested them.
+         */
+        std::vector<std::pair<const ast::IdentifierNode*,
+                              const ColumnCache::Column*>> m_columns;
+    };
+    /**
+     * @brief The cache of the columns of the context document or `nullptr`
+     * if the document isn't stored in columns.
+     */
+    ColumnCache* m_columnCache{nullptr};
+    /**
+     * @brief The cursor of the innermost array of objects which is currently
+     * evaluated or `nullptr` if there is no such array.
+     */
+    ColumnCursor* m_columnCursor{nullptr};
+    /**
+     * @brief The native function descriptor resolved for a function
+     * expression node.
+     */
+    struct NativeFunctionCacheEntry
+    {
+        /**
+         * @brief The name of the function when it was resolved.
+         */
+        String functionName;
+        /**
+         * @brief The generation of the function registry when the function
+         * was resolved.
+         */
+        std::uint64_t generation;
+        /**
+         * @brief The resolved descriptor.
+         */
+        std::shared_ptr<const NativeFunctionDescriptor> descriptor;
+    };
+    /**
+     * @brief The native function descriptors resolved so far by the function
+     * expression nodes which called them.
+     */
+    std::unordered_map<const ast::FunctionExpressionNode*,
+                       NativeFunctionCacheEntry> m_nativeFunctions;
+    /**
+     * @brief The number of native function calls in progress, the cached
+     * descriptors can only be dropped if there's none.
+     */
+    size_t m_nativeCallDepth{0};
+    /**
+     * @brief Returns the native function resolved earlier by the given
+     * @a node.
+     * @param[in] node The function expression node.
+     * @return Returns the descriptor of the native function, or `nullptr` if
+     * the @a node hasn't resolved it yet or a function has been registered
+     * since then.
+     */
+    const NativeFunctionDescriptor* cachedNativeFunction(
+        const ast::FunctionExpressionNode* node) const;
+    /**
+     * @brief Looks up the native function called by the given @a node in the
+     * registry and caches it for the subsequent calls of the @a node.
+     * @param[in] node The function expression node.
+     * @return Returns the descriptor of the native function, which might not
+     * be cached if the cache is full while native functions are called.
+     * @throws UnknownFunction If no function is registered under the name of
+     * the function.
+     */
+    std::shared_ptr<const NativeFunctionDescriptor> findNativeFunction(
+        const ast::FunctionExpressionNode* node);
     /**
      * @brief Evaluates the given @a node on the evaluation @a context.
      * @param[in] node Pointer to the node.
@@ -235,6 +623,115 @@ private:
     template <typename JsonT>
     void visit(const ast::FilterExpressionNode* node, JsonT&& context);
     /** @}*/
+    /**
+     * @brief Checks whether the array produced by the @a expression can be
+     * evaluated item by item with @ref streamArray.
+     * @param[in] expression The expression that should be tested.
+     * @return Returns true if @a expression is a projection or a pipe
+     * expression ending in a projection, otherwise returns false.
+     */
+    static bool isStreamable(const ast::ExpressionNode* expression);
+    /**
+     * @brief Evaluates the streamable @a expression on the current context
+     * and passes the items of the resulting array to the @a sink as soon as
+     * they're evaluated, without creating the array itself.
+     * @param[in] expression A streamable expression.
+     * @param[in] sink The function which receives the items.
+     * @return Returns true if the result of the @a expression is an array,
+     * or false if it's null.
+     */
+    bool streamArray(const ast::ExpressionNode* expression,
+                     const ItemSink& sink);
+    /**
+     * @brief Evaluates the projection @a node on the array produced by the
+     * @a source expression and passes the results of the projection to the
+     * @a sink.
+     *
+     * The items of the @a source array are passed through the bracket
+     * specifier of the @a node and the right side expression one by one
+     * without creating intermediate arrays, and if the @a source is
+     * streamable too then its items are not collected into an array either.
+     * The evaluation stops as soon as the @a sink returns false.
+     * @param[in] node The projected index expression.
+     * @param[in] source The expression which produces the array that should
+     * be projected.
+     * @param[in] sink The function which receives the results of the
+     * projection.
+     * @return Returns true if the result of the projection is an array, or
+     * false if it's null.
+     */
+    bool streamProjection(const ast::IndexExpressionNode* node,
+                          const ast::ExpressionNode* source,
+                          const ItemSink& sink);
+    /**
+     * @brief Passes the items of the @a array to the @a sink, or only the
+     * items selected by the @a slice if it's not `nullptr`.
+     * @param[in] array A @ref Json array.
+     * @param[in] slice The slice expression which selects the items or
+     * `nullptr`.
+     * @param[in] sink The function which receives the items.
+     * @tparam JsonT The type of the @a array.
+     * @return Returns false if the @a sink doesn't need any more items,
+     * otherwise returns true.
+     */
+    template <typename JsonT>
+    bool streamItems(JsonT&& array,
+                     const ast::SliceExpressionNode* slice,
+                     const ItemSink& sink);
+    /**
+     * @brief Evaluates the right side expression of the projection @a node on
+     * the @a item and passes the result to the @a sink if it's not null.
+     * @param[in] node The projected index expression.
+     * @param[in] item An item of the projected array.
+     * @param[in] sink The function which receives the result.
+     * @return Returns false if the @a sink doesn't need any more items,
+     * otherwise returns true.
+     */
+    bool projectItem(const ast::IndexExpressionNode* node,
+                     ContextValue&& item,
+                     const ItemSink& sink);
+    /**
+     * @brief Checks whether the @a bracket specifier can be applied on the
+     * items of an array without knowing the length of the array.
+     * @param[in] bracket The bracket specifier of a projection.
+     * @return Returns true if the items can be streamed through the @a
+     * bracket, otherwise returns false.
+     */
+    bool acceptsStreamedItems(const ast::BracketSpecifierNode& bracket) const;
+    /**
+     * @brief Collects the items passed to an @ref ItemSink by the
+     * @a producer into an array and sets it as the current context.
+     * @param[in] producer A function which receives a sink and passes it the
+     * items of an array. It should return false if the result is null.
+     * @param[in] limit The maximum number of items that should be collected.
+     * @tparam ProducerT The type of the @a producer.
+     */
+    template <typename ProducerT>
+    void collectItems(ProducerT&& producer, size_t limit);
+    /**
+     * @brief Calculates how many items from the beginning of its input array
+     * can affect the result of the @a expression.
+     * @param[in] expression The expression that should be examined.
+     * @return The number of items the result of the @a expression depends on,
+     * or none if it might depend on every item.
+     */
+    static boost::optional<size_t> resultLimit(
+        const ast::ExpressionNode* expression);
+    /**
+     * @brief Calculates the normalized start, stop and step values of the
+     * slice expression @a node for an array with the given @a length.
+     * @param[in] node The slice expression.
+     * @param[in] length The length of the array that should be sliced.
+     * @param[out] start The index of the first item of the slice.
+     * @param[out] stop The index where the slice ends.
+     * @param[out] step The slice's step value.
+     * @throws InvalidValue If the step value is zero.
+     */
+    void sliceBounds(const ast::SliceExpressionNode* node,
+                     size_t length,
+                     Index* start,
+                     Index* stop,
+                     Index* step) const;
     /**
      * @brief Adjust the value of the slice endpoint to make sure it's within
      * the array's bounds and points to the correct item.
@@ -246,13 +743,6 @@ private:
     Index adjustSliceEndpoint(size_t length,
                               Index endpoint,
                               Index step) const;
-    /**
-     * @brief Converts the @a json value to a boolean.
-     * @param[in] json The @ref Json value that needs to be converted.
-     * @return Returns false if @a json is a false like value (false, 0, empty
-     * list, empty object, empty string, null), otherwise returns true.
-     */
-    bool toBoolean(const Json& json) const;
     /**
      * @brief Evaluates the projection of the given @a expression with the
      * evaluation @a context.
@@ -276,19 +766,17 @@ private:
     void evaluateLogicOperator(const ast::BinaryExpressionNode* node,
                                bool shortCircuitValue);
     /**
-     * @brief Evaluate the given function expression @a arguments.
-     *
-     * Evalutate an @ref ast::ExpressionNode on the current context to a
-     * @ref Json value and evaluate @ref ast::ExpressionArgumentNode to its
-     * child @ref ast::ExpressionNode.
-     * @param[in] arguments List of arguments.
-     * @param[in] contextValue A context used for evaluating the arguments.
-     * @return List of evaluated function arguments, suitable for passing to
-     * built in functions.
-     */
-    FunctionArgumentList evaluateArguments(
-            const FunctionExpressionArgumentList& arguments,
-            const std::shared_ptr<ContextValue> &contextValue);
+     * @brief Returns the table of built in functions shared by every
+     * interpreter of the process.
+     * @return Reference to the immutable table of built in functions.
+     */
+    static const FunctionMap& functionMap();
+    /**
+     * @brief Creates the table of built in functions.
+     * @return The mapping of the built in function names to their
+     * implementations.
+     */
+    static FunctionMap makeFunctionMap();
     /**
      * @brief Converts the given function @a argument to the requsted type.
      * @param[in] argument A funciton argument value.
@@ -410,12 +898,16 @@ private:
     template <typename JsonT>
     void mergeObject(Json* object, JsonT&& sourceObject);
     /**
-     * @brief Accepts one or more items in @a arguments, and will evaluate them
-     * in order until a non null argument is encounted.
-     * @param[in] arguments The list of the function's arguments.
+     * @brief Evaluates the expressions in @a arguments in order until one of
+     * them evaluates to a non null value. The rest of the arguments are not
+     * evaluated.
+     * @param[in] arguments The list of the function's unevaluated arguments.
+     * @param[in] evaluateArgument The function which evaluates the
+     * arguments.
      * @throws InvalidFunctionArgumentType
      */
-    void notNull(FunctionArgumentList& arguments);
+    void notNull(const FunctionExpressionArgumentList& arguments,
+                 const ArgumentEvaluator& evaluateArgument);
     /**
      * @brief Reverses the order of the first item in @a arguments. It must
      * either be an array or a string.
@@ -458,9 +950,21 @@ private:
      * @param[in] expression The expression which evaluates to the key that
      * should be used for comparisons during sorting.
      * @param[in] array A @ref Json array of numbers or strings.
+     * @tparam JsonT The type of the @a array.
      * @throws InvalidFunctionArgumentType
      */
-    void sortBy(const ast::ExpressionNode* expression, Json&& array);
+    template <typename JsonT>
+    void sortBy(const ast::ExpressionNode* expression, JsonT&& array);
+    /**
+     * @brief Creates a column cursor for the @a array if its items can be
+     * looked up from columns.
+     * @param[out] cursor The cursor which should be initialized.
+     * @param[in] array A @ref Json array.
+     * @tparam JsonT The type of the @a array.
+     */
+    template <typename JsonT>
+    void makeColumnCursor(boost::optional<ColumnCursor>* cursor,
+                          JsonT&& array);
     /**
      * @brief Checks wheather the string provided as the first item in @a
      * arguments starts with the string provided as the second item in @a
@@ -605,6 +1109,73 @@ private:
      * returns false.
      */
     bool isComparableArray(const Json& array) const;
+    /**
+     * @brief Calculates the sum of the number items in @a items in a single
+     * pass, accumulating the values in the same order and with the same
+     * precision as the element-wise addition of @ref Json numbers would.
+     * @param[in] items A @ref Json array.
+     * @return The sum of the items.
+     * @throws InvalidFunctionArgumentType
+     */
+    double sumOfNumbers(const Json& items) const;
+    /**
+     * @brief Finds the index of the largest item in the @a array using the
+     * given @a comparator.
+     *
+     * If the @a comparator is one of the builtin @ref Json comparators and
+     * the items of @a array share a common number or string representation,
+     * then the items are compared by their native values without going
+     * through the type erased @a comparator.
+     * @param[in] array A @ref Json array.
+     * @param[in] comparator The comparator function used for comparing
+     * @ref Json values. It should return true if its first argument is less
+     * then its second argument.
+     * @return The index of the first occurence of the largest item, or the
+     * size of the @a array if it's empty.
+     * @throws InvalidFunctionArgumentType If the @a array is not a
+     * comparable array.
+     */
+    size_t largestItemIndex(const Json& array,
+                            const JsonComparator& comparator) const;
+    /**
+     * @brief Finds the index of the largest or smallest item in the non empty
+     * @a items by comparing the values returned by @a keyFunction for each
+     * item.
+     * @param[in] items A non empty array of @ref Json values.
+     * @param[in] findSmallest If true then the index of the smallest item is
+     * returned instead of the largest.
+     * @param[in] keyFunction Function which returns the native value of a
+     * @ref Json item.
+     * @tparam KeyFunctionT The type of @a keyFunction.
+     * @return The index of the first occurence of the largest or smallest
+     * item.
+     */
+    template <typename KeyFunctionT>
+    size_t extremeItemIndex(const Json::array_t& items,
+                            bool findSmallest,
+                            KeyFunctionT&& keyFunction) const;
+    /**
+     * @brief Finds the index of the largest or smallest item in the non empty
+     * @a items like @ref extremeItemIndex, for items whose native values are
+     * 64-bit integers or floating point numbers other than NaN.
+     *
+     * The native values are copied into a buffer in blocks, where their
+     * extreme value is found with vector instructions, and the items are
+     * only compared one by one in the blocks whose extreme value replaces
+     * the current one.
+     * @param[in] items A non empty array of @ref Json values.
+     * @param[in] findSmallest If true then the index of the smallest item is
+     * returned instead of the largest.
+     * @param[in] keyFunction Function which returns the native value of a
+     * @ref Json item as a Json::number_integer_t or a Json::number_float_t.
+     * @tparam KeyFunctionT The type of @a keyFunction.
+     * @return The index of the first occurence of the largest or smallest
+     * item.
+     */
+    template <typename KeyFunctionT>
+    size_t extremeNumberIndex(const Json::array_t& items,
+                              bool findSmallest,
+                              KeyFunctionT&& keyFunction) const;
 };
 }} // namespace jmespath::interpreter
 #endif // INTERPRETER_H
@@ -0,0 +1,108 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef JSONOUTPUT_H
+#define JSONOUTPUT_H
+#include "jmespath/types.h"
+#include <ostream>
+#include <utility>
+
+// nlohmann_json doesn't provide a public interface for serializing values
+// into custom outputs, so its internal serializer and output adapters are
+// used instead, which should only be referred to through this header
+#if !defined(NLOHMANN_JSON_VERSION_MAJOR) \
+    || NLOHMANN_JSON_VERSION_MAJOR != 3 \
+    || NLOHMANN_JSON_VERSION_MINOR < 8
+#error "nlohmann_json 3.8 or a later 3.x version is required"
+#endif
+
+namespace jmespath { namespace interpreter {
+
+/**
+ * @brief The interface of the outputs where JSON text can be written.
+ */
+using OutputAdapterProtocol = nlohmann::detail::output_adapter_protocol<Char>;
+/**
+ * @brief Type of the output where JSON text is written.
+ */
+using OutputAdapter = nlohmann::detail::output_adapter_t<Char>;
+
+/**
+ * @brief Creates an output which writes into the given @a stream.
+ * @param[in] stream The output stream.
+ * @return The output adapter.
+ */
+inline OutputAdapter makeOutputAdapter(std::basic_ostream<Char>& stream)
+{
+    return nlohmann::detail::output_adapter<Char>(stream);
+}
+
+/**
+ * @brief Creates an output which appends to the given @a string.
+ * @param[in] string The output string.
+ * @return The output adapter.
+ */
+inline OutputAdapter makeOutputAdapter(String& string)
+{
+    return nlohmann::detail::output_adapter<Char>(string);
+}
+
+/**
+ * @brief The JsonSerializer class writes @ref Json values into an
+ * @ref OutputAdapter in the same format as `Json::dump()`.
+ */
+class JsonSerializer
+{
+public:
+    /**
+     * @brief Constructs a JsonSerializer object.
+     * @param[in] output The output where the values are written.
+     */
+    explicit JsonSerializer(OutputAdapter output)
+        : m_serializer{std::move(output), ' ', Json::error_handler_t::strict}
+    {
+    }
+    /**
+     * @brief Writes the @a value into the output.
+     * @param[in] value A @ref Json value.
+     * @throws nlohmann::json::type_error If the @a value contains a string
+     * which isn't valid UTF-8.
+     */
+    void write(const Json& value)
+    {
+        // use the same format as Json::dump() with the default arguments
+        m_serializer.dump(value, false, false, 0);
+    }
+
+private:
+    /**
+     * @brief The serializer of nlohmann_json.
+     */
+    nlohmann::detail::serializer<Json> m_serializer;
+};
+}} // namespace jmespath::interpreter
+#endif // JSONOUTPUT_H
@@ -0,0 +1,196 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "src/interpreter/resultwriter.h"
+#include "src/ast/allnodes.h"
+#include <algorithm>
+
+namespace jmespath { namespace interpreter {
+
+CallbackOutputAdapter::CallbackOutputAdapter(Callback callback)
+    : m_callback{std::move(callback)}
+{
+    m_buffer.reserve(s_chunkSize);
+}
+
+void CallbackOutputAdapter::write_character(Char c)
+{
+    m_buffer.push_back(c);
+    if (m_buffer.size() >= s_chunkSize)
+    {
+        flush();
+    }
+}
+
+void CallbackOutputAdapter::write_characters(const Char *s, size_t length)
+{
+    m_buffer.append(s, length);
+    if (m_buffer.size() >= s_chunkSize)
+    {
+        flush();
+    }
+}
+
+void CallbackOutputAdapter::flush()
+{
+    if (!m_buffer.empty())
+    {
+        m_callback(m_buffer.data(), m_buffer.size());
+        m_buffer.clear();
+    }
+}
+
+ResultWriter::ResultWriter(Interpreter *interpreter, OutputAdapter output)
+    : m_interpreter{interpreter},
+      m_output{output},
+      m_serializer{std::move(output)}
+{
+}
+
+void ResultWriter::write(const ast::ExpressionNode *expression,
+                         const Json &document)
+{
+    m_interpreter->setContext(document);
+    writeExpression(expression);
+    // don't keep the reference to the document in the context of the
+    // interpreter
+    m_interpreter->setContext(Json{});
+}
+
+void ResultWriter::write(const Json &value)
+{
+    m_serializer.write(value);
+}
+
+void ResultWriter::writeExpression(const ast::ExpressionNode *expression)
+{
+    auto& context = m_interpreter->m_context;
+
+    // write the result of the sub expression of parenthesized expressions
+    if (auto node = boost::get<ast::ParenExpressionNode>(&expression->value))
+    {
+        writeExpression(&node->expression);
+    }
+    // write the items of projections as soon as they're evaluated
+    else if (Interpreter::isStreamable(expression))
+    {
+        size_t itemCount = 0;
+        bool isArray = m_interpreter->streamArray(
+            expression,
+            [&](ContextValue&& item) {
+                m_output->write_character(itemCount++ == 0 ? '[' : ',');
+                write(getJsonValue(item));
+                return true;
+            });
+        if (!isArray)
+        {
+            m_output->write_characters("null", 4);
+        }
+        else if (itemCount == 0)
+        {
+            m_output->write_characters("[]", 2);
+        }
+        else
+        {
+            m_output->write_character(']');
+        }
+    }
+    // write the results of the sub expressions of multiselect lists, unless
+    // the context is null, in which case the list evaluates to null
+    else if (boost::get<ast::MultiselectListNode>(&expression->value)
+             && !getJsonValue(context).is_null())
+    {
+        auto node = boost::get<ast::MultiselectListNode>(&expression->value);
+        // keep the current context alive while the sub expressions overwrite
+        // the context of the interpreter
+        ContextValue contextValue{std::move(context)};
+        m_output->write_character('[');
+        for (size_t i = 0; i < node->expressions.size(); ++i)
+        {
+            if (i > 0)
+            {
+                m_output->write_character(',');
+            }
+            context = assignContextValue(getJsonValue(contextValue));
+            writeExpression(&node->expressions[i]);
+        }
+        m_output->write_character(']');
+    }
+    else if (boost::get<ast::MultiselectHashNode>(&expression->value)
+             && !getJsonValue(context).is_null())
+    {
+        writeHash(boost::get<ast::MultiselectHashNode>(&expression->value));
+    }
+    // evaluate any other expression and write its result
+    else
+    {
+        m_interpreter->visit(expression);
+        write(getJsonValue(context));
+    }
+}
+
+void ResultWriter::writeHash(const ast::MultiselectHashNode *node)
+{
+    auto& context = m_interpreter->m_context;
+    const auto& expressions = node->expressions;
+
+    // the sub expressions can be written in the order of their declaration
+    // only if their keys are unique and they're in the order of the members
+    // of Json objects, otherwise evaluate the hash to find out which value
+    // is kept for repeated keys and which error is raised first
+    auto isUnordered = std::adjacent_find(
+        expressions.cbegin(),
+        expressions.cend(),
+        [](const auto& first, const auto& second) {
+            return !(first.first.identifier < second.first.identifier);
+        });
+    if (isUnordered != expressions.cend())
+    {
+        m_interpreter->visit(node);
+        write(getJsonValue(context));
+        return;
+    }
+
+    // keep the current context alive while the sub expressions overwrite
+    // the context of the interpreter
+    ContextValue contextValue{std::move(context)};
+    m_output->write_character('{');
+    for (size_t i = 0; i < expressions.size(); ++i)
+    {
+        if (i > 0)
+        {
+            m_output->write_character(',');
+        }
+        const auto& keyValuePair = expressions[i];
+        write(Json(keyValuePair.first.identifier));
+        m_output->write_character(':');
+        context = assignContextValue(getJsonValue(contextValue));
+        writeExpression(&keyValuePair.second);
+    }
+    m_output->write_character('}');
+}
+}} // namespace jmespath::interpreter
@@ -0,0 +1,154 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef RESULTWRITER_H
+#define RESULTWRITER_H
+#include "src/interpreter/interpreter.h"
+#include "src/interpreter/jsonoutput.h"
+#include "jmespath/types.h"
+#include <functional>
+
+namespace jmespath { namespace interpreter {
+
+/**
+ * @brief The CallbackOutputAdapter class passes the written characters to a
+ * callback function in chunks.
+ *
+ * Characters are collected in a buffer and passed to the callback when the
+ * buffer is full or when @ref flush is called.
+ */
+class CallbackOutputAdapter : public OutputAdapterProtocol
+{
+public:
+    /**
+     * @brief Type of the function which receives the written characters.
+     */
+    using Callback = std::function<void(const Char*, size_t)>;
+
+    /**
+     * @brief Constructs a CallbackOutputAdapter object.
+     * @param[in] callback The function which receives the written characters.
+     */
+    explicit CallbackOutputAdapter(Callback callback);
+    /**
+     * @brief Writes the character @a c into the buffer.
+     * @param[in] c A character.
+     */
+    void write_character(Char c) override;
+    /**
+     * @brief Writes the first @a length characters of @a s into the buffer.
+     * @param[in] s The address of the characters.
+     * @param[in] length The number of characters.
+     */
+    void write_characters(const Char* s, size_t length) override;
+    /**
+     * @brief Passes the characters in the buffer to the callback.
+     */
+    void flush();
+
+private:
+    /**
+     * @brief The size of the chunks passed to the callback.
+     */
+    static constexpr size_t s_chunkSize = 4096;
+    /**
+     * @brief The function which receives the written characters.
+     */
+    Callback m_callback;
+    /**
+     * @brief The characters which weren't passed to the callback yet.
+     */
+    String m_buffer;
+};
+
+/**
+ * @brief The ResultWriter class writes the result of an expression in JSON
+ * format while it's evaluated by the interpreter.
+ *
+ * The results of projections and the values of multiselect lists and hashes
+ * are serialized as soon as they're evaluated, and results which refer to
+ * the values of the searched document are serialized directly from the
+ * document, so the result is never created as a @ref Json value. The output
+ * is the same as the output of `Json::dump()` called on the result.
+ */
+class ResultWriter
+{
+public:
+    /**
+     * @brief Constructs a ResultWriter object.
+     * @param[in] interpreter The interpreter used for evaluating expressions.
+     * @param[in] output The output where the results are written.
+     */
+    ResultWriter(Interpreter* interpreter, OutputAdapter output);
+    /**
+     * @brief Evaluates the @a expression on the @a document and writes its
+     * result into the output.
+     * @param[in] expression The root of the AST.
+     * @param[in] document The searched document.
+     */
+    void write(const ast::ExpressionNode* expression, const Json& document);
+    /**
+     * @brief Writes the @a value into the output.
+     * @param[in] value A @ref Json value.
+     */
+    void write(const Json& value);
+
+private:
+    /**
+     * @brief The interpreter used for evaluating expressions.
+     */
+    Interpreter* m_interpreter;
+    /**
+     * @brief The output where the results are written.
+     */
+    OutputAdapter m_output;
+    /**
+     * @brief The serializer of @ref Json values.
+     */
+    JsonSerializer m_serializer;
+
+    /**
+     * @brief Evaluates the @a expression on the current context of the
+     * interpreter and writes its result into the output.
+     * @param[in] expression The evaluated expression.
+     */
+    void writeExpression(const ast::ExpressionNode* expression);
+    /**
+     * @brief Evaluates the multiselect hash @a node on the current context of
+     * the interpreter and writes its result into the output.
+     *
+     * The values are written as soon as they're evaluated if the keys are
+     * unique and they're declared in the order of the keys of @ref Json
+     * objects. Otherwise the hash is evaluated into a @ref Json object
+     * first, so the handling of repeated keys and the order of the
+     * evaluation of the sub expressions is the same as in @ref search.
+     * @param[in] node The multiselect hash expression.
+     */
+    void writeHash(const ast::MultiselectHashNode* node);
+};
+}} // namespace jmespath::interpreter
+#endif // RESULTWRITER_H
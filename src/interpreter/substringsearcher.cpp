@@ -0,0 +1,190 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "src/interpreter/substringsearcher.h"
+#include <cstring>
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JMESPATH_SUBSTRING_SEARCH_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace jmespath { namespace interpreter {
+
+namespace {
+/**
+ * @brief Checks whether the @a needle occurs in the @a haystack by
+ * comparing every occurrence of the first byte of the @a needle.
+ * @param[in] haystack The searched characters.
+ * @param[in] haystackSize The number of searched characters.
+ * @param[in] needle The characters that should be found.
+ * @param[in] needleSize The number of characters in the @a needle, which
+ * should be at least 1 and at most @a haystackSize.
+ * @return Returns true if the @a needle is found, otherwise returns false.
+ */
+bool scalarContains(const char* haystack, size_t haystackSize,
+                    const char* needle, size_t needleSize)
+{
+    const char* last = haystack + (haystackSize - needleSize);
+    const char* position = haystack;
+    while (position <= last)
+    {
+        position = static_cast<const char*>(
+            std::memchr(position, needle[0], last - position + 1));
+        if (!position)
+        {
+            return false;
+        }
+        if (std::memcmp(position + 1, needle + 1, needleSize - 1) == 0)
+        {
+            return true;
+        }
+        ++position;
+    }
+    return false;
+}
+
+#ifdef JMESPATH_SUBSTRING_SEARCH_SSE2
+/**
+ * @brief Returns the index of the lowest set bit of the non zero @a mask.
+ */
+inline unsigned lowestBitIndex(unsigned mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+/**
+ * @brief Checks whether the @a needle occurs in the @a haystack by
+ * filtering the candidate positions 16 at a time on the first and last
+ * bytes of the @a needle.
+ * @param[in] haystack The searched characters.
+ * @param[in] haystackSize The number of searched characters.
+ * @param[in] needle The characters that should be found.
+ * @param[in] needleSize The number of characters in the @a needle, which
+ * should be at least 2 and at most @a haystackSize.
+ * @return Returns true if the @a needle is found, otherwise returns false.
+ */
+bool sse2Contains(const char* haystack, size_t haystackSize,
+                  const char* needle, size_t needleSize)
+{
+    const size_t blockSize = sizeof(__m128i);
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[needleSize - 1]);
+    // the number of positions where the needle can start
+    const size_t positionCount = haystackSize - needleSize + 1;
+    size_t offset = 0;
+    for (; offset + blockSize <= positionCount; offset += blockSize)
+    {
+        const __m128i blockFirst = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(haystack + offset));
+        const __m128i blockLast = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(haystack + offset
+                                             + needleSize - 1));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, blockFirst),
+                          _mm_cmpeq_epi8(last, blockLast))));
+        // compare the inner characters at the candidate positions
+        while (mask != 0)
+        {
+            const char* candidate = haystack + offset + lowestBitIndex(mask);
+            if (std::memcmp(candidate + 1, needle + 1, needleSize - 2) == 0)
+            {
+                return true;
+            }
+            mask &= mask - 1;
+        }
+    }
+    // search the remaining positions which don't fill a whole block
+    if (offset < positionCount)
+    {
+        return scalarContains(haystack + offset, haystackSize - offset,
+                              needle, needleSize);
+    }
+    return false;
+}
+#endif
+} // anonymous namespace
+
+bool containsSubstring(const String& haystack, const String& needle)
+{
+    if (needle.empty())
+    {
+        return true;
+    }
+    if (needle.size() > haystack.size())
+    {
+        return false;
+    }
+#ifdef JMESPATH_SUBSTRING_SEARCH_SSE2
+    if (needle.size() > 1)
+    {
+        return sse2Contains(haystack.data(), haystack.size(),
+                            needle.data(), needle.size());
+    }
+#endif
+    return scalarContains(haystack.data(), haystack.size(),
+                          needle.data(), needle.size());
+}
+
+SubstringSearcher::SubstringSearcher(String needle)
+    : m_needle{std::move(needle)}
+{
+}
+
+const String &SubstringSearcher::needle() const
+{
+    return m_needle;
+}
+
+bool SubstringSearcher::isFoundIn(const String &haystack) const
+{
+    return containsSubstring(haystack, m_needle);
+}
+
+bool SubstringSearcher::isPrefixOf(const String &haystack) const
+{
+    return haystack.size() >= m_needle.size()
+        && std::memcmp(haystack.data(), m_needle.data(),
+                       m_needle.size()) == 0;
+}
+
+bool SubstringSearcher::isSuffixOf(const String &haystack) const
+{
+    return haystack.size() >= m_needle.size()
+        && std::memcmp(haystack.data() + haystack.size() - m_needle.size(),
+                       m_needle.data(), m_needle.size()) == 0;
+}
+}} // namespace jmespath::interpreter
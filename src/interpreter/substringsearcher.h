@@ -0,0 +1,97 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef SUBSTRINGSEARCHER_H
+#define SUBSTRINGSEARCHER_H
+#include "jmespath/types.h"
+
+namespace jmespath { namespace interpreter {
+
+/**
+ * @brief Checks whether the @a needle occurs in the @a haystack.
+ *
+ * Candidate positions are selected by comparing the first and last bytes of
+ * the @a needle with 16 positions of the @a haystack at once, and only the
+ * candidates are compared with the whole @a needle.
+ * @param[in] haystack The searched string.
+ * @param[in] needle The string that should be found.
+ * @return Returns true if the @a needle is a substring of the @a haystack,
+ * otherwise returns false.
+ */
+bool containsSubstring(const String& haystack, const String& needle);
+
+/**
+ * @brief The SubstringSearcher class searches for a constant needle in
+ * strings.
+ *
+ * It's created once for the constant argument of the contains, starts_with
+ * and ends_with functions when an expression is compiled, and it's reused
+ * for every searched string.
+ */
+class SubstringSearcher
+{
+public:
+    /**
+     * @brief Constructs a SubstringSearcher object which searches for the
+     * given @a needle.
+     * @param[in] needle The string that should be found.
+     */
+    explicit SubstringSearcher(String needle);
+    /**
+     * @brief Returns the string that the searcher searches for.
+     */
+    const String& needle() const;
+    /**
+     * @brief Checks whether the needle occurs in the @a haystack.
+     * @param[in] haystack The searched string.
+     * @return Returns true if the needle is a substring of the @a haystack,
+     * otherwise returns false.
+     */
+    bool isFoundIn(const String& haystack) const;
+    /**
+     * @brief Checks whether the @a haystack starts with the needle.
+     * @param[in] haystack The searched string.
+     * @return Returns true if the needle is a prefix of the @a haystack,
+     * otherwise returns false.
+     */
+    bool isPrefixOf(const String& haystack) const;
+    /**
+     * @brief Checks whether the @a haystack ends with the needle.
+     * @param[in] haystack The searched string.
+     * @return Returns true if the needle is a suffix of the @a haystack,
+     * otherwise returns false.
+     */
+    bool isSuffixOf(const String& haystack) const;
+
+private:
+    /**
+     * @brief The string that should be found.
+     */
+    String m_needle;
+};
+}} // namespace jmespath::interpreter
+#endif // SUBSTRINGSEARCHER_H
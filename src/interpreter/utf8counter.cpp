@@ -0,0 +1,154 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "src/interpreter/utf8counter.h"
+#include <cstdint>
+#include <cstring>
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JMESPATH_UTF8_COUNTER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace jmespath { namespace interpreter {
+
+namespace {
+/**
+ * @brief The number of bytes which are checked at once for ASCII
+ * characters.
+ */
+constexpr size_t asciiBlockSize = 64;
+
+/**
+ * @brief Checks whether the byte @a value is a UTF-8 continuation byte.
+ */
+inline bool isContinuationByte(char value)
+{
+    return (static_cast<unsigned char>(value) & 0xC0) == 0x80;
+}
+
+/**
+ * @brief Checks whether the @a asciiBlockSize bytes at @a data are all
+ * ASCII characters.
+ */
+inline bool isAsciiBlock(const char* data)
+{
+    // combine the bytes of the block in words with bitwise or, and check
+    // the highest bit of every byte
+    std::uint64_t words[asciiBlockSize / sizeof(std::uint64_t)];
+    std::memcpy(words, data, asciiBlockSize);
+    std::uint64_t combined = 0;
+    for (auto word: words)
+    {
+        combined |= word;
+    }
+    return (combined & UINT64_C(0x8080808080808080)) == 0;
+}
+
+#ifdef JMESPATH_UTF8_COUNTER_SSE2
+/**
+ * @brief Counts the bytes in @a blockCount blocks of 16 bytes at @a data
+ * which aren't continuation bytes.
+ * @param[in] data The address of the blocks.
+ * @param[in] blockCount The number of blocks, at most 255.
+ * @return The number of code points which start in the blocks.
+ */
+size_t countLeadingBytes(const char* data, size_t blockCount)
+{
+    // continuation bytes are the only bytes which are less than -64 when
+    // they're interpreted as signed integers
+    const __m128i threshold = _mm_set1_epi8(-65);
+    // every lane counts the leading bytes at its position, which fits into
+    // a byte for at most 255 blocks
+    __m128i counters = _mm_setzero_si128();
+    for (size_t i = 0; i < blockCount; ++i)
+    {
+        const __m128i block = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(data + i * sizeof(__m128i)));
+        // the comparison sets the lanes of the leading bytes to -1
+        counters = _mm_sub_epi8(counters, _mm_cmpgt_epi8(block, threshold));
+    }
+    // sum the lanes into the two halves of the register
+    const __m128i sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+    return static_cast<size_t>(_mm_cvtsi128_si32(sums))
+        + static_cast<size_t>(_mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+}
+#endif
+} // anonymous namespace
+
+bool isAscii(const char* data, size_t size)
+{
+    size_t offset = 0;
+    for (; offset + asciiBlockSize <= size; offset += asciiBlockSize)
+    {
+        if (!isAsciiBlock(data + offset))
+        {
+            return false;
+        }
+    }
+    for (; offset < size; ++offset)
+    {
+        if (static_cast<unsigned char>(data[offset]) >= 0x80)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t countCodePoints(const char* data, size_t size)
+{
+    size_t count = 0;
+    size_t offset = 0;
+    while (offset + asciiBlockSize <= size)
+    {
+        // count the blocks of ASCII characters by their size
+        if (isAsciiBlock(data + offset))
+        {
+            count += asciiBlockSize;
+            offset += asciiBlockSize;
+            continue;
+        }
+#ifdef JMESPATH_UTF8_COUNTER_SSE2
+        const size_t blockCount = asciiBlockSize / sizeof(__m128i);
+        count += countLeadingBytes(data + offset, blockCount);
+        offset += asciiBlockSize;
+#else
+        const size_t end = offset + asciiBlockSize;
+        for (; offset < end; ++offset)
+        {
+            count += isContinuationByte(data[offset]) ? 0 : 1;
+        }
+#endif
+    }
+    for (; offset < size; ++offset)
+    {
+        count += isContinuationByte(data[offset]) ? 0 : 1;
+    }
+    return count;
+}
+}} // namespace jmespath::interpreter
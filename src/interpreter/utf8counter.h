@@ -0,0 +1,57 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef UTF8COUNTER_H
+#define UTF8COUNTER_H
+#include <cstddef>
+
+namespace jmespath { namespace interpreter {
+
+/**
+ * @brief Checks whether the @a data contains only ASCII characters.
+ * @param[in] data The address of the characters.
+ * @param[in] size The number of characters.
+ * @return Returns true if every byte of the @a data is less than 0x80,
+ * otherwise returns false.
+ */
+bool isAscii(const char* data, size_t size);
+
+/**
+ * @brief Counts the code points in the UTF-8 encoded @a data.
+ *
+ * Every byte which isn't a continuation byte starts a new code point, so
+ * the bytes are classified 16 at a time instead of decoding the code points
+ * one by one, and blocks of ASCII characters are counted without
+ * classifying their bytes.
+ * @param[in] data The address of the UTF-8 encoded characters, which should
+ * be valid UTF-8.
+ * @param[in] size The number of bytes.
+ * @return The number of code points.
+ */
+size_t countCodePoints(const char* data, size_t size);
+}} // namespace jmespath::interpreter
+#endif // UTF8COUNTER_H
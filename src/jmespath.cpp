@@ -26,46 +26,60 @@
 **
 ****************************************************************************/
 #include "jmespath/jmespath.h"
-#include "src/interpreter/interpreter.h"
-#include <boost/hana.hpp>
 
 namespace jmespath {
 
+namespace {
+/**
+ * @brief Returns the evaluator of the calling thread.
+ * @return Reference to the evaluator of the calling thread.
+ */
+Evaluator& threadEvaluator()
+{
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wexit-time-destructors"
+    thread_local Evaluator s_evaluator;
+#pragma clang diagnostic pop
+    return s_evaluator;
+}
+} // anonymous namespace
+
 template <typename JsonT>
 std::enable_if_t<std::is_same<std::decay_t<JsonT>, Json>::value, Json>
 search(const Expression &expression, JsonT&& document)
 {
-    using interpreter::Interpreter;
-    using interpreter::JsonRef;
+    return threadEvaluator().search(expression, std::forward<JsonT>(document));
+}
 
-    if (expression.isEmpty())
-    {
-        return {};
-    }
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wexit-time-destructors"
-    thread_local Interpreter s_interpreter;
-#pragma clang diagnostic pop
-    s_interpreter.setContext(std::forward<JsonT>(document));
-    // evaluate the expression by calling visit with the root of the AST
-    s_interpreter.visit(expression.astRoot());
+Json search(const Expression &expression, const ColumnarDocument &document)
+{
+    return threadEvaluator().search(expression, document);
+}
+
+Json search(const Expression &expression, const FrozenDocument &document)
+{
+    return threadEvaluator().search(expression, document);
+}
 
-    // copy the context value from the interpreter if it's a reference or move
-    // it into the local result variable if it's a value, and return the result
-    // of the function by value. this approach leaves open the possibility for
-    // the compiler to use copy elision to optimize away any further copies or
-    // moves
-    Json result;
-    auto visitor = boost::hana::overload(
-        [&result](const JsonRef& value) mutable {
-            result = value.get();
-        },
-        [&result](Json& value) mutable {
-            result = std::move(value);
-        }
-    );
-    boost::apply_visitor(visitor, s_interpreter.currentContextValue());
-    return result;
+void search(const Expression &expression,
+            const Json &document,
+            std::ostream &output)
+{
+    threadEvaluator().search(expression, document, output);
+}
+
+void search(const Expression &expression,
+            const Json &document,
+            String &output)
+{
+    threadEvaluator().search(expression, document, output);
+}
+
+void search(const Expression &expression,
+            const Json &document,
+            const OutputCallback &output)
+{
+    threadEvaluator().search(expression, document, output);
 }
 
 // explicit instantion
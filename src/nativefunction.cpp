@@ -0,0 +1,84 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "jmespath/nativefunction.h"
+#include "jmespath/exceptions.h"
+#include "src/interpreter/interpreter.h"
+#include "src/interpreter/functionregistry.h"
+
+namespace jmespath {
+
+NativeArgument::NativeArgument(const Json &value)
+    : m_value{&value}
+{
+}
+
+NativeArgument::NativeArgument(Json &&value)
+    : m_value{&value},
+      m_temporary{&value}
+{
+}
+
+const Json &NativeArgument::value() const
+{
+    return *m_value;
+}
+
+bool NativeArgument::isTemporary() const
+{
+    return m_temporary != nullptr;
+}
+
+Json NativeArgument::take()
+{
+    if (m_temporary)
+    {
+        return std::move(*m_temporary);
+    }
+    return *m_value;
+}
+
+void registerFunction(const String &name,
+                      std::vector<ArgumentType> argumentTypes,
+                      NativeFunction function,
+                      bool isVariadic)
+{
+    // built in functions are looked up first, so they can't be replaced
+    if (name.empty()
+        || !function
+        || (isVariadic && argumentTypes.empty())
+        || interpreter::Interpreter::hasBuiltInFunction(name))
+    {
+        BOOST_THROW_EXCEPTION(InvalidAgrument{});
+    }
+    auto descriptor = std::make_shared<interpreter::NativeFunctionDescriptor>(
+        interpreter::NativeFunctionDescriptor{std::move(argumentTypes),
+                                              isVariadic,
+                                              std::move(function)});
+    interpreter::FunctionRegistry::instance().add(name, std::move(descriptor));
+}
+} // namespace jmespath
@@ -34,6 +34,7 @@
 #include "src/parser/appendutf8action.h"
 #include "src/parser/appendescapesequenceaction.h"
 #include "src/parser/encodesurrogatepairaction.h"
+#include "src/parser/moveaction.h"
 #include "src/parser/nodeinsertpolicy.h"
 #include "src/parser/nodeinsertcondition.h"
 #include <boost/spirit/include/qi.hpp>
@@ -98,6 +99,9 @@ public:
         phx::function<InsertNodeAction<
                 NodeInsertPolicy,
                 NodeInsertCondition> > insertNode;
+        // lazy function for moving the parsed subexpressions instead of
+        // copying them
+        phx::function<MoveAction> moveTo;
         // lazy function for appending UTF-32 characters to a string encoded
         // in UTF-8
         phx::function<AppendUtf8Action> appendUtf8;
@@ -243,14 +247,14 @@ public:
                 >> lit('}');
 
         // match an expression preceded by an exclamation mark
-        m_notExpressionRule = lit('!') >> m_expressionRule[_r1 = _1];
+        m_notExpressionRule = lit('!') >> m_expressionRule[moveTo(_r1, _1)];
 
         // match an expression inside parentheses
         m_parenExpressionRule = lit('(') >> m_expressionRule >> lit(')');
 
         // match a comparator symbol followed by an expression
         m_comparatorExpressionRule = m_comparatorSymbols[at_c<1>(_val) = _1]
-                >> m_expressionRule[_r1 = _1];
+                >> m_expressionRule[moveTo(_r1, _1)];
 
         // convert textual comparator symbols to enum values
         m_comparatorSymbols.add
@@ -262,13 +266,13 @@ public:
             (U"!=", ast::ComparatorExpressionNode::Comparator::NotEqual);
 
         // match a single vertical bar followed by an expression
-        m_pipeExpressionRule = lit("|") >> m_expressionRule[_r1 = _1];
+        m_pipeExpressionRule = lit("|") >> m_expressionRule[moveTo(_r1, _1)];
 
         // match double vertical bars followed by an expression
-        m_orExpressionRule = lit("||") >> m_expressionRule[_r1 = _1];
+        m_orExpressionRule = lit("||") >> m_expressionRule[moveTo(_r1, _1)];
 
         // match double ampersand followed by an expression
-        m_andExpressionRule = lit("&&") >> m_expressionRule[_r1 = _1];
+        m_andExpressionRule = lit("&&") >> m_expressionRule[moveTo(_r1, _1)];
 
         // match
         m_currentNodeRule = eps >> lit('@');
@@ -45,7 +45,8 @@ public:
 
     /**
      * @brief Inserts the given @a node into the AST at the location of the
-     * @a targetNode.
+     * @a targetNode. The @a node is moved into the AST, so the subtrees
+     * aren't copied.
      * @param[in] targetNode The node located where @a node should be inserted.
      * @param[in] node The node that will be inserted.
      * @{
@@ -57,8 +58,8 @@ public:
     void operator()(ast::ExpressionNode& targetNode,
                     T& node) const
     {
-        node.rightExpression = targetNode;
-        targetNode = node;
+        node.rightExpression = std::move(targetNode);
+        targetNode.value = std::move(node);
     }
 
     template <typename T, typename
@@ -67,8 +68,8 @@ public:
     void operator()(ast::ExpressionNode& targetNode,
                     T& node) const
     {
-        node.expression = targetNode;
-        targetNode = node;
+        node.expression = std::move(targetNode);
+        targetNode.value = std::move(node);
     }
 
     template <typename T, typename
@@ -80,7 +81,25 @@ public:
     void operator()(ast::ExpressionNode& targetNode,
                     T& node) const
     {
-        targetNode = node;
+        moveNode(targetNode, node);
+    }
+    /** @}*/
+
+private:
+    /**
+     * @brief Moves the @a node to the location of the @a targetNode.
+     * @{
+     */
+    static void moveNode(ast::ExpressionNode& targetNode,
+                         ast::ExpressionNode& node)
+    {
+        targetNode = std::move(node);
+    }
+
+    template <typename T>
+    static void moveNode(ast::ExpressionNode& targetNode, T& node)
+    {
+        targetNode.value = std::move(node);
     }
     /** @}*/
 };
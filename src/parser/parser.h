@@ -29,6 +29,7 @@
 #define PARSER_H
 #include "jmespath/types.h"
 #include "jmespath/exceptions.h"
+#include "src/parser/utf8iterator.h"
 #include <boost/spirit/include/qi.hpp>
 
 namespace jmespath { namespace parser {
@@ -47,7 +48,7 @@ public:
     /**
      * @brief Iterator type which will be used to instantiate the grammar
      */
-    using IteratorType  = UnicodeIteratorAdaptor;
+    using IteratorType  = Utf8Iterator;
     /**
      * @brief The type of the grammar that will be instantiated
      */
@@ -57,6 +58,21 @@ public:
      */
     using ResultType    = typename GrammarType::start_type::attr_type;
 
+    /**
+     * @brief Returns the parser shared by every thread of the process.
+     *
+     * The grammar is constructed on first use and isn't modified afterwards,
+     * so the shared parser can be used concurrently from multiple threads.
+     * @return Reference to the shared parser.
+     */
+    static const Parser& instance()
+    {
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wexit-time-destructors"
+        static const Parser s_parser;
+#pragma clang diagnostic pop
+        return s_parser;
+    }
     /**
      * @brief Parses the given @a expression
      * @param[in] expression JMESPath search expression encoded in UTF-8
@@ -64,7 +80,7 @@ public:
      * same as the attribute type of the start rule in the specified grammar.
      * @throws SyntaxError
      */
-    ResultType parse(const String& expression)
+    ResultType parse(const String& expression) const
     {
         try
         {
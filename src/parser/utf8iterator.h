@@ -0,0 +1,122 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#ifndef UTF8ITERATOR_H
+#define UTF8ITERATOR_H
+#include "jmespath/types.h"
+#include <boost/iterator/iterator_facade.hpp>
+
+namespace jmespath { namespace parser {
+
+/**
+ * @brief The Utf8Iterator class iterates over the code points of a UTF-8
+ * encoded string.
+ *
+ * ASCII characters, which make up almost every expression, are read
+ * directly as single bytes, and only the multi byte sequences in quoted
+ * identifiers, raw strings and literals are decoded with
+ * @ref UnicodeIteratorAdaptor. Like the adaptor, it advances by whole code
+ * points, so the distance between two iterators is measured in code points.
+ */
+class Utf8Iterator : public boost::iterator_facade<Utf8Iterator,
+                                                   UnicodeChar,
+                                                   boost::forward_traversal_tag,
+                                                   UnicodeChar>
+{
+public:
+    /**
+     * @brief Constructs a singular Utf8Iterator object.
+     */
+    Utf8Iterator() = default;
+    /**
+     * @brief Constructs a Utf8Iterator object which points to the code point
+     * starting at @a position.
+     * @param[in] position The position of the first byte of a code point.
+     */
+    explicit Utf8Iterator(String::const_iterator position)
+        : m_position{position}
+    {
+    }
+    /**
+     * @brief Returns the position of the first byte of the current code
+     * point.
+     */
+    String::const_iterator base() const
+    {
+        return m_position;
+    }
+
+private:
+    friend class boost::iterator_core_access;
+    /**
+     * @brief The position of the first byte of the current code point.
+     */
+    String::const_iterator m_position;
+
+    /**
+     * @brief Returns the current code point.
+     */
+    UnicodeChar dereference() const
+    {
+        if (isAscii())
+        {
+            return static_cast<unsigned char>(*m_position);
+        }
+        return *UnicodeIteratorAdaptor(m_position);
+    }
+    /**
+     * @brief Advances the iterator to the next code point.
+     */
+    void increment()
+    {
+        if (isAscii())
+        {
+            ++m_position;
+            return;
+        }
+        UnicodeIteratorAdaptor it(m_position);
+        ++it;
+        m_position = it.base();
+    }
+    /**
+     * @brief Checks whether the iterator points to the same position as the
+     * @a other iterator.
+     */
+    bool equal(const Utf8Iterator& other) const
+    {
+        return m_position == other.m_position;
+    }
+    /**
+     * @brief Checks whether the current code point is an ASCII character.
+     */
+    bool isAscii() const
+    {
+        return static_cast<unsigned char>(*m_position) < 0x80;
+    }
+};
+}} // namespace jmespath::parser
+#endif // UTF8ITERATOR_H
@@ -0,0 +1,502 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "jmespath/subscriptionindex.h"
+#include "src/interpreter/interpreter.h"
+#include "src/interpreter/compiledexpression.h"
+#include "src/ast/allnodes.h"
+#include <algorithm>
+#include <map>
+#include <boost/optional.hpp>
+
+namespace jmespath {
+
+struct SubscriptionIndex::State
+{
+    /**
+     * @brief The type of the segments of paths, a field name or an array
+     * index.
+     */
+    using PathSegment = boost::variant<String, Index>;
+    /**
+     * @brief The type of paths made of field names and array indices.
+     */
+    using Path = std::vector<PathSegment>;
+    /**
+     * @brief The PathIndex struct stores the predicates which depend on the
+     * value of a path.
+     */
+    struct PathIndex
+    {
+        /**
+         * @brief The indexed path.
+         */
+        Path path;
+        /**
+         * @brief The indices of the predicates by the value of the path which
+         * they compare it to.
+         */
+        std::map<Json, std::vector<size_t>> subscriptions;
+    };
+    /**
+     * @brief The Anchor struct describes an equality comparison of a path
+     * and a literal value.
+     */
+    struct Anchor
+    {
+        /**
+         * @brief The compared path.
+         */
+        Path path;
+        /**
+         * @brief The literal value.
+         */
+        Json value;
+    };
+    /**
+     * @brief The type of sets of anchors, where at least one of the anchors
+     * must be true for a predicate to be true.
+     */
+    using AnchorSet = std::vector<Anchor>;
+    /**
+     * @brief The Subscription struct describes a predicate in the index.
+     */
+    struct Subscription
+    {
+        /**
+         * @brief The predicate.
+         */
+        Expression predicate;
+        /**
+         * @brief True if the predicate is true exactly when one of its
+         * anchors is true.
+         */
+        bool isExact;
+    };
+
+    /**
+     * @brief The interpreter used for evaluating the predicates.
+     */
+    interpreter::Interpreter interpreter;
+    /**
+     * @brief The predicates in the index.
+     */
+    std::vector<Subscription> subscriptions;
+    /**
+     * @brief The indexed paths.
+     */
+    std::vector<PathIndex> pathIndices;
+    /**
+     * @brief The indices of the predicates which couldn't be indexed.
+     */
+    std::vector<size_t> unindexedSubscriptions;
+
+    /**
+     * @brief Creates the path described by the @a expression.
+     * @param[in] expression An expression.
+     * @param[out] path The path that the segments are appended to.
+     * @return Returns true if the @a expression is a path made of field
+     * names and array indices, otherwise returns false.
+     */
+    static bool makePath(const ast::ExpressionNode* expression, Path* path)
+    {
+        // the current node and the leftmost blank expression of an index
+        // expression refer to the context
+        if (expression->isNull()
+            || boost::get<ast::CurrentNode>(&expression->value))
+        {
+            return true;
+        }
+        if (auto node = boost::get<ast::IdentifierNode>(&expression->value))
+        {
+            path->push_back(node->identifier);
+            return true;
+        }
+        if (auto node = boost::get<ast::SubexpressionNode>(&expression->value))
+        {
+            return makePath(&node->leftExpression, path)
+                && makePath(&node->rightExpression, path);
+        }
+        if (auto node = boost::get<ast::ParenExpressionNode>(
+                &expression->value))
+        {
+            return makePath(&node->expression, path);
+        }
+        if (auto node = boost::get<ast::IndexExpressionNode>(
+                &expression->value))
+        {
+            auto arrayItem = boost::get<ast::ArrayItemNode>(
+                &node->bracketSpecifier.value);
+            if (!node->isProjection() && arrayItem
+                && makePath(&node->leftExpression, path))
+            {
+                path->push_back(arrayItem->index);
+                return true;
+            }
+        }
+        return false;
+    }
+    /**
+     * @brief Extracts the value of the literal @a expression.
+     * @param[in] expression An expression.
+     * @param[out] value The value of the literal.
+     * @return Returns true if the @a expression is a literal or a raw string,
+     * otherwise returns false.
+     */
+    static bool makeLiteral(const ast::ExpressionNode* expression, Json* value)
+    {
+        if (auto node = boost::get<ast::LiteralNode>(&expression->value))
+        {
+            *value = Json::parse(node->literal);
+            return true;
+        }
+        if (auto node = boost::get<ast::RawStringNode>(&expression->value))
+        {
+            *value = node->rawString;
+            return true;
+        }
+        if (auto node = boost::get<ast::ParenExpressionNode>(
+                &expression->value))
+        {
+            return makeLiteral(&node->expression, value);
+        }
+        return false;
+    }
+    /**
+     * @brief Collects the anchors of the @a expression, from which at least
+     * one must be true for the @a expression to be true.
+     *
+     * The paths of the anchors are not added to the index, since some of
+     * the collected anchors might be discarded.
+     * @param[in] expression A predicate.
+     * @param[out] isExact Set to false if the @a expression can be false
+     * while one of its anchors is true.
+     * @return The anchors of the @a expression, or none if the
+     * @a expression can be true without any anchors.
+     */
+    boost::optional<AnchorSet> makeAnchors(
+        const ast::ExpressionNode* expression,
+        bool* isExact) const
+    {
+        using Comparator = ast::ComparatorExpressionNode::Comparator;
+
+        if (auto node = boost::get<ast::ParenExpressionNode>(
+                &expression->value))
+        {
+            return makeAnchors(&node->expression, isExact);
+        }
+        // an equality comparison of a path and a literal is an anchor
+        if (auto node = boost::get<ast::ComparatorExpressionNode>(
+                &expression->value))
+        {
+            // the path can be on either side of the comparison
+            Path path;
+            Json value;
+            bool isAnchor = false;
+            if (node->comparator == Comparator::Equal)
+            {
+                isAnchor = makePath(&node->leftExpression, &path)
+                    && makeLiteral(&node->rightExpression, &value);
+                if (!isAnchor)
+                {
+                    path.clear();
+                    isAnchor = makePath(&node->rightExpression, &path)
+                        && makeLiteral(&node->leftExpression, &value);
+                }
+            }
+            if (isAnchor)
+            {
+                return AnchorSet{Anchor{std::move(path), std::move(value)}};
+            }
+        }
+        // an and expression can only be true if both sides are true, so it
+        // can be anchored by the anchors of either side, the side whose
+        // anchors are shared by fewer predicates is likely more selective
+        else if (auto node = boost::get<ast::AndExpressionNode>(
+                     &expression->value))
+        {
+            *isExact = false;
+            bool isLeftExact = false;
+            bool isRightExact = false;
+            auto left = makeAnchors(&node->leftExpression, &isLeftExact);
+            auto right = makeAnchors(&node->rightExpression, &isRightExact);
+            if (left && right)
+            {
+                return anchorWeight(*left) <= anchorWeight(*right)
+                    ? left : right;
+            }
+            return left ? left : right;
+        }
+        // an or expression can be true if either side is true, so it needs the
+        // anchors of both sides
+        else if (auto node = boost::get<ast::OrExpressionNode>(
+                     &expression->value))
+        {
+            auto left = makeAnchors(&node->leftExpression, isExact);
+            auto right = makeAnchors(&node->rightExpression, isExact);
+            if (left && right)
+            {
+                std::move(right->begin(), right->end(),
+                          std::back_inserter(*left));
+                return left;
+            }
+        }
+        *isExact = false;
+        return boost::none;
+    }
+    /**
+     * @brief Calculates the number of predicates which would be evaluated
+     * when one of the @a anchors is true, including the new predicate.
+     * @param[in] anchors A set of anchors.
+     * @return The number of predicates found by the @a anchors.
+     */
+    size_t anchorWeight(const AnchorSet& anchors) const
+    {
+        size_t weight = 0;
+        for (const auto& anchor: anchors)
+        {
+            weight += 1;
+            auto index = findPathIndex(anchor.path);
+            if (index != pathIndices.size())
+            {
+                const auto& subscriptions = pathIndices[index].subscriptions;
+                auto it = subscriptions.find(anchor.value);
+                if (it != subscriptions.cend())
+                {
+                    weight += it->second.size();
+                }
+            }
+        }
+        return weight;
+    }
+    /**
+     * @brief Finds the @a path in @ref pathIndices.
+     * @param[in] path A path.
+     * @return The index of the @a path, or the size of @ref pathIndices if
+     * the @a path is not in the index.
+     */
+    size_t findPathIndex(const Path& path) const
+    {
+        auto it = std::find_if(pathIndices.cbegin(), pathIndices.cend(),
+                               [&](const PathIndex& pathIndex) {
+            return pathIndex.path == path;
+        });
+        return static_cast<size_t>(it - pathIndices.cbegin());
+    }
+    /**
+     * @brief Returns the index of the @a path in @ref pathIndices, and adds
+     * the @a path if it's not in the index yet.
+     * @param[in] path A path.
+     * @return The index of the @a path.
+     */
+    size_t pathIndex(Path&& path)
+    {
+        auto index = findPathIndex(path);
+        if (index == pathIndices.size())
+        {
+            pathIndices.push_back(PathIndex{std::move(path), {}});
+        }
+        return index;
+    }
+    /**
+     * @brief Looks up the value at the @a path in the @a document.
+     * @param[in] document A JSON document.
+     * @param[in] path A path.
+     * @return Pointer to the value, or `nullptr` if the @a path evaluates to
+     * null.
+     */
+    static const Json* lookup(const Json& document, const Path& path)
+    {
+        const Json* value = &document;
+        for (const auto& segment: path)
+        {
+            if (auto field = boost::get<String>(&segment))
+            {
+                if (!value->is_object())
+                {
+                    return nullptr;
+                }
+                auto it = value->find(*field);
+                if (it == value->cend())
+                {
+                    return nullptr;
+                }
+                value = &*it;
+            }
+            else
+            {
+                if (!value->is_array())
+                {
+                    return nullptr;
+                }
+                Index index = boost::get<Index>(segment);
+                if (index < 0)
+                {
+                    index += value->size();
+                }
+                if ((index < 0) || (index >= value->size()))
+                {
+                    return nullptr;
+                }
+                value = &(*value)[static_cast<size_t>(index)];
+            }
+        }
+        return value;
+    }
+    /**
+     * @brief Evaluates the @a predicate on the @a document.
+     * @param[in] predicate A predicate.
+     * @param[in] document A JSON document.
+     * @return Returns true if the result of the @a predicate is a true like
+     * value, otherwise returns false.
+     */
+    bool evaluate(const Expression& predicate, const Json& document)
+    {
+        // don't copy the results of the predicates, only their truthiness
+        // is needed
+        if (auto compiledExpression = predicate.compiledExpression())
+        {
+            interpreter::ContextValue result = compiledExpression->evaluate(
+                document,
+                &interpreter);
+            return interpreter.toBoolean(interpreter::getJsonValue(result));
+        }
+        interpreter.setContext(document);
+        interpreter.visit(predicate.astRoot());
+        bool isTrue = interpreter.toBoolean(
+            interpreter::getJsonValue(interpreter.currentContextValue()));
+        interpreter.setContext(Json{});
+        return isTrue;
+    }
+};
+
+SubscriptionIndex::SubscriptionIndex()
+    : m_state(new State)
+{
+}
+
+SubscriptionIndex::SubscriptionIndex(SubscriptionIndex &&other)
+    : SubscriptionIndex()
+{
+    *this = std::move(other);
+}
+
+SubscriptionIndex &SubscriptionIndex::operator=(SubscriptionIndex &&other)
+{
+    if (this != &other)
+    {
+        // swap the states so the moved from object remains usable
+        std::swap(m_state, other.m_state);
+    }
+    return *this;
+}
+
+SubscriptionIndex::~SubscriptionIndex() = default;
+
+size_t SubscriptionIndex::addSubscription(const Expression &predicate)
+{
+    size_t index = m_state->subscriptions.size();
+    bool isExact = true;
+    boost::optional<State::AnchorSet> anchors;
+    if (!predicate.isEmpty())
+    {
+        anchors = m_state->makeAnchors(predicate.astRoot(), &isExact);
+    }
+    // empty predicates are never true
+    else
+    {
+        anchors = State::AnchorSet{};
+    }
+    m_state->subscriptions.push_back(State::Subscription{predicate,
+                                                         anchors && isExact});
+    // only the paths of the anchors which are kept are added to the index,
+    // so match doesn't look up paths which no predicate depends on
+    if (anchors)
+    {
+        for (auto& anchor: *anchors)
+        {
+            auto pathIndex = m_state->pathIndex(std::move(anchor.path));
+            auto& subscriptions = m_state->pathIndices[pathIndex]
+                .subscriptions[std::move(anchor.value)];
+            if (subscriptions.empty() || subscriptions.back() != index)
+            {
+                subscriptions.push_back(index);
+            }
+        }
+    }
+    else
+    {
+        m_state->unindexedSubscriptions.push_back(index);
+    }
+    return index;
+}
+
+size_t SubscriptionIndex::subscriptionCount() const
+{
+    return m_state->subscriptions.size();
+}
+
+std::vector<size_t> SubscriptionIndex::match(const Json &document)
+{
+    // collect the predicates whose anchors are true by looking up the value
+    // of every indexed path once
+    const Json nullValue;
+    std::vector<size_t> candidates;
+    for (const auto& pathIndex: m_state->pathIndices)
+    {
+        const Json* value = State::lookup(document, pathIndex.path);
+        auto it = pathIndex.subscriptions.find(value ? *value : nullValue);
+        if (it != pathIndex.subscriptions.cend())
+        {
+            candidates.insert(candidates.end(),
+                              it->second.cbegin(),
+                              it->second.cend());
+        }
+    }
+    candidates.insert(candidates.end(),
+                      m_state->unindexedSubscriptions.cbegin(),
+                      m_state->unindexedSubscriptions.cend());
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                     candidates.end());
+
+    // evaluate the candidates which aren't known to match already
+    auto last = std::remove_if(candidates.begin(), candidates.end(),
+                               [&](size_t index) {
+        const auto& subscription = m_state->subscriptions[index];
+        return !subscription.isExact
+            && !m_state->evaluate(subscription.predicate, document);
+    });
+    candidates.erase(last, candidates.end());
+    return candidates;
+}
+
+void SubscriptionIndex::StateDeleter::operator()(State *state) const
+{
+    delete state;
+}
+} // namespace jmespath
@@ -0,0 +1,202 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "fakeit.hpp"
+#include "jmespath/expression.h"
+#include "src/interpreter/astencoder.h"
+#include "src/interpreter/astdecoder.h"
+#include "src/parser/parser.h"
+#include "src/parser/grammar.h"
+
+TEST_CASE("AstEncoder")
+{
+    using namespace jmespath;
+    using namespace jmespath::interpreter;
+
+    const auto& parser = parser::Parser<parser::Grammar>::instance();
+    auto encode = [](const ast::ExpressionNode& node) {
+        std::vector<std::uint8_t> output;
+        AstEncoder{&output}.encode(&node);
+        return output;
+    };
+    const char* expressions[] = {
+        "foo",
+        "\"with \\\"quotes\\\" and \\u00e9\"",
+        "'raw string'",
+        "`{\"a\": [1, 2.5, null]}`",
+        "foo.bar.baz",
+        "foo[0]",
+        "foo[-1]",
+        "foo[-18446744073709551615]",
+        "foo[]",
+        "foo[*].bar",
+        "foo[1:]",
+        "foo[:-2:3]",
+        "foo[::-1]",
+        "[?a > `1` && b != 'c'].d",
+        "foo[?!bar]",
+        "*.foo",
+        "[foo, bar[0], baz.*]",
+        "{a: foo, \"b c\": bar.baz}",
+        "a || b && c",
+        "(a || b).c",
+        "a | b[0]",
+        "@",
+        "length(@)",
+        "sort_by(people, &age)[*].name",
+        "max_by(items, &to_number(price))",
+        "not_null(a, b, `null`)",
+        "a == b || a < b || a <= b || a >= b || a > b"
+    };
+
+    SECTION("encodes ASTs which are decoded into equal ASTs")
+    {
+        for (const char* expression: expressions)
+        {
+            ast::ExpressionNode node = parser.parse(expression);
+            std::vector<std::uint8_t> encoded = encode(node);
+            ast::ExpressionNode decodedNode;
+            AstDecoder decoder{encoded.data(), encoded.size()};
+
+            decoder.decode(&decodedNode);
+
+            REQUIRE(decoder.atEnd());
+            REQUIRE(decodedNode == node);
+        }
+    }
+
+    SECTION("encodes expressions whose strings describe the decoded ASTs")
+    {
+        for (const char* expressionString: expressions)
+        {
+            std::vector<std::uint8_t> encoded
+                = Expression{expressionString}.toBinary();
+
+            Expression expression = Expression::fromBinary(encoded.data(),
+                                                           encoded.size());
+
+            REQUIRE(expression.toString() == expressionString);
+            REQUIRE(Expression{expression.toString()} == expression);
+        }
+    }
+
+    SECTION("encodes empty nodes")
+    {
+        std::vector<std::uint8_t> encoded = encode(ast::ExpressionNode{});
+        ast::ExpressionNode decodedNode{ast::IdentifierNode{"foo"}};
+
+        AstDecoder{encoded.data(), encoded.size()}.decode(&decodedNode);
+
+        REQUIRE(encoded.size() == 1);
+        REQUIRE(decodedNode.isNull());
+    }
+
+    SECTION("encodes the largest array indices")
+    {
+        Index index = std::numeric_limits<size_t>::max();
+        ast::ExpressionNode node{ast::IndexExpressionNode{
+            ast::ExpressionNode{},
+            ast::BracketSpecifierNode{ast::ArrayItemNode{-index}}}};
+        std::vector<std::uint8_t> encoded = encode(node);
+        ast::ExpressionNode decodedNode;
+
+        AstDecoder{encoded.data(), encoded.size()}.decode(&decodedNode);
+
+        REQUIRE(decodedNode == node);
+    }
+
+    SECTION("throws on truncated data")
+    {
+        ast::ExpressionNode node = parser.parse(
+            "foo[?bar == 'baz'].{a: length(@), b: sort_by(c, &d)[1:2]}");
+        std::vector<std::uint8_t> encoded = encode(node);
+
+        for (size_t size = 0; size < encoded.size(); ++size)
+        {
+            ast::ExpressionNode decodedNode;
+            AstDecoder decoder{encoded.data(), size};
+
+            REQUIRE_THROWS_AS(decoder.decode(&decodedNode), InvalidAgrument);
+        }
+    }
+
+    SECTION("throws on unknown tags")
+    {
+        const std::uint8_t unknownTag[] = {0xff};
+        const std::uint8_t misplacedTag[] = {
+            static_cast<std::uint8_t>(NodeTag::ListWildcard)
+        };
+        ast::ExpressionNode decodedNode;
+
+        REQUIRE_THROWS_AS(AstDecoder(unknownTag, 1).decode(&decodedNode),
+                          InvalidAgrument);
+        REQUIRE_THROWS_AS(AstDecoder(misplacedTag, 1).decode(&decodedNode),
+                          InvalidAgrument);
+    }
+
+    SECTION("limits the nesting depth of expressions")
+    {
+        auto nestedNotExpressions = [](size_t depth) {
+            std::vector<std::uint8_t> encoded(
+                depth - 1, static_cast<std::uint8_t>(NodeTag::NotExpression));
+            encoded.push_back(static_cast<std::uint8_t>(NodeTag::Current));
+            return encoded;
+        };
+        auto allowed = nestedNotExpressions(AstDecoder::maxDepth);
+        auto tooDeep = nestedNotExpressions(AstDecoder::maxDepth + 1);
+        std::vector<std::uint8_t> corrupted(
+            1000000, static_cast<std::uint8_t>(NodeTag::NotExpression));
+        ast::ExpressionNode decodedNode;
+
+        AstDecoder{allowed.data(), allowed.size()}.decode(&decodedNode);
+        REQUIRE(decodedNode.value.type() == typeid(ast::NotExpressionNode));
+        REQUIRE_THROWS_AS(AstDecoder(tooDeep.data(), tooDeep.size())
+                              .decode(&decodedNode),
+                          InvalidAgrument);
+        REQUIRE_THROWS_AS(AstDecoder(corrupted.data(), corrupted.size())
+                              .decode(&decodedNode),
+                          InvalidAgrument);
+    }
+
+    SECTION("writes variable length integers")
+    {
+        const std::pair<std::uint64_t, size_t> values[] = {
+            {0, 1}, {1, 1}, {127, 1}, {128, 2}, {300, 2}, {16383, 2},
+            {16384, 3}, {std::numeric_limits<std::uint64_t>::max(), 10}
+        };
+
+        for (const auto& value: values)
+        {
+            std::vector<std::uint8_t> encoded;
+            AstEncoder::writeVarint(value.first, &encoded);
+
+            REQUIRE(encoded.size() == value.second);
+            REQUIRE(AstDecoder(encoded.data(), encoded.size()).readVarint()
+                    == value.first);
+        }
+    }
+}
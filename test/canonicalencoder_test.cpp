@@ -0,0 +1,146 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "fakeit.hpp"
+#include "src/interpreter/canonicalencoder.h"
+#include "src/interpreter/interpreter.h"
+#include "src/parser/parser.h"
+#include "src/parser/grammar.h"
+#include <jmespath/jmespath.h>
+
+TEST_CASE("CanonicalEncoder")
+{
+    using namespace jmespath;
+    using namespace jmespath::interpreter;
+
+    const auto& parser = parser::Parser<parser::Grammar>::instance();
+    auto encode = [](const ast::ExpressionNode& node) {
+        std::vector<std::uint8_t> output;
+        CanonicalEncoder{&output}.encode(&node);
+        return output;
+    };
+
+    SECTION("encodes equivalent expressions the same way")
+    {
+        std::vector<std::vector<const char*>> equivalentExpressions = {
+            {"foo.bar", "(foo).bar", "foo . bar", "@.foo.bar", "((foo)).bar",
+             "@ | foo.bar", "foo.bar | @", "(@.foo).bar"},
+            {"foo[0]", "@.foo[0]", "(foo)[0]"},
+            {"[0]", "@[0]", "(@)[0]"},
+            {"*.a", "@.*.a"},
+            {"[?a == `1`]", "@[?a == `1`]", "[?(a) == ` 1 `]"},
+            {"length(@)", "length(@ | @)"},
+            {"'a'", "`\"a\"`"},
+            {"`{\"a\": 1, \"b\": [1, 2]}`", "`{ \"b\" : [1,2], \"a\" : 1 }`"}
+        };
+
+        for (const auto& expressions: equivalentExpressions)
+        {
+            auto expected = encode(parser.parse(expressions.front()));
+            for (const char* expression: expressions)
+            {
+                INFO(expression);
+                ast::ExpressionNode node = parser.parse(expression);
+
+                REQUIRE(encode(node) == expected);
+                REQUIRE(CanonicalEncoder::structuralHash(node)
+                        == CanonicalEncoder::hash(expected));
+            }
+        }
+    }
+
+    SECTION("encodes different expressions differently")
+    {
+        const char* expressions[] = {
+            "foo.bar",
+            "bar.foo",
+            "foo[*].bar",
+            "(foo[*]).bar",
+            "foo[0]",
+            "foo[1]",
+            "'1'",
+            "`1`",
+            "@",
+            "foo | bar",
+            "a || b",
+            "a && b"
+        };
+
+        for (const char* first: expressions)
+        {
+            for (const char* second: expressions)
+            {
+                if (first != second)
+                {
+                    INFO(first << " " << second);
+                    REQUIRE(encode(parser.parse(first))
+                            != encode(parser.parse(second)));
+                }
+            }
+        }
+    }
+
+    SECTION("creates canonical ASTs without the equivalent nodes")
+    {
+        ast::ExpressionNode node = parser.parse("(@.foo).bar[?@.baz] | @");
+
+        ast::ExpressionNode canonicalNode
+            = CanonicalEncoder::canonicalForm(node);
+
+        REQUIRE(canonicalNode == parser.parse("foo.bar[?baz]"));
+    }
+
+    SECTION("creates canonical ASTs which evaluate to the same result")
+    {
+        Json document = R"({
+            "foo": [{"bar": 1, "baz": "a"}, {"bar": 2, "baz": "b"}],
+            "qux": {"a": {"b": 3}}
+        })"_json;
+        const char* expressions[] = {
+            "(foo[*]).bar",
+            "@.foo[*].bar",
+            "(@.foo)[?baz == 'b'] | [0]",
+            "@.qux.*.b",
+            "length(@.foo) | @",
+            "[qux.a, (foo)[1].bar, 'str']"
+        };
+
+        for (const char* expression: expressions)
+        {
+            INFO(expression);
+            Expression parsedExpression{expression};
+            auto canonicalNode = CanonicalEncoder::canonicalForm(
+                *parsedExpression.astRoot());
+            Interpreter interpreter;
+            interpreter.setContext(document);
+            interpreter.visit(&canonicalNode);
+
+            REQUIRE(interpreter.currentContext()
+                    == search(parsedExpression, document));
+        }
+    }
+}
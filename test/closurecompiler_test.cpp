@@ -0,0 +1,255 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "fakeit.hpp"
+#include "src/interpreter/closurecompiler.h"
+#include "src/ast/allnodes.h"
+#include <jmespath/jmespath.h>
+
+TEST_CASE("ClosureCompiler")
+{
+    using namespace jmespath;
+    using namespace jmespath::interpreter;
+    namespace ast = jmespath::ast;
+
+    Interpreter interpreter;
+    ClosureCompiler compiler;
+    Json document = "{\"foo\": {\"bar\": [1, 2, 3]}, \"baz\": \"qux\"}"_json;
+
+    SECTION("compiles empty expressions to the identity")
+    {
+        ast::ExpressionNode node;
+
+        auto closure = compiler.compile(&node);
+        ContextValue result = closure(document, &interpreter);
+
+        REQUIRE(&getJsonValue(result) == &document);
+    }
+
+    SECTION("compiles identifiers to references into the context")
+    {
+        ast::ExpressionNode node{ast::IdentifierNode{"foo"}};
+
+        auto closure = compiler.compile(&node);
+        ContextValue result = closure(document, &interpreter);
+
+        REQUIRE(&getJsonValue(result) == &document["foo"]);
+    }
+
+    SECTION("compiles identifiers which evaluate to null for missing keys")
+    {
+        ast::ExpressionNode node{ast::IdentifierNode{"missing"}};
+
+        auto closure = compiler.compile(&node);
+
+        REQUIRE(getJsonValue(closure(document, &interpreter)).is_null());
+    }
+
+    SECTION("compiles literals which are parsed only once")
+    {
+        ast::ExpressionNode node{ast::LiteralNode{"{\"a\": [1, 2]}"}};
+
+        auto closure = compiler.compile(&node);
+        ContextValue result1 = closure(document, &interpreter);
+        ContextValue result2 = closure(document, &interpreter);
+
+        REQUIRE(getJsonValue(result1) == "{\"a\": [1, 2]}"_json);
+        REQUIRE(&getJsonValue(result1) == &getJsonValue(result2));
+    }
+
+    SECTION("compiles comparator expressions")
+    {
+        ast::ExpressionNode node{
+            ast::ComparatorExpressionNode{
+                ast::ExpressionNode{
+                    ast::IdentifierNode{"baz"}},
+                ast::ComparatorExpressionNode::Comparator::Equal,
+                ast::ExpressionNode{
+                    ast::RawStringNode{"qux"}}}};
+
+        auto closure = compiler.compile(&node);
+
+        REQUIRE(getJsonValue(closure(document, &interpreter)) == true);
+    }
+
+    SECTION("compiled ordering comparators evaluate to null for non numbers")
+    {
+        ast::ExpressionNode node{
+            ast::ComparatorExpressionNode{
+                ast::ExpressionNode{
+                    ast::IdentifierNode{"baz"}},
+                ast::ComparatorExpressionNode::Comparator::Less,
+                ast::ExpressionNode{
+                    ast::LiteralNode{"1"}}}};
+
+        auto closure = compiler.compile(&node);
+
+        REQUIRE(getJsonValue(closure(document, &interpreter)).is_null());
+    }
+
+    SECTION("compiled unknown comparators throw when evaluated")
+    {
+        ast::ExpressionNode node{
+            ast::ComparatorExpressionNode{
+                ast::ExpressionNode{},
+                ast::ComparatorExpressionNode::Comparator::Unknown,
+                ast::ExpressionNode{}}};
+
+        auto closure = compiler.compile(&node);
+
+        REQUIRE_THROWS_AS(closure(document, &interpreter), InvalidAgrument);
+    }
+
+    SECTION("compiled unknown functions throw when evaluated")
+    {
+        ast::ExpressionNode node{ast::FunctionExpressionNode{"unknown"}};
+
+        auto closure = compiler.compile(&node);
+
+        REQUIRE_THROWS_AS(closure(document, &interpreter), UnknownFunction);
+    }
+
+    SECTION("compiled slices with zero step throw when evaluated on arrays")
+    {
+        Expression expression{"foo.bar[::0]"};
+
+        auto closure = compiler.compile(expression.astRoot());
+
+        REQUIRE_THROWS_AS(closure(document, &interpreter), InvalidValue);
+    }
+
+    SECTION("compiles string matching functions with constant needles")
+    {
+        Json logs = R"([
+            "request timeout after 30s",
+            "connection reset",
+            "timeout",
+            ["timeout"]
+        ])"_json;
+        Expression expression{"[?contains(@, 'timeout')]"};
+        Expression prefixExpression{"[?starts_with(@, `\"time\"`)]"};
+        Expression suffixExpression{"[?ends_with(@, ('reset'))]"};
+
+        auto closure = compiler.compile(expression.astRoot());
+        auto prefixClosure = compiler.compile(prefixExpression.astRoot());
+
+        REQUIRE(getJsonValue(closure(logs, &interpreter))
+                == R"(["request timeout after 30s", "timeout",
+                      ["timeout"]])"_json);
+        REQUIRE_THROWS_AS(prefixClosure(logs, &interpreter),
+                          InvalidFunctionArgumentType);
+        logs.erase(3);
+        REQUIRE(getJsonValue(prefixClosure(logs, &interpreter))
+                == R"(["timeout"])"_json);
+        REQUIRE(getJsonValue(compiler.compile(suffixExpression.astRoot())(
+                    logs, &interpreter))
+                == R"(["connection reset"])"_json);
+    }
+
+    SECTION("string matching functions reject expression type subjects")
+    {
+        const char* expressions[] = {
+            "contains(&foo, 'x')",
+            "starts_with(&foo, 'x')",
+            "ends_with(&foo, 'x')"
+        };
+
+        for (const char* expressionString: expressions)
+        {
+            Expression expression{expressionString};
+            auto closure = compiler.compile(expression.astRoot());
+
+            REQUIRE_THROWS_AS(closure(document, &interpreter),
+                              InvalidFunctionArgumentType);
+            REQUIRE_THROWS_AS(search(expression, document),
+                              InvalidFunctionArgumentType);
+        }
+    }
+
+    SECTION("shares the temporary values referred to by the results")
+    {
+        Expression expression{"to_array(foo)[0].bar"};
+
+        auto closure = compiler.compile(expression.astRoot());
+        ContextValue result = closure(document, &interpreter);
+
+        REQUIRE(boost::get<JsonPtr>(&result) != nullptr);
+        REQUIRE(getJsonValue(result) == "[1, 2, 3]"_json);
+    }
+
+    SECTION("evaluates to the same results as the interpreter")
+    {
+        Json records = R"({
+            "people": [
+                {"name": "a", "age": 30, "tags": ["x", "y"], "boss": null},
+                {"name": "b", "age": 20, "tags": [], "boss": {"name": "a"}},
+                {"name": "c", "age": 40, "tags": ["z"]},
+                {"name": "d", "age": "unknown", "tags": [["w"]]}
+            ],
+            "groups": {"g1": {"size": 2}, "g2": {"size": 5}, "g3": 7}
+        })"_json;
+        String expressions[] = {
+            "people[*].name",
+            "people[?age > `25`].name",
+            "people[?age > `25` || !boss].{n: name, t: tags[0]}",
+            "people[].tags[]",
+            "people[].tags[][]",
+            "people[1:3].name",
+            "people[::-1].age",
+            "people[-1].tags",
+            "groups.*.size",
+            "groups.* | [0]",
+            "people[*].[name, age]",
+            "people[?tags[?@ == 'x']].name",
+            "people[?boss.name == 'a'] | [0].name",
+            "sort_by(people[?to_string(age) != 'unknown'], &age)[*].name",
+            "not_null(missing, people[0].boss, `\"default\"`)",
+            "length(people) > `3` && people[0].name",
+            "max_by(people[:3], &age).name",
+            "map(&name, people)",
+            "people[0].name == 'a' && 'yes' || 'no'",
+            "(people[*].age)[?@ > `25`]",
+            "@.groups.g3",
+            "people | [1:] | [0].name",
+            "people[*].tags | []"
+        };
+
+        for (const auto& expressionString: expressions)
+        {
+            Expression expression{expressionString};
+            interpreter.setContext(records);
+            interpreter.visit(expression.astRoot());
+            Json expectedResult = interpreter.currentContext();
+
+            auto closure = compiler.compile(expression.astRoot());
+            ContextValue result = closure(records, &interpreter);
+
+            INFO(expressionString);
+            REQUIRE(getJsonValue(result) == expectedResult);
+        }
+    }
+}
@@ -0,0 +1,150 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "fakeit.hpp"
+#include <jmespath/jmespath.h>
+#include <thread>
+#include <vector>
+
+TEST_CASE("ColumnarDocument")
+{
+    using namespace jmespath;
+
+    Json records(Json::value_t::array);
+    for (int i = 0; i < 100; ++i)
+    {
+        Json record = {{"id", i}, {"name", "item" + std::to_string(i)}};
+        if (i % 2 == 0)
+        {
+            record["even"] = true;
+        }
+        records.push_back(std::move(record));
+    }
+    Json jsonDocument = {{"records", records}, {"short", {{{"id", 1}}}}};
+
+    SECTION("can be constructed with a document")
+    {
+        ColumnarDocument document{jsonDocument};
+
+        REQUIRE(document.document() == jsonDocument);
+        REQUIRE(document.columnCount() == 0);
+    }
+
+    SECTION("can be move constructed")
+    {
+        ColumnarDocument document{jsonDocument};
+        const Json* address = &document.document();
+
+        ColumnarDocument document2{std::move(document)};
+
+        REQUIRE(&document2.document() == address);
+    }
+
+    SECTION("evaluates projections on columns")
+    {
+        ColumnarDocument document{jsonDocument};
+        Expression expression{"records[*].{id: id, even: even}"};
+
+        auto result = search(expression, document);
+
+        REQUIRE(result == search(expression, jsonDocument));
+        REQUIRE(document.columnCount() == 2);
+    }
+
+    SECTION("evaluates filters on columns")
+    {
+        ColumnarDocument document{jsonDocument};
+        Expression expression{"records[?even && id > `90`].name"};
+
+        auto result = search(expression, document);
+
+        REQUIRE(result == "[\"item92\", \"item94\", \"item96\", \"item98\"]"_json);
+        REQUIRE(document.columnCount() == 3);
+    }
+
+    SECTION("evaluates sort_by on columns")
+    {
+        ColumnarDocument document{jsonDocument};
+        Expression expression{"sort_by(records, &name)[*].id"};
+
+        auto result = search(expression, document);
+
+        REQUIRE(result == search(expression, jsonDocument));
+        REQUIRE(document.columnCount() == 1);
+    }
+
+    SECTION("reuses columns in subsequent searches")
+    {
+        ColumnarDocument document{jsonDocument};
+
+        auto result1 = search("records[*].id", document);
+        auto result2 = search("max(records[*].id)", document);
+
+        REQUIRE(result1.size() == 100);
+        REQUIRE(result2 == 99);
+        REQUIRE(document.columnCount() == 1);
+    }
+
+    SECTION("can be searched concurrently through const references")
+    {
+        const ColumnarDocument document{jsonDocument};
+        const String expressions[] = {
+            "records[*].{id: id, even: even}",
+            "records[?even && id > `90`].name",
+            "sort_by(records, &name)[*].id"
+        };
+        std::vector<Json> results(16);
+
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            threads.emplace_back([&, i] {
+                results[i] = search(expressions[i % 3], document);
+            });
+        }
+        for (auto& thread: threads)
+        {
+            thread.join();
+        }
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            REQUIRE(results[i] == search(expressions[i % 3], jsonDocument));
+        }
+        REQUIRE(document.columnCount() == 3);
+    }
+
+    SECTION("doesn't create columns for short arrays")
+    {
+        ColumnarDocument document{jsonDocument};
+
+        auto result = search("short[*].id", document);
+
+        REQUIRE(result == "[1]"_json);
+        REQUIRE(document.columnCount() == 0);
+    }
+}
@@ -0,0 +1,96 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "fakeit.hpp"
+#include "src/interpreter/columncache.h"
+
+TEST_CASE("ColumnCache")
+{
+    using namespace jmespath;
+    using jmespath::interpreter::ColumnCache;
+
+    Json array(Json::value_t::array);
+    for (size_t i = 0; i < ColumnCache::minimumColumnLength; ++i)
+    {
+        array.push_back({{"id", i}});
+    }
+    array.back()["name"] = "last";
+    Json document = {{"array", array}};
+    const Json& documentArray = document["array"];
+
+    SECTION("creates columns for arrays of objects in the document")
+    {
+        ColumnCache cache{document};
+
+        auto column = cache.column(documentArray, "name");
+
+        REQUIRE(cache.isColumnarArray(documentArray));
+        REQUIRE(column != nullptr);
+        REQUIRE(column->size() == ColumnCache::minimumColumnLength);
+        REQUIRE(column->front() == nullptr);
+        REQUIRE(*column->back() == "last");
+        REQUIRE(cache.size() == 1);
+    }
+
+    SECTION("returns the same column for the same field")
+    {
+        ColumnCache cache{document};
+
+        auto column1 = cache.column(documentArray, "id");
+        auto column2 = cache.column(documentArray, "id");
+
+        REQUIRE(column1 == column2);
+        REQUIRE(cache.size() == 1);
+    }
+
+    SECTION("doesn't create columns for arrays outside of the document")
+    {
+        ColumnCache cache{document};
+
+        REQUIRE_FALSE(cache.isColumnarArray(array));
+        REQUIRE(cache.column(array, "id") == nullptr);
+    }
+
+    SECTION("doesn't create columns for arrays with non object items")
+    {
+        Json mixedDocument = document;
+        mixedDocument["array"].push_back(1);
+        ColumnCache cache{mixedDocument};
+
+        REQUIRE(cache.column(mixedDocument["array"], "id") == nullptr);
+    }
+
+    SECTION("can be cleared")
+    {
+        ColumnCache cache{document};
+        cache.column(documentArray, "id");
+
+        cache.clear();
+
+        REQUIRE(cache.size() == 0);
+    }
+}
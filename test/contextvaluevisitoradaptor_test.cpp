@@ -111,6 +111,48 @@ TEST_CASE("ContextValueVisitorAdaptor")
 
        REQUIRE(jsonFunctionCalled);
     }
+
+    SECTION("calls visitor with rvalue ref of unshared value in ContextValue")
+    {
+        Json movedValue;
+        auto visitor = boost::hana::overload(
+            [](const Json&){},
+            [&](Json&& value){
+                movedValue = std::move(value);
+            }
+        );
+        AdaptorType<decltype(visitor)> adaptor(std::move(visitor));
+        auto sharedValue = makeSharedJson(Json{{"key", "value"}});
+        const Json* value = sharedValue.get();
+        ContextValue contextValue{std::move(sharedValue)};
+        REQUIRE(contextValue.which() == 2);
+
+        boost::apply_visitor(adaptor, contextValue);
+
+        REQUIRE(movedValue == Json{{"key", "value"}});
+        REQUIRE(*value == Json{});
+    }
+
+    SECTION("calls visitor with rvalue ref of the copy of shared value in "
+            "ContextValue")
+    {
+        Json movedValue;
+        auto visitor = boost::hana::overload(
+            [](const Json&){},
+            [&](Json&& value){
+                movedValue = std::move(value);
+            }
+        );
+        AdaptorType<decltype(visitor)> adaptor(std::move(visitor));
+        auto sharedValue = makeSharedJson(Json{{"key", "value"}});
+        ContextValue contextValue{sharedValue};
+        REQUIRE(contextValue.which() == 2);
+
+        boost::apply_visitor(adaptor, contextValue);
+
+        REQUIRE(movedValue == Json{{"key", "value"}});
+        REQUIRE(*sharedValue == Json{{"key", "value"}});
+    }
 }
 
 namespace {
@@ -0,0 +1,217 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "fakeit.hpp"
+#include <jmespath/jmespath.h>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Evaluator")
+{
+    using namespace jmespath;
+
+    Json document = {{"foo", {{"bar", "baz"}}}, {"items", {1, 2, 3}}};
+
+    SECTION("parses expressions")
+    {
+        Evaluator evaluator;
+
+        auto expression = evaluator.parse("foo.bar");
+
+        REQUIRE(expression == Expression{"foo.bar"});
+    }
+
+    SECTION("throws on invalid expressions")
+    {
+        Evaluator evaluator;
+
+        REQUIRE_THROWS_AS(evaluator.parse("foo."), SyntaxError);
+    }
+
+    SECTION("searches lvalue documents")
+    {
+        Evaluator evaluator;
+
+        REQUIRE(evaluator.search("foo.bar", document) == "baz");
+        REQUIRE(evaluator.search("items[1]", document) == 2);
+    }
+
+    SECTION("searches rvalue documents")
+    {
+        Evaluator evaluator;
+
+        REQUIRE(evaluator.search("items", std::move(document))
+                == "[1, 2, 3]"_json);
+    }
+
+    SECTION("searches columnar documents")
+    {
+        Evaluator evaluator;
+        ColumnarDocument columnarDocument{document};
+
+        REQUIRE(evaluator.search("foo.bar", columnarDocument) == "baz");
+    }
+
+    SECTION("returns null for empty expressions")
+    {
+        Evaluator evaluator;
+
+        REQUIRE(evaluator.search(Expression{}, document) == Json{});
+    }
+
+    SECTION("writes results into outputs")
+    {
+        Evaluator evaluator;
+        const String expressions[] = {
+            "foo",
+            "items[*]",
+            "missing[*]",
+            "{z: foo.bar, a: items[?@ > `1`], z: items[0]}",
+            "{a: foo.bar, b: items[*], c: {d: items[0]}}",
+            "[foo.bar, items[:1], missing]",
+            "length(items)",
+            ""
+        };
+
+        for (const auto& expressionString: expressions)
+        {
+            Expression expression{expressionString};
+            auto expected = evaluator.search(expression, document).dump();
+            String stringOutput{"result: "};
+            std::ostringstream streamOutput;
+            String callbackOutput;
+
+            evaluator.search(expression, document, stringOutput);
+            evaluator.search(expression, document, streamOutput);
+            evaluator.search(expression, document,
+                             [&](const Char* data, size_t size) {
+                callbackOutput.append(data, size);
+            });
+
+            REQUIRE(stringOutput == "result: " + expected);
+            REQUIRE(streamOutput.str() == expected);
+            REQUIRE(callbackOutput == expected);
+        }
+    }
+
+    SECTION("writes hashes with repeated keys like search")
+    {
+        Evaluator evaluator;
+        Json input = R"({"x": "s"})"_json;
+        String output;
+
+        REQUIRE_THROWS_AS(evaluator.search("{a: abs(x), a: `1`}", input),
+                          InvalidFunctionArgumentType);
+        REQUIRE_THROWS_AS(evaluator.search("{a: abs(x), a: `1`}", input,
+                                           output),
+                          InvalidFunctionArgumentType);
+    }
+
+    SECTION("raises the same errors as search when writing hashes")
+    {
+        Evaluator evaluator;
+        Json input = R"({"x": "s"})"_json;
+        String output;
+
+        REQUIRE_THROWS_AS(evaluator.search("{z: abs(x), a: nosuchfn(x)}",
+                                           input),
+                          InvalidFunctionArgumentType);
+        REQUIRE_THROWS_AS(evaluator.search("{z: abs(x), a: nosuchfn(x)}",
+                                           input, output),
+                          InvalidFunctionArgumentType);
+    }
+
+    SECTION("can be passed to search")
+    {
+        Evaluator evaluator;
+
+        REQUIRE(search("foo.bar", document, evaluator) == "baz");
+    }
+
+    SECTION("can be used after an evaluation error")
+    {
+        Evaluator evaluator;
+
+        REQUIRE_THROWS_AS(evaluator.search("abs(foo)", document),
+                          InvalidFunctionArgumentType);
+        evaluator.reset();
+
+        REQUIRE(evaluator.search("items[0]", document) == 1);
+    }
+
+    SECTION("can be move constructed")
+    {
+        Evaluator evaluator;
+        evaluator.parse("foo");
+
+        Evaluator evaluator2{std::move(evaluator)};
+
+        REQUIRE(evaluator2.search("foo.bar", document) == "baz");
+        REQUIRE(evaluator.search("foo.bar", document) == "baz");
+    }
+
+    SECTION("can be used on a different thread than it was created on")
+    {
+        Evaluator evaluator;
+        Json result;
+
+        std::thread thread([&]() {
+            result = evaluator.search("items[-1]", document);
+        });
+        thread.join();
+
+        REQUIRE(result == 3);
+    }
+
+    SECTION("parses and evaluates concurrently with other evaluators")
+    {
+        std::vector<Json> results(4);
+        std::vector<std::thread> threads;
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            threads.emplace_back([&, i]() {
+                Evaluator evaluator;
+                for (int j = 0; j < 100; ++j)
+                {
+                    auto expression = evaluator.parse("sum(items) || foo");
+                    results[i] = evaluator.search(expression, document);
+                }
+            });
+        }
+        for (auto& thread: threads)
+        {
+            thread.join();
+        }
+
+        for (const auto& result: results)
+        {
+            REQUIRE(result == 6);
+        }
+    }
+}
@@ -28,6 +28,7 @@
 #include "fakeit.hpp"
 #include "jmespath/expression.h"
 #include "src/ast/allnodes.h"
+#include <unordered_set>
 
 TEST_CASE("Expression")
 {
@@ -189,4 +190,221 @@ TEST_CASE("Expression")
 
         REQUIRE_FALSE(exp.astRoot() == nullptr);
     }
+
+    SECTION("is interpreted by default")
+    {
+        Expression exp{"foo.bar"};
+
+        REQUIRE(exp.evaluationMode() == EvaluationMode::Interpreted);
+        REQUIRE(exp.compiledExpression() == nullptr);
+    }
+
+    SECTION("can be compiled")
+    {
+        Expression exp{"foo.bar"};
+
+        exp.setEvaluationMode(EvaluationMode::Compiled);
+
+        REQUIRE(exp.evaluationMode() == EvaluationMode::Compiled);
+        REQUIRE_FALSE(exp.compiledExpression() == nullptr);
+    }
+
+    SECTION("shares the compiled form with its copies")
+    {
+        Expression exp{"foo.bar"};
+        exp.setEvaluationMode(EvaluationMode::Compiled);
+
+        Expression exp2{exp};
+
+        REQUIRE(exp2.evaluationMode() == EvaluationMode::Compiled);
+        REQUIRE_FALSE(exp2.compiledExpression() == nullptr);
+        REQUIRE(exp2.compiledExpression() == exp.compiledExpression());
+    }
+
+    SECTION("shares its AST with its copies")
+    {
+        Expression exp{"foo[?bar == 'baz'].qux"};
+
+        Expression exp2{exp};
+        Expression exp3;
+        exp3 = exp;
+
+        REQUIRE(exp2.astRoot() == exp.astRoot());
+        REQUIRE(exp3.astRoot() == exp.astRoot());
+        REQUIRE(exp2 == exp);
+        REQUIRE(exp3.toString() == exp.toString());
+    }
+
+    SECTION("keeps the shared AST of copies when destroyed")
+    {
+        Expression exp2;
+        {
+            Expression exp{"foo.bar"};
+            exp2 = exp;
+        }
+
+        REQUIRE(exp2 == Expression{"foo.bar"});
+    }
+
+    SECTION("doesn't change its copies when reassigned")
+    {
+        Expression exp{"foo.bar"};
+        exp.setEvaluationMode(EvaluationMode::Compiled);
+        Expression exp2{exp};
+
+        exp = "baz";
+
+        REQUIRE(exp2 == Expression{"foo.bar"});
+        REQUIRE(exp2.evaluationMode() == EvaluationMode::Compiled);
+        REQUIRE_FALSE(exp2.compiledExpression() == nullptr);
+        REQUIRE(exp.toString() == "baz");
+    }
+
+    SECTION("changes only its own evaluation mode")
+    {
+        Expression exp{"foo.bar"};
+        Expression exp2{exp};
+
+        exp2.setEvaluationMode(EvaluationMode::Compiled);
+
+        REQUIRE(exp.evaluationMode() == EvaluationMode::Interpreted);
+        REQUIRE(exp.compiledExpression() == nullptr);
+        REQUIRE(exp2.astRoot() == exp.astRoot());
+    }
+
+    SECTION("keeps the compiled form when moved")
+    {
+        Expression exp{"foo.bar"};
+        exp.setEvaluationMode(EvaluationMode::Compiled);
+        auto compiledExpression = exp.compiledExpression();
+
+        Expression exp2{std::move(exp)};
+
+        REQUIRE(exp2.compiledExpression() == compiledExpression);
+    }
+
+    SECTION("is equivalent to expressions with the same canonical form")
+    {
+        Expression exp{"foo.bar"};
+        Expression exp2{"(foo).bar"};
+        Expression exp3{"@.foo . bar"};
+
+        REQUIRE_FALSE(exp2 == exp);
+        REQUIRE(exp2.isEquivalent(exp));
+        REQUIRE(exp3.isEquivalent(exp));
+        REQUIRE(exp2.structuralHash() == exp.structuralHash());
+        REQUIRE(exp3.structuralHash() == exp.structuralHash());
+    }
+
+    SECTION("isn't equivalent to expressions with a different canonical form")
+    {
+        Expression exp{"foo[*].bar"};
+        Expression exp2{"(foo[*]).bar"};
+
+        REQUIRE_FALSE(exp2.isEquivalent(exp));
+        REQUIRE_FALSE(Expression{}.isEquivalent(exp));
+    }
+
+    SECTION("can key unordered containers by equivalent expressions")
+    {
+        std::unordered_set<Expression,
+                           EquivalentExpressionHash,
+                           EquivalentExpressionEqual> expressions;
+
+        expressions.insert(Expression{"foo.bar"});
+        expressions.insert(Expression{"(foo).bar"});
+        expressions.insert(Expression{"@.foo.bar"});
+        expressions.insert(Expression{"foo.baz"});
+
+        REQUIRE(expressions.size() == 2);
+        REQUIRE(expressions.count(Expression{"foo.bar | @"}) == 1);
+    }
+
+    SECTION("can be encoded and decoded")
+    {
+        Expression exp{"foo[?bar == 'baz'].{a: length(@)}"};
+
+        std::vector<std::uint8_t> encoded = exp.toBinary();
+        Expression exp2 = Expression::fromBinary(encoded.data(),
+                                                 encoded.size());
+
+        REQUIRE(exp2 == exp);
+        REQUIRE(exp2.toString() == exp.toString());
+        REQUIRE(exp2.evaluationMode() == EvaluationMode::Interpreted);
+    }
+
+    SECTION("compiles decoded expressions which were compiled")
+    {
+        Expression exp{"foo.bar"};
+        exp.setEvaluationMode(EvaluationMode::Compiled);
+
+        std::vector<std::uint8_t> encoded = exp.toBinary();
+        Expression exp2 = Expression::fromBinary(encoded.data(),
+                                                 encoded.size());
+
+        REQUIRE(exp2 == exp);
+        REQUIRE(exp2.evaluationMode() == EvaluationMode::Compiled);
+        REQUIRE_FALSE(exp2.compiledExpression() == nullptr);
+    }
+
+    SECTION("can be encoded and decoded if empty")
+    {
+        Expression exp;
+
+        std::vector<std::uint8_t> encoded = exp.toBinary();
+        Expression exp2 = Expression::fromBinary(encoded.data(),
+                                                 encoded.size());
+
+        REQUIRE(exp2.isEmpty());
+    }
+
+    SECTION("throws when decoded from invalid data")
+    {
+        std::vector<std::uint8_t> encoded = Expression{"foo.bar"}.toBinary();
+        std::vector<std::uint8_t> newerVersion = encoded;
+        newerVersion[4] += 1;
+        std::vector<std::uint8_t> trailingData = encoded;
+        trailingData.push_back(0);
+
+        REQUIRE_THROWS_AS(Expression::fromBinary(encoded.data(), 0),
+                          InvalidAgrument);
+        REQUIRE_THROWS_AS(Expression::fromBinary(encoded.data(),
+                                                 encoded.size() - 1),
+                          InvalidAgrument);
+        REQUIRE_THROWS_AS(Expression::fromBinary(newerVersion.data(),
+                                                 newerVersion.size()),
+                          InvalidAgrument);
+        REQUIRE_THROWS_AS(Expression::fromBinary(trailingData.data(),
+                                                 trailingData.size()),
+                          InvalidAgrument);
+    }
+
+    SECTION("can be loaded in bulk")
+    {
+        std::vector<Expression> expressions;
+        std::vector<std::vector<std::uint8_t>> encodedExpressions;
+        for (int i = 0; i < 100; ++i)
+        {
+            expressions.emplace_back("items[" + std::to_string(i) + "].name");
+            encodedExpressions.push_back(expressions.back().toBinary());
+        }
+
+        for (unsigned threadCount: {0u, 1u, 3u, 200u})
+        {
+            REQUIRE(loadExpressions(encodedExpressions, threadCount)
+                    == expressions);
+        }
+        REQUIRE(loadExpressions({}, 200u).empty());
+    }
+
+    SECTION("throws when loading invalid expressions in bulk")
+    {
+        std::vector<std::vector<std::uint8_t>> encodedExpressions(
+            10,
+            Expression{"foo"}.toBinary());
+        encodedExpressions[7].clear();
+
+        REQUIRE_THROWS_AS(loadExpressions(encodedExpressions, 4),
+                          InvalidAgrument);
+    }
 }
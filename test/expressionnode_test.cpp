@@ -197,6 +197,31 @@ TEST_CASE("ExpressionNode")
         REQUIRE(node1 == node2);
     }
 
+    SECTION("can be move constructed")
+    {
+        ExpressionNode node1{IdentifierNode{"id"}};
+        ExpressionNode expected{node1};
+
+        ExpressionNode node2{std::move(node1)};
+
+        REQUIRE(node2 == expected);
+        REQUIRE(node1.isNull());
+    }
+
+    SECTION("accepts move assignment of another ExpressionNode")
+    {
+        ExpressionNode node1{IdentifierNode{}};
+        ExpressionNode node2{OrExpressionNode{
+            ExpressionNode{IdentifierNode{"a"}},
+            ExpressionNode{IdentifierNode{"b"}}}};
+        ExpressionNode expected{node2};
+
+        node1 = std::move(node2);
+
+        REQUIRE(node1 == expected);
+        REQUIRE(node2.isNull());
+    }
+
     SECTION("accepts assignment of an ExpressionNode::Expression")
     {
         ExpressionNode node1;
@@ -0,0 +1,105 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "fakeit.hpp"
+#include "src/interpreter/extremevalue.h"
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+TEST_CASE("ExtremeValue")
+{
+    using namespace jmespath::interpreter;
+
+    SECTION("finds the extreme integers")
+    {
+        std::mt19937_64 generator{42};
+        // small ranges produce equal higher halves, where the lower halves
+        // decide the order
+        const std::int64_t ranges[] = {
+            16,
+            std::int64_t{1} << 40,
+            std::numeric_limits<std::int64_t>::max()
+        };
+        for (std::int64_t range: ranges)
+        {
+            std::uniform_int_distribution<std::int64_t> distribution{
+                -range, range};
+            std::vector<std::int64_t> values;
+            for (size_t size = 1; size < 300; ++size)
+            {
+                values.push_back(distribution(generator));
+
+                REQUIRE(extremeValue(values.data(), size, false)
+                        == *std::max_element(values.begin(), values.end()));
+                REQUIRE(extremeValue(values.data(), size, true)
+                        == *std::min_element(values.begin(), values.end()));
+            }
+        }
+    }
+
+    SECTION("finds the limits of integers")
+    {
+        std::vector<std::int64_t> values(17, 0);
+        values[5] = std::numeric_limits<std::int64_t>::min();
+        values[11] = std::numeric_limits<std::int64_t>::max();
+
+        REQUIRE(extremeValue(values.data(), values.size(), false)
+                == std::numeric_limits<std::int64_t>::max());
+        REQUIRE(extremeValue(values.data(), values.size(), true)
+                == std::numeric_limits<std::int64_t>::min());
+    }
+
+    SECTION("finds the extreme floating point numbers")
+    {
+        std::mt19937_64 generator{42};
+        std::uniform_real_distribution<double> distribution{-1e6, 1e6};
+        std::vector<double> values;
+        for (size_t size = 1; size < 300; ++size)
+        {
+            values.push_back(distribution(generator));
+
+            REQUIRE(extremeValue(values.data(), size, false)
+                    == *std::max_element(values.begin(), values.end()));
+            REQUIRE(extremeValue(values.data(), size, true)
+                    == *std::min_element(values.begin(), values.end()));
+        }
+    }
+
+    SECTION("finds infinite floating point numbers")
+    {
+        std::vector<double> values(9, 1.5);
+        values[2] = -std::numeric_limits<double>::infinity();
+        values[7] = std::numeric_limits<double>::infinity();
+
+        REQUIRE(extremeValue(values.data(), values.size(), false)
+                == std::numeric_limits<double>::infinity());
+        REQUIRE(extremeValue(values.data(), values.size(), true)
+                == -std::numeric_limits<double>::infinity());
+    }
+}
@@ -0,0 +1,392 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "fakeit.hpp"
+#include <jmespath/jmespath.h>
+#include "src/interpreter/frozenlayout.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+TEST_CASE("FrozenDocument")
+{
+    using namespace jmespath;
+
+    Json jsonDocument = R"({
+        "config": {
+            "name": "service",
+            "title": "Gr\u00f6\u00dfe \u2603 \ud83d\ude00",
+            "port": 8080,
+            "ratio": 0.5,
+            "offset": -2,
+            "enabled": true,
+            "nothing": null,
+            "hosts": ["a", "b", "c"],
+            "empty": {}
+        },
+        "records": [
+            {"id": 1, "tags": ["x", "y"], "active": true},
+            {"id": 2, "tags": [], "active": false},
+            {"id": 3, "tags": ["x"]}
+        ]
+    })"_json;
+
+    SECTION("can be constructed with a document")
+    {
+        FrozenDocument document{jsonDocument};
+
+        REQUIRE(document.toJson() == jsonDocument);
+        REQUIRE(document.size() > 0);
+    }
+
+    SECTION("holds null by default")
+    {
+        FrozenDocument document;
+
+        REQUIRE(document.toJson() == Json{});
+    }
+
+    SECTION("can be created from JSON text")
+    {
+        auto document = FrozenDocument::fromText(jsonDocument.dump());
+
+        REQUIRE(document.toJson() == jsonDocument);
+    }
+
+    SECTION("keeps the last value of repeated keys in JSON text")
+    {
+        auto document = FrozenDocument::fromText(R"({"b": 1, "a": 2, "b": 3})");
+
+        REQUIRE(document.toJson() == R"({"a": 2, "b": 3})"_json);
+    }
+
+    SECTION("throws on invalid JSON text")
+    {
+        REQUIRE_THROWS_AS(FrozenDocument::fromText("{\"a\": "),
+                          nlohmann::json::parse_error);
+    }
+
+    SECTION("can be created from binary formats")
+    {
+        const std::pair<BinaryFormat, std::vector<std::uint8_t>> encodings[] = {
+            {BinaryFormat::Cbor, Json::to_cbor(jsonDocument)},
+            {BinaryFormat::MessagePack, Json::to_msgpack(jsonDocument)},
+            {BinaryFormat::Bson, Json::to_bson(jsonDocument)},
+            {BinaryFormat::Ubjson, Json::to_ubjson(jsonDocument)}
+        };
+
+        for (const auto& encoding: encodings)
+        {
+            auto document = FrozenDocument::fromBinary(encoding.second.data(),
+                                                       encoding.second.size(),
+                                                       encoding.first);
+
+            REQUIRE(document.toJson() == jsonDocument);
+        }
+    }
+
+    SECTION("throws on invalid binary data")
+    {
+        auto data = Json::to_msgpack(jsonDocument);
+        data.resize(data.size() / 2);
+
+        REQUIRE_THROWS_AS(FrozenDocument::fromBinary(data.data(),
+                                                     data.size(),
+                                                     BinaryFormat::MessagePack),
+                          nlohmann::json::parse_error);
+    }
+
+    SECTION("reports parser errors with their original type")
+    {
+        interpreter::FrozenLayoutBuilder builder;
+
+        REQUIRE_THROWS_AS(builder.parse_error(
+                              0, "", Json::out_of_range::create(408, "size",
+                                                                nullptr)),
+                          Json::out_of_range);
+        REQUIRE_THROWS_AS(builder.parse_error(
+                              0, "", Json::parse_error::create(101, 0, "token",
+                                                               nullptr)),
+                          Json::parse_error);
+    }
+
+    SECTION("copies share the same buffer")
+    {
+        FrozenDocument document{jsonDocument};
+
+        FrozenDocument document2{document};
+
+        REQUIRE(document2.data() == document.data());
+    }
+
+    SECTION("can be saved and mapped from a file")
+    {
+        const String path{"frozendocument_test.frozen"};
+        FrozenDocument{jsonDocument}.save(path);
+
+        auto document = FrozenDocument::map(path);
+
+        REQUIRE(document.toJson() == jsonDocument);
+        REQUIRE(search("records[?active].tags[]", document)
+                == search("records[?active].tags[]", jsonDocument));
+        document = FrozenDocument::map(path, MappingValidation::HeaderOnly);
+        REQUIRE(document.toJson() == jsonDocument);
+        document = FrozenDocument{};
+        std::remove(path.c_str());
+    }
+
+    SECTION("throws on mapping a file which isn't a frozen document")
+    {
+        const String path{"frozendocument_test.json"};
+        std::ofstream{path} << jsonDocument;
+
+        REQUIRE_THROWS_AS(FrozenDocument::map(path), InvalidAgrument);
+        REQUIRE_THROWS_AS(FrozenDocument::map(path,
+                                              MappingValidation::HeaderOnly),
+                          InvalidAgrument);
+        std::remove(path.c_str());
+    }
+
+    SECTION("throws on mapping a corrupted frozen document")
+    {
+        using interpreter::FrozenLayout;
+        const String path{"frozendocument_test.frozen"};
+        // the entries of {"a": ["b"], "c": null} are the object, the array,
+        // the string and the null, followed by the single item and the two
+        // members
+        auto mapCorrupted = [&](auto corrupt) {
+            auto buffer = interpreter::FrozenLayoutBuilder::build(
+                R"({"a": ["b"], "c": null})"_json);
+            auto bytes = reinterpret_cast<unsigned char*>(buffer.data());
+            auto entries = reinterpret_cast<FrozenLayout::Entry*>(
+                bytes + sizeof(FrozenLayout::Header));
+            auto items = reinterpret_cast<std::uint32_t*>(entries + 4);
+            auto members = reinterpret_cast<FrozenLayout::Member*>(items + 2);
+            corrupt(entries, items, members);
+            std::ofstream{path, std::ios::binary}.write(
+                reinterpret_cast<const char*>(bytes),
+                static_cast<std::streamsize>(buffer.size() * 8));
+            return FrozenDocument::map(path);
+        };
+
+        REQUIRE(mapCorrupted([](auto, auto, auto) {}).toJson()
+                == R"({"a": ["b"], "c": null})"_json);
+        REQUIRE_THROWS_AS(mapCorrupted([](auto, auto items, auto) {
+            items[0] = 1;
+        }), InvalidAgrument);
+        REQUIRE_THROWS_AS(mapCorrupted([](auto, auto items, auto) {
+            items[0] = 0;
+        }), InvalidAgrument);
+        REQUIRE_THROWS_AS(mapCorrupted([](auto entries, auto, auto) {
+            entries[2].payload = 1000;
+        }), InvalidAgrument);
+        REQUIRE_THROWS_AS(mapCorrupted([](auto entries, auto, auto) {
+            entries[1].size = 2;
+        }), InvalidAgrument);
+        REQUIRE_THROWS_AS(mapCorrupted([](auto, auto, auto members) {
+            members[0].keyLength = 1000;
+        }), InvalidAgrument);
+        REQUIRE_THROWS_AS(mapCorrupted([](auto entries, auto, auto) {
+            entries[0].type = static_cast<FrozenLayout::Type>(0xff);
+        }), InvalidAgrument);
+        REQUIRE_THROWS_AS(mapCorrupted([](auto entries, auto, auto) {
+            entries[2].flags |= 0x80;
+        }), InvalidAgrument);
+        REQUIRE_THROWS_AS(mapCorrupted([](auto entries, auto, auto) {
+            entries[0].flags = FrozenLayout::asciiFlag;
+        }), InvalidAgrument);
+        REQUIRE_THROWS_AS(mapCorrupted([](auto, auto, auto members) {
+            std::swap(members[0], members[1]);
+        }), InvalidAgrument);
+        REQUIRE_THROWS_AS(mapCorrupted([](auto, auto, auto members) {
+            members[1].keyOffset = members[0].keyOffset;
+        }), InvalidAgrument);
+        std::remove(path.c_str());
+    }
+
+    SECTION("limits the nesting depth of documents")
+    {
+        using interpreter::FrozenLayout;
+        const String path{"frozendocument_test.frozen"};
+        // the innermost array of the nested arrays is at the given depth
+        auto nestedArrays = [](size_t depth) {
+            Json document = Json::array();
+            for (size_t i = 0; i < depth; ++i)
+            {
+                document = Json::array({std::move(document)});
+            }
+            return document;
+        };
+        Json document = nestedArrays(FrozenLayout::maxDepth - 1);
+        document = Json::array({std::move(document), nullptr});
+        auto buffer = interpreter::FrozenLayoutBuilder::build(document);
+        auto bytes = reinterpret_cast<unsigned char*>(buffer.data());
+        auto entries = reinterpret_cast<FrozenLayout::Entry*>(
+            bytes + sizeof(FrozenLayout::Header));
+        auto items = reinterpret_cast<std::uint32_t*>(
+            entries + FrozenLayout::maxDepth + 2);
+        auto save = [&]() {
+            std::ofstream{path, std::ios::binary}.write(
+                reinterpret_cast<const char*>(bytes),
+                static_cast<std::streamsize>(buffer.size() * 8));
+        };
+        save();
+        REQUIRE(FrozenDocument::map(path).toJson() == document);
+        // move the null from the root into the innermost array, which is at
+        // the maximum depth
+        const std::uint32_t nullIndex = FrozenLayout::maxDepth + 1;
+        auto nullItem = std::find(items, items + FrozenLayout::maxDepth + 1,
+                                  nullIndex);
+        entries[0].size = 1;
+        entries[FrozenLayout::maxDepth].size = 1;
+        entries[FrozenLayout::maxDepth].payload
+            = static_cast<std::uint64_t>(nullItem - items);
+        save();
+
+        REQUIRE(FrozenDocument{nestedArrays(FrozenLayout::maxDepth)}.toJson()
+                == nestedArrays(FrozenLayout::maxDepth));
+        REQUIRE_THROWS_AS(
+            FrozenDocument{nestedArrays(FrozenLayout::maxDepth + 1)},
+            InvalidValue);
+        REQUIRE_THROWS_AS(FrozenDocument::map(path), InvalidAgrument);
+        std::remove(path.c_str());
+    }
+
+    SECTION("evaluates expressions like the interpreter")
+    {
+        FrozenDocument document{jsonDocument};
+        const String expressions[] = {
+            "config.port",
+            "config.hosts[-1]",
+            "config.hosts[5]",
+            "config.missing.field",
+            "config.*",
+            "records[*].id",
+            "records[?active].tags[]",
+            "records[].tags[]",
+            "records[::-2].id",
+            "records[*].[id, active]",
+            "config.{n: name, p: port}",
+            "config.enabled && config.name",
+            "config.empty || config.offset",
+            "!config.nothing",
+            "config.port > config.ratio",
+            "length(records[?tags[0] == 'x'])",
+            "length(config.title)",
+            "length(config.name)",
+            "length(config.hosts)",
+            "length(config)",
+            "length(`\"\u00e9\"`)",
+            "sort_by(records, &id)[-1].id",
+            "sort_by(records, &to_string(id))[*].id",
+            "max_by(records, &id).tags",
+            "min_by(records, &id).tags[0]",
+            "max_by(records[?active], &id).id",
+            "map(&tags[0], records)",
+            "map(&length(@), config.hosts)",
+            "records[*].tags[] | [1]",
+            "records[].tags[0:1] | [:1]",
+            "(records[*].id) | [0]",
+            "not_null(config.nothing, config.name)",
+            "records | [0].tags",
+            "`[1, 2]`[*]",
+            "@"
+        };
+
+        for (const auto& expressionString: expressions)
+        {
+            Expression expression{expressionString};
+
+            auto result = search(expression, document);
+
+            REQUIRE(result == search(expression, jsonDocument));
+        }
+    }
+
+    SECTION("stops evaluating the left side of limited pipes")
+    {
+        Json mixedItems = R"([-1, "x", null])"_json;
+        Json mixedRecords = R"({"items": [{"v": -1}, {"v": "x"}]})"_json;
+        const String itemExpressions[] = {
+            "[*].abs(@) | [0]",
+            "[].abs(@)|[0]",
+            "[0:5].abs(@)|[0]",
+            "[?abs(@) > `0`]|[0]"
+        };
+        const String recordExpressions[] = {
+            "items[*].abs(v)|[0]",
+            "items[*].{a: abs(v)}|[0]",
+            "(items[*].abs(v))|[0]"
+        };
+
+        for (const auto& expressionString: itemExpressions)
+        {
+            Expression expression{expressionString};
+
+            REQUIRE(search(expression, FrozenDocument{mixedItems})
+                    == search(expression, mixedItems));
+        }
+        for (const auto& expressionString: recordExpressions)
+        {
+            Expression expression{expressionString};
+
+            REQUIRE(search(expression, FrozenDocument{mixedRecords})
+                    == search(expression, mixedRecords));
+        }
+    }
+
+    SECTION("throws the same errors as the interpreter")
+    {
+        FrozenDocument document{jsonDocument};
+
+        REQUIRE_THROWS_AS(search("records[::0]", document), InvalidValue);
+        REQUIRE_THROWS_AS(search("unknown(config)", document),
+                          UnknownFunction);
+        REQUIRE_THROWS_AS(search("length(config.port)", document),
+                          InvalidFunctionArgumentType);
+        REQUIRE_THROWS_AS(search("sort_by(records, &tags)", document),
+                          InvalidFunctionArgumentType);
+        REQUIRE_THROWS_AS(search("max_by(records, &active)", document),
+                          InvalidFunctionArgumentType);
+        REQUIRE_THROWS_AS(search("sort_by(config, &id)", document),
+                          InvalidFunctionArgumentType);
+        REQUIRE_THROWS_AS(search("map(&id, config)", document),
+                          InvalidFunctionArgumentType);
+        REQUIRE_THROWS_AS(search("sort_by(records, id)", document),
+                          InvalidFunctionArgumentType);
+    }
+
+    SECTION("can be searched with an evaluator")
+    {
+        FrozenDocument document{jsonDocument};
+        Evaluator evaluator;
+
+        auto result = search("config.hosts[0]", document, evaluator);
+
+        REQUIRE(result == "a");
+    }
+}
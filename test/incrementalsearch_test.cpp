@@ -0,0 +1,199 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "fakeit.hpp"
+#include <jmespath/jmespath.h>
+
+TEST_CASE("IncrementalSearch")
+{
+    using namespace jmespath;
+
+    Json jsonDocument = R"({
+        "config": {"name": "service", "port": 8080},
+        "records": [
+            {"id": 1, "tags": ["a", "b"]},
+            {"id": 2, "tags": []}
+        ],
+        "a/b": {"~c": 1}
+    })"_json;
+
+    SECTION("evaluates added expressions")
+    {
+        IncrementalSearch search{jsonDocument};
+
+        auto index = search.addExpression("config.port");
+
+        REQUIRE(index == 0);
+        REQUIRE(search.expressionCount() == 1);
+        REQUIRE(search.result(index) == 8080);
+    }
+
+    SECTION("reports the expressions whose results changed")
+    {
+        IncrementalSearch search{jsonDocument};
+        search.addExpression("config.port");
+        search.addExpression("records[*].id");
+        search.addExpression("config.name");
+        search.addExpression("length(records[].tags[])");
+
+        auto changed = search.applyPatch(R"([
+            {"op": "replace", "path": "/config/port", "value": 80},
+            {"op": "add", "path": "/records/1/tags/-", "value": "c"}
+        ])"_json);
+
+        REQUIRE(changed == std::vector<size_t>{0, 3});
+        REQUIRE(search.result(0) == 80);
+        REQUIRE(search.result(1) == Json{1, 2});
+        REQUIRE(search.result(3) == 3);
+        REQUIRE(search.document()["records"][1]["tags"] == Json{"c"});
+    }
+
+    SECTION("tracks moved values and items shifted by insertions")
+    {
+        IncrementalSearch search{jsonDocument};
+        search.addExpression("records[-1].id");
+        search.addExpression("config.{n: name, p: port}");
+        search.addExpression("*.\"~c\"");
+
+        auto changed = search.applyPatch(R"([
+            {"op": "add", "path": "/records/0", "value": {"id": 0}},
+            {"op": "move", "from": "/config/name", "path": "/name"},
+            {"op": "replace", "path": "/a~1b/~0c", "value": 2}
+        ])"_json);
+
+        REQUIRE(changed == std::vector<size_t>{1, 2});
+        REQUIRE(search.result(0) == 2);
+        REQUIRE(search.result(1) == R"({"n": null, "p": 8080})"_json);
+        REQUIRE(search.result(2) == Json{2});
+    }
+
+    SECTION("leaves the document and the results unchanged on errors")
+    {
+        IncrementalSearch search{jsonDocument};
+        search.addExpression("config.port");
+
+        REQUIRE_THROWS_AS(search.applyPatch(R"([
+            {"op": "replace", "path": "/config/port", "value": 80},
+            {"op": "remove", "path": "/missing"}
+        ])"_json), nlohmann::json::exception);
+        REQUIRE_THROWS_AS(search.applyPatch(R"([
+            {"op": "replace", "path": "/config/port", "value": 80},
+            {"op": "test", "path": "/config/name", "value": "nope"}
+        ])"_json), nlohmann::json::exception);
+        REQUIRE(search.document() == jsonDocument);
+        REQUIRE(search.result(0) == 8080);
+    }
+
+    SECTION("undoes every kind of operation when a later one fails")
+    {
+        IncrementalSearch search{jsonDocument};
+        search.addExpression("records[].tags[]");
+
+        REQUIRE_THROWS_AS(search.applyPatch(R"([
+            {"op": "add", "path": "/records/0/tags/1", "value": "x"},
+            {"op": "add", "path": "/records/-", "value": {"id": 3}},
+            {"op": "add", "path": "/config/name", "value": "proxy"},
+            {"op": "add", "path": "/config/host", "value": "localhost"},
+            {"op": "remove", "path": "/records/0/tags/0"},
+            {"op": "replace", "path": "/a~1b", "value": null},
+            {"op": "add", "path": "/a~1b/d", "value": 1},
+            {"op": "move", "from": "/records/1", "path": "/moved"},
+            {"op": "copy", "from": "/config", "path": "/records/0/config"},
+            {"op": "test", "path": "/moved/id", "value": 3}
+        ])"_json), nlohmann::json::exception);
+        REQUIRE(search.document() == jsonDocument);
+        REQUIRE(search.result(0) == Json{"a", "b"});
+
+        auto changed = search.applyPatch(R"([
+            {"op": "add", "path": "/records/0/tags/1", "value": "x"},
+            {"op": "remove", "path": "/records/0/tags/0"},
+            {"op": "copy", "from": "/records/0/tags", "path": "/records/1/tags"},
+            {"op": "add", "path": "", "value": {"records": [{"tags": ["y"]}]}},
+            {"op": "test", "path": "/records/0/tags/0", "value": "y"}
+        ])"_json);
+
+        REQUIRE(changed == std::vector<size_t>{0});
+        REQUIRE(search.result(0) == Json{"y"});
+    }
+
+    SECTION("evaluates every affected expression when one of them fails")
+    {
+        IncrementalSearch search{jsonDocument};
+        search.addExpression("sort_by(records, &id)[].id");
+        search.addExpression("records[1:].id");
+
+        auto failedChanged = search.applyPatch(R"([
+            {"op": "replace", "path": "/records/1/id", "value": "x"}
+        ])"_json);
+
+        REQUIRE(failedChanged == std::vector<size_t>{0, 1});
+        REQUIRE_THROWS_AS(search.result(0), InvalidFunctionArgumentType);
+        REQUIRE(search.result(1) == R"(["x"])"_json);
+
+        auto changed = search.applyPatch(R"([
+            {"op": "replace", "path": "/records/1/id", "value": 3}
+        ])"_json);
+
+        REQUIRE(changed == std::vector<size_t>{0, 1});
+        REQUIRE(search.result(0) == R"([1, 3])"_json);
+        REQUIRE(search.result(1) == R"([3])"_json);
+    }
+
+    SECTION("applies unrelated patches after a failed evaluation")
+    {
+        IncrementalSearch search{jsonDocument};
+        search.addExpression("length(config.name)");
+        search.addExpression("config.port");
+
+        auto failedChanged = search.applyPatch(R"([
+            {"op": "replace", "path": "/config/name", "value": 5}
+        ])"_json);
+
+        REQUIRE(failedChanged == std::vector<size_t>{0});
+        REQUIRE_THROWS_AS(search.result(0), InvalidFunctionArgumentType);
+
+        auto changed = search.applyPatch(R"([
+            {"op": "replace", "path": "/config/port", "value": 80}
+        ])"_json);
+
+        REQUIRE(changed == std::vector<size_t>{1});
+        REQUIRE(search.result(1) == 80);
+        REQUIRE(search.document()["config"]["port"] == 80);
+        REQUIRE_THROWS_AS(search.result(0), InvalidFunctionArgumentType);
+    }
+
+    SECTION("can be move constructed")
+    {
+        IncrementalSearch search{jsonDocument};
+        search.addExpression("config.name");
+
+        IncrementalSearch search2{std::move(search)};
+
+        REQUIRE(search2.result(0) == "service");
+        REQUIRE(search.expressionCount() == 0);
+    }
+}
@@ -31,6 +31,8 @@
 #include "jmespath/exceptions.h"
 #include <fstream>
 #include <chrono>
+#include <cmath>
+#include <limits>
 #include <boost/range/algorithm.hpp>
 
 //namespace jmespath { namespace ast {
@@ -45,7 +47,9 @@ TEST_CASE("ContextValue")
 {
     using namespace jmespath;
     using jmespath::interpreter::JsonRef;
+    using jmespath::interpreter::JsonPtr;
     using jmespath::interpreter::ContextValue;
+    using jmespath::interpreter::makeSharedJson;
 
     SECTION("can be constructed with Json lvalue")
     {
@@ -75,6 +79,16 @@ TEST_CASE("ContextValue")
         REQUIRE(boost::get<const JsonRef&>(value) == jsonValue);
     }
 
+    SECTION("can be constructed with shared Json value")
+    {
+        auto sharedValue = makeSharedJson(Json{{"key", "value"}});
+
+        ContextValue value {sharedValue};
+
+        REQUIRE(value.which() == 2);
+        REQUIRE(*boost::get<const JsonPtr&>(value) == Json{{"key", "value"}});
+    }
+
     SECTION("can assing Json lvalue")
     {
         Json jsonValue {{"key", "value"}};
@@ -148,6 +162,7 @@ TEST_CASE("getJsonValue")
     using jmespath::interpreter::JsonRef;
     using jmespath::interpreter::ContextValue;
     using jmespath::interpreter::getJsonValue;
+    using jmespath::interpreter::makeSharedJson;
     Json jsonValue {{"key", "value"}};
 
     SECTION("returns const ref for Json value context")
@@ -167,6 +182,140 @@ TEST_CASE("getJsonValue")
 
         REQUIRE(result == jsonValue);
     }
+
+    SECTION("returns const ref for shared Json context")
+    {
+        ContextValue context {makeSharedJson(Json(jsonValue))};
+
+        const Json& result = getJsonValue(context);
+
+        REQUIRE(result == jsonValue);
+    }
+}
+
+TEST_CASE("takeJsonValue")
+{
+    using namespace jmespath;
+    using jmespath::interpreter::ContextValue;
+    using jmespath::interpreter::getJsonValue;
+    using jmespath::interpreter::takeJsonValue;
+    using jmespath::interpreter::makeSharedJson;
+    Json jsonValue {{"key", "value"}};
+
+    SECTION("moves Json value")
+    {
+        ContextValue context {Json(jsonValue)};
+
+        Json result = takeJsonValue(std::move(context));
+
+        REQUIRE(result == jsonValue);
+        REQUIRE(getJsonValue(context) == Json{});
+    }
+
+    SECTION("copies the value of Json reference_wrapper context")
+    {
+        ContextValue context {std::cref(jsonValue)};
+
+        Json result = takeJsonValue(std::move(context));
+
+        REQUIRE(result == jsonValue);
+        REQUIRE(jsonValue == Json{{"key", "value"}});
+    }
+
+    SECTION("moves the value of unshared Json context")
+    {
+        auto sharedValue = makeSharedJson(Json(jsonValue));
+        const Json* value = sharedValue.get();
+        ContextValue context {std::move(sharedValue)};
+
+        Json result = takeJsonValue(std::move(context));
+
+        REQUIRE(result == jsonValue);
+        REQUIRE(*value == Json{});
+    }
+
+    SECTION("copies the value of shared Json context")
+    {
+        auto sharedValue = makeSharedJson(Json(jsonValue));
+        ContextValue context {sharedValue};
+
+        Json result = takeJsonValue(std::move(context));
+
+        REQUIRE(result == jsonValue);
+        REQUIRE(*sharedValue == jsonValue);
+    }
+}
+
+TEST_CASE("detachResult")
+{
+    using namespace jmespath;
+    using jmespath::interpreter::JsonRef;
+    using jmespath::interpreter::JsonPtr;
+    using jmespath::interpreter::ContextValue;
+    using jmespath::interpreter::getJsonValue;
+    using jmespath::interpreter::detachResult;
+    using jmespath::interpreter::makeSharedJson;
+    Json jsonValue = "{\"key\": [1, 2, 3]}"_json;
+
+    SECTION("doesn't change results on Json reference_wrapper context")
+    {
+        ContextValue context {std::cref(jsonValue)};
+
+        ContextValue result = detachResult(std::move(context),
+                                           std::cref(jsonValue["key"]));
+
+        REQUIRE(result.which() == 1);
+        REQUIRE(&boost::get<JsonRef>(result).get() == &jsonValue["key"]);
+    }
+
+    SECTION("doesn't change Json value results")
+    {
+        ContextValue context {Json(jsonValue)};
+
+        ContextValue result = detachResult(std::move(context), Json{1});
+
+        REQUIRE(result.which() == 0);
+        REQUIRE(getJsonValue(result) == Json{1});
+    }
+
+    SECTION("moves the context if the result refers to it")
+    {
+        ContextValue context {Json(jsonValue)};
+        JsonRef resultRef = std::cref(getJsonValue(context));
+
+        ContextValue result = detachResult(std::move(context),
+                                           std::move(resultRef));
+
+        REQUIRE(result.which() == 0);
+        REQUIRE(getJsonValue(result) == jsonValue);
+    }
+
+    SECTION("shares the context with the result without copying")
+    {
+        ContextValue context {Json(jsonValue)};
+        const Json* item = &getJsonValue(context)["key"][1];
+
+        ContextValue result = detachResult(std::move(context),
+                                           std::cref(*item));
+
+        REQUIRE(result.which() == 2);
+        REQUIRE(boost::get<JsonPtr>(result).get() == item);
+        REQUIRE(*item == Json(2));
+    }
+
+    SECTION("shares the ownership of shared context with the result")
+    {
+        auto sharedValue = makeSharedJson(Json(jsonValue));
+        ContextValue context {sharedValue};
+        const Json* item = &(*sharedValue)["key"];
+
+        ContextValue result = detachResult(std::move(context),
+                                           std::cref(*item));
+
+        REQUIRE(result.which() == 2);
+        REQUIRE(boost::get<JsonPtr>(result).get() == item);
+        REQUIRE(sharedValue.use_count() == 2);
+    }
 }
 
 TEST_CASE("Interpreter")
@@ -282,6 +431,39 @@ TEST_CASE("Interpreter")
         REQUIRE(interpreter.currentContext() == Json{});
     }
 
+    SECTION("evaluates identifiers in large objects")
+    {
+        Json object(Json::value_t::object);
+        for (int i = 0; i < 300; ++i)
+        {
+            object["key" + std::to_string(i * 2)] = i;
+        }
+
+        for (int i = 0; i < 600; ++i)
+        {
+            ast::IdentifierNode node{"key" + std::to_string(i)};
+            interpreter.setContext(object);
+
+            interpreter.visit(&node);
+
+            // only the even keys are present
+            REQUIRE(interpreter.currentContext()
+                    == (i % 2 == 0 ? Json(i / 2) : Json{}));
+        }
+    }
+
+    SECTION("evaluates identifiers in moved objects to the moved values")
+    {
+        ast::IdentifierNode node{"b"};
+        String value(100, 'x');
+        interpreter.setContext(Json{{"a", 1}, {"b", value}, {"c", 3}});
+
+        interpreter.visit(&node);
+
+        REQUIRE(interpreter.currentContextValue().which() == 0);
+        REQUIRE(interpreter.currentContext() == value);
+    }
+
     SECTION("evaluates identifier on non object to null")
     {
         ast::IdentifierNode node{"identifier"};
@@ -386,7 +568,8 @@ TEST_CASE("Interpreter")
         VerifyNoOtherInvocations(interpreterMock);
     }
 
-    SECTION("evaluates projected index expression")
+    SECTION("evaluates projected index expression by streaming the items "
+            "through the bracket specifier")
     {
         ast::IndexExpressionNode node{
             ast::ExpressionNode{},
@@ -394,29 +577,20 @@ TEST_CASE("Interpreter")
                 ast::FlattenOperatorNode{}},
             ast::ExpressionNode{}};
         Mock<Interpreter> interpreterMock(interpreter);
-        interpreterMock.get().setContext("[1, 2, 3]"_json);
-        When(OverloadedMethod(interpreterMock, visit,
-                              void(const ast::ExpressionNode*)))
-                .AlwaysReturn();
+        interpreterMock.get().setContext("[1, [2, 3]]"_json);
         When(OverloadedMethod(interpreterMock, visit,
-                              void(const ast::BracketSpecifierNode*)))
-                .AlwaysReturn();
-        When(OverloadedMethod(interpreterMock, evaluateProjection,
                               void(const ast::ExpressionNode*)))
                 .AlwaysReturn();
 
         interpreterMock.get().visit(&node);
 
+        REQUIRE(interpreterMock.get().currentContext() == "[1, 2, 3]"_json);
         Verify(OverloadedMethod(interpreterMock, visit,
                                 void(const ast::ExpressionNode*))
-                    .Using(&node.leftExpression)
-               + OverloadedMethod(interpreterMock, visit,
-                                  void(const ast::BracketSpecifierNode*))
-                    .Using(&node.bracketSpecifier)
-               + OverloadedMethod(interpreterMock, evaluateProjection,
-                                  void(const ast::ExpressionNode*))
-                    .Using(&node.rightExpression))
-                .Once();
+                    .Using(&node.leftExpression)).Once();
+        Verify(OverloadedMethod(interpreterMock, visit,
+                                void(const ast::ExpressionNode*))
+                    .Using(&node.rightExpression)).Exactly(3);
         VerifyNoOtherInvocations(interpreterMock);
     }
 
@@ -884,6 +1058,24 @@ TEST_CASE("Interpreter")
                 == "{\"id1\":\"value2\",\"id3\":\"value4\"}"_json);
     }
 
+    SECTION("evaluates multiselect hash with repeated keys by keeping the "
+            "last value")
+    {
+        interpreter.setContext("{\"id2\":\"value2\", \"id4\":\"value4\"}"_json);
+        ast::MultiselectHashNode node{
+                {ast::IdentifierNode{"id1"},
+                 ast::ExpressionNode{
+                    ast::IdentifierNode{"id2"}}},
+                {ast::IdentifierNode{"id1"},
+                 ast::ExpressionNode{
+                    ast::IdentifierNode{"id4"}}}};
+
+        interpreter.visit(&node);
+
+        REQUIRE(interpreter.currentContext()
+                == "{\"id1\":\"value4\"}"_json);
+    }
+
     SECTION("evaluates child expression of not expression")
     {
         ast::NotExpressionNode node;
@@ -1429,7 +1621,7 @@ TEST_CASE("Interpreter")
 
         interpreter.visit(&node);
 
-        REQUIRE(interpreter.currentContextValue().which() == 0);
+        REQUIRE(interpreter.currentContextValue().which() == 2);
         REQUIRE(interpreter.currentContext() == expectedResult);
     }
 
@@ -1556,7 +1748,7 @@ TEST_CASE("Interpreter")
 
         interpreter.visit(&node);
 
-        REQUIRE(interpreter.currentContextValue().which() == 0);
+        REQUIRE(interpreter.currentContextValue().which() == 2);
         REQUIRE(interpreter.currentContext() == expectedResult);
     }
 
@@ -1609,6 +1801,97 @@ TEST_CASE("Interpreter")
         REQUIRE(interpreter.currentContext() == expectedResult);
     }
 
+    SECTION("evaluates only the needed items of a projection on the left "
+            "side of a pipe expression ending in an array item expression")
+    {
+        ast::PipeExpressionNode node{
+            ast::ExpressionNode{
+                ast::IndexExpressionNode{
+                    ast::ExpressionNode{
+                        ast::IdentifierNode{"items"}},
+                    ast::BracketSpecifierNode{
+                        ast::ListWildcardNode{}},
+                    ast::ExpressionNode{
+                        ast::FunctionExpressionNode{
+                            "abs",
+                            {ast::ExpressionNode{
+                                ast::CurrentNode{}}}}}}},
+            ast::ExpressionNode{
+                ast::IndexExpressionNode{
+                    ast::BracketSpecifierNode{
+                        ast::ArrayItemNode{1}}}}};
+        interpreter.setContext("{\"items\": [-1, -2, \"three\"]}"_json);
+
+        interpreter.visit(&node);
+
+        REQUIRE(interpreter.currentContext() == 2);
+    }
+
+    SECTION("evaluates only the needed items of a flattened projection on the "
+            "left side of a pipe expression ending in a slice expression")
+    {
+        ast::PipeExpressionNode node{
+            ast::ExpressionNode{
+                ast::IndexExpressionNode{
+                    ast::ExpressionNode{
+                        ast::IndexExpressionNode{
+                            ast::ExpressionNode{
+                                ast::IdentifierNode{"items"}},
+                            ast::BracketSpecifierNode{
+                                ast::ListWildcardNode{}},
+                            ast::ExpressionNode{
+                                ast::FunctionExpressionNode{
+                                    "to_array",
+                                    {ast::ExpressionNode{
+                                        ast::CurrentNode{}}}}}}},
+                    ast::BracketSpecifierNode{
+                        ast::FlattenOperatorNode{}},
+                    ast::ExpressionNode{
+                        ast::FunctionExpressionNode{
+                            "abs",
+                            {ast::ExpressionNode{
+                                ast::CurrentNode{}}}}}}},
+            ast::ExpressionNode{
+                ast::IndexExpressionNode{
+                    ast::BracketSpecifierNode{
+                        ast::SliceExpressionNode{Index{1}, Index{3}}}}}};
+        interpreter.setContext(
+            "{\"items\": [[-1, -2], -3, [-4, \"five\"]]}"_json);
+
+        interpreter.visit(&node);
+
+        REQUIRE(interpreter.currentContext() == "[2, 3]"_json);
+    }
+
+    SECTION("evaluates only the needed items of a parenthesized filter "
+            "expression on the left side of a pipe expression")
+    {
+        ast::PipeExpressionNode node{
+            ast::ExpressionNode{
+                ast::ParenExpressionNode{
+                    ast::ExpressionNode{
+                        ast::IndexExpressionNode{
+                            ast::ExpressionNode{
+                                ast::IdentifierNode{"items"}},
+                            ast::BracketSpecifierNode{
+                                ast::FilterExpressionNode{
+                                    ast::ExpressionNode{
+                                        ast::FunctionExpressionNode{
+                                            "abs",
+                                            {ast::ExpressionNode{
+                                                ast::CurrentNode{}}}}}}},
+                            ast::ExpressionNode{}}}}},
+            ast::ExpressionNode{
+                ast::IndexExpressionNode{
+                    ast::BracketSpecifierNode{
+                        ast::ArrayItemNode{0}}}}};
+        interpreter.setContext("{\"items\": [-1, \"two\"]}"_json);
+
+        interpreter.visit(&node);
+
+        REQUIRE(interpreter.currentContext() == -1);
+    }
+
     SECTION("evaluates current node expression")
     {
         ast::CurrentNode node;
@@ -2539,6 +2822,61 @@ TEST_CASE("Interpreter")
         REQUIRE(interpreter.currentContext() == "null"_json);
     }
 
+    SECTION("evaluates max function on mixed integer and float array")
+    {
+        ast::FunctionExpressionNode node{
+            "max",
+            {ast::ExpressionNode{
+                ast::LiteralNode{"[2, -3, 4.5, 1, 4.5]"}}}};
+
+        interpreter.visit(&node);
+
+        REQUIRE(interpreter.currentContext() == "4.5"_json);
+        REQUIRE(interpreter.currentContext().is_number_float());
+    }
+
+    SECTION("evaluates max function on mixed signed and unsigned array")
+    {
+        ast::FunctionExpressionNode node{
+            "max",
+            {ast::ExpressionNode{
+                ast::LiteralNode{"[-2, 18446744073709551615, 3]"}}}};
+
+        interpreter.visit(&node);
+
+        REQUIRE(interpreter.currentContext()
+                == "18446744073709551615"_json);
+    }
+
+    SECTION("evaluates max function to the first of equal items in long arrays")
+    {
+        Json integers(Json::value_t::array);
+        Json floats(Json::value_t::array);
+        for (int i = 0; i < 1000; ++i)
+        {
+            integers.push_back(-i);
+            floats.push_back(-i - 0.5);
+        }
+        // the signed and unsigned, and the negative and positive zeros are
+        // equal, but they can be told apart
+        integers[300] = 5u;
+        integers[700] = 5;
+        floats[300] = 0.0;
+        floats[700] = -0.0;
+        ast::FunctionExpressionNode integerNode{
+            "max", {ast::ExpressionNode{ast::LiteralNode{integers.dump()}}}};
+        ast::FunctionExpressionNode floatNode{
+            "max", {ast::ExpressionNode{ast::LiteralNode{floats.dump()}}}};
+
+        interpreter.visit(&integerNode);
+        REQUIRE(interpreter.currentContext() == "5"_json);
+        REQUIRE(interpreter.currentContext().is_number_unsigned());
+        interpreter.visit(&floatNode);
+        REQUIRE(interpreter.currentContext() == "0.0"_json);
+        REQUIRE_FALSE(std::signbit(
+            interpreter.currentContext().get<double>()));
+    }
+
     SECTION("max_by function throws on invalid number of arguments")
     {
         ast::FunctionExpressionNode node0{"max_by"};
@@ -2767,6 +3105,57 @@ TEST_CASE("Interpreter")
         REQUIRE(interpreter.currentContext() == "1"_json);
     }
 
+    SECTION("evaluates min function on mixed number array")
+    {
+        ast::FunctionExpressionNode node{
+            "min",
+            {ast::ExpressionNode{
+                ast::LiteralNode{"[5, -2, 7, -2.0, -1]"}}}};
+
+        interpreter.visit(&node);
+
+        REQUIRE(interpreter.currentContext() == "-2"_json);
+        REQUIRE(interpreter.currentContext().is_number_integer());
+    }
+
+    SECTION("evaluates min function to the first of equal items in long arrays")
+    {
+        Json integers(Json::value_t::array);
+        Json floats(Json::value_t::array);
+        for (int i = 0; i < 1000; ++i)
+        {
+            integers.push_back(i);
+            floats.push_back(i + 0.5);
+        }
+        integers[300] = -5;
+        integers[700] = -5;
+        integers[900] = 18;
+        floats[300] = -0.0;
+        floats[700] = 0.0;
+        ast::FunctionExpressionNode integerNode{
+            "min", {ast::ExpressionNode{ast::LiteralNode{integers.dump()}}}};
+        ast::FunctionExpressionNode floatNode{
+            "min", {ast::ExpressionNode{ast::LiteralNode{floats.dump()}}}};
+
+        interpreter.visit(&integerNode);
+        REQUIRE(interpreter.currentContext() == "-5"_json);
+        interpreter.visit(&floatNode);
+        REQUIRE(interpreter.currentContext() == "-0.0"_json);
+        REQUIRE(std::signbit(interpreter.currentContext().get<double>()));
+    }
+
+    SECTION("evaluates min function on float array with NaN")
+    {
+        Json floats = {std::numeric_limits<double>::quiet_NaN(), 2.5, 1.5};
+        interpreter.setContext(floats);
+        ast::FunctionExpressionNode node{
+            "min", {ast::ExpressionNode{ast::CurrentNode{}}}};
+
+        interpreter.visit(&node);
+
+        REQUIRE(std::isnan(interpreter.currentContext().get<double>()));
+    }
+
     SECTION("evaluates min function on string array with rvalue")
     {
         ast::FunctionExpressionNode node{
@@ -2971,6 +3360,41 @@ TEST_CASE("Interpreter")
         REQUIRE(interpreter.currentContext() == "null"_json);
     }
 
+    SECTION("not_null function doesn't evaluate the arguments after the "
+            "first non null value")
+    {
+        ast::FunctionExpressionNode node{
+            "not_null",
+            {ast::ExpressionNode{
+                ast::LiteralNode{"null"}},
+            ast::ExpressionNode{
+                ast::LiteralNode{"1"}},
+            ast::ExpressionNode{
+                ast::FunctionExpressionNode{
+                    "abs",
+                    {ast::ExpressionNode{
+                        ast::LiteralNode{"\"string\""}}}}}}};
+
+        interpreter.visit(&node);
+
+        REQUIRE(interpreter.currentContext() == 1);
+    }
+
+    SECTION("evaluates not_null function with rvalue context")
+    {
+        ast::FunctionExpressionNode node{
+            "not_null",
+            {ast::ExpressionNode{
+                ast::IdentifierNode{"a"}},
+            ast::ExpressionNode{
+                ast::IdentifierNode{"b"}}}};
+        interpreter.setContext("{\"a\": null, \"b\": [1, 2]}"_json);
+
+        interpreter.visit(&node);
+
+        REQUIRE(interpreter.currentContext() == "[1, 2]"_json);
+    }
+
     SECTION("reverse function throws on invalid number of arguments")
     {
         ast::FunctionExpressionNode node0{"reverse"};
@@ -3381,6 +3805,18 @@ TEST_CASE("Interpreter")
         REQUIRE(interpreter.currentContext() == "-4"_json);
     }
 
+    SECTION("evaluates sum function with the precision of floats")
+    {
+        ast::FunctionExpressionNode node{
+            "sum",
+            {ast::ExpressionNode{
+                ast::LiteralNode{"[9007199254740993, 1, -1]"}}}};
+
+        interpreter.visit(&node);
+
+        REQUIRE(interpreter.currentContext() == Json(9007199254740991.0));
+    }
+
     SECTION("to_array function throws on invalid number of arguments")
     {
         ast::FunctionExpressionNode node1{
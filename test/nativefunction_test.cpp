@@ -0,0 +1,163 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "fakeit.hpp"
+#include <jmespath/jmespath.h>
+
+TEST_CASE("NativeFunction")
+{
+    using namespace jmespath;
+
+    Json document = R"({
+        "prices": [10, 20, 30],
+        "name": "widget",
+        "tags": ["a", "b"]
+    })"_json;
+
+    SECTION("registered functions can be called from expressions")
+    {
+        registerFunction("native_scale",
+                         {ArgumentType::Array, ArgumentType::Number},
+                         [](std::vector<NativeArgument>& arguments) {
+            Json result = arguments[0].take();
+            for (auto& item: result)
+            {
+                item = item.get<double>() * arguments[1].value().get<double>();
+            }
+            return result;
+        });
+        Expression expression{"native_scale(prices, `2`)[-1]"};
+
+        REQUIRE(search(expression, document) == 60.0);
+        expression.setEvaluationMode(EvaluationMode::Compiled);
+        REQUIRE(search(expression, document) == 60.0);
+        REQUIRE(search(expression, FrozenDocument{document}) == 60.0);
+    }
+
+    SECTION("arguments refer to the document or to temporary values")
+    {
+        std::vector<bool> temporaries;
+        registerFunction("native_temporaries", {ArgumentType::Any},
+                         [&](std::vector<NativeArgument>& arguments) {
+            for (const auto& argument: arguments)
+            {
+                temporaries.push_back(argument.isTemporary());
+            }
+            return Json{};
+        }, true);
+
+        search("native_temporaries(tags, tags[*], `1`)", document);
+
+        REQUIRE(temporaries == std::vector<bool>{false, true, true});
+    }
+
+    SECTION("validates the number and types of arguments")
+    {
+        registerFunction("native_upper", {ArgumentType::String},
+                         [](std::vector<NativeArgument>& arguments) {
+            return arguments[0].value();
+        });
+
+        REQUIRE(search("native_upper(name)", document) == "widget");
+        REQUIRE_THROWS_AS(search("native_upper(name, name)", document),
+                          InvalidFunctionArgumentArity);
+        REQUIRE_THROWS_AS(search("native_upper(prices)", document),
+                          InvalidFunctionArgumentType);
+        REQUIRE_THROWS_AS(search("native_upper(&name)", document),
+                          InvalidFunctionArgumentType);
+    }
+
+    SECTION("built in functions can't be replaced")
+    {
+        auto function = [](std::vector<NativeArgument>&) { return Json{}; };
+
+        REQUIRE_THROWS_AS(registerFunction("length", {ArgumentType::Any},
+                                           function),
+                          InvalidAgrument);
+        REQUIRE_THROWS_AS(registerFunction("", {}, function),
+                          InvalidAgrument);
+        REQUIRE_THROWS_AS(registerFunction("native_empty", {}, function, true),
+                          InvalidAgrument);
+    }
+
+    SECTION("interpreted expressions call the last registered function")
+    {
+        auto constant = [](int value) {
+            return [=](std::vector<NativeArgument>&) { return Json(value); };
+        };
+        Evaluator evaluator;
+        Expression expression{"[native_version(name), native_version(name)]"};
+
+        registerFunction("native_version", {ArgumentType::Any}, constant(1));
+        REQUIRE(evaluator.search(expression, document) == "[1, 1]"_json);
+        REQUIRE(evaluator.search(expression, document) == "[1, 1]"_json);
+        registerFunction("native_version", {ArgumentType::Any}, constant(2));
+        REQUIRE(evaluator.search(expression, document) == "[2, 2]"_json);
+    }
+
+    SECTION("compiled expressions call the last registered function")
+    {
+        auto constant = [](int value) {
+            return [=](std::vector<NativeArgument>&) { return Json(value); };
+        };
+        Evaluator evaluator;
+        registerFunction("native_compiled", {ArgumentType::Any}, constant(1));
+        Expression expression{"native_compiled(name)"};
+        expression.setEvaluationMode(EvaluationMode::Compiled);
+        Expression interpreted{"native_compiled(name)"};
+
+        REQUIRE(evaluator.search(expression, document) == 1);
+        registerFunction("native_compiled", {ArgumentType::Any}, constant(2));
+        REQUIRE(evaluator.search(expression, document) == 2);
+        REQUIRE(evaluator.search(interpreted, document) == 2);
+    }
+
+    SECTION("replaced functions are released")
+    {
+        auto state = std::make_shared<int>(1);
+        Evaluator evaluator;
+        Expression expression{"native_release(name)"};
+
+        registerFunction("native_release", {ArgumentType::Any},
+                         [state](std::vector<NativeArgument>&) {
+            return Json(*state);
+        });
+        REQUIRE(evaluator.search(expression, document) == 1);
+        registerFunction("native_release", {ArgumentType::Any},
+                         [](std::vector<NativeArgument>&) {
+            return Json(2);
+        });
+        REQUIRE(evaluator.search(expression, document) == 2);
+        REQUIRE(state.use_count() == 1);
+    }
+
+    SECTION("unregistered functions are still unknown")
+    {
+        REQUIRE_THROWS_AS(search("native_missing(name)", document),
+                          UnknownFunction);
+    }
+}
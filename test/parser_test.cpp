@@ -29,6 +29,7 @@
 #include <boost/spirit/include/qi.hpp>
 #include <boost/phoenix.hpp>
 #include "src/parser/parser.h"
+#include "src/parser/grammar.h"
 
 namespace qi = boost::spirit::qi;
 namespace encoding = qi::ascii;
@@ -97,6 +98,42 @@ TEST_CASE("Parser")
         REQUIRE(location == 3);
     }
 
+    SECTION("syntax error location is measured in code points")
+    {
+        int location = 0;
+
+        try
+        {
+            parser.parse("abc\xc3\xa9\xe2\x98\x83" "def");
+        }
+        catch(SyntaxError& exception)
+        {
+            location = *boost::get_error_info<
+                    InfoSyntaxErrorLocation>(exception);
+        }
+
+        REQUIRE(location == 3);
+    }
+
+    SECTION("syntax error location after non ASCII characters is measured "
+            "in code points")
+    {
+        jmespath::parser::Parser<jmespath::parser::Grammar> grammarParser;
+        int location = 0;
+
+        try
+        {
+            grammarParser.parse("'\xc3\xa9\xe2\x98\x83' ||");
+        }
+        catch(SyntaxError& exception)
+        {
+            location = *boost::get_error_info<
+                    InfoSyntaxErrorLocation>(exception);
+        }
+
+        REQUIRE(location == 5);
+    }
+
     SECTION("syntax error exception contains search expression")
     {
         String searchExpression{"abc1def"};
@@ -0,0 +1,86 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "fakeit.hpp"
+#include <jmespath/jmespath.h>
+
+TEST_CASE("StaticExpression")
+{
+    using namespace jmespath;
+
+    Json document = "{\"a\": {\"b\": [{\"c\": 1}, {\"c\": 2}, {\"c\": 3}]},"
+                    "\"quoted name\": [true, false], \"n\": null}"_json;
+
+    SECTION("parses paths at compile time")
+    {
+        auto expression = JMESPATH_STATIC("a.b[0].c");
+        using ExpressionType = decltype(expression);
+
+        static_assert(ExpressionType::segmentCount == 4, "");
+        REQUIRE(expression.toString() == "a.b[0].c");
+    }
+
+    SECTION("evaluates field names")
+    {
+        auto expression = JMESPATH_STATIC("a.b");
+
+        REQUIRE(search(expression, document) == document["a"]["b"]);
+        REQUIRE(expression.find(document) == &document["a"]["b"]);
+    }
+
+    SECTION("evaluates quoted field names")
+    {
+        auto expression = JMESPATH_STATIC("\"quoted name\"[0]");
+
+        REQUIRE(search(expression, document) == true);
+    }
+
+    SECTION("evaluates array indices")
+    {
+        REQUIRE(search(JMESPATH_STATIC("a.b[1].c"), document) == 2);
+        REQUIRE(search(JMESPATH_STATIC("a.b[-1].c"), document) == 3);
+        REQUIRE(search(JMESPATH_STATIC("[0]"), "[5, 6]"_json) == 5);
+    }
+
+    SECTION("evaluates to null if the path doesn't exist")
+    {
+        REQUIRE(search(JMESPATH_STATIC("a.x.c"), document) == Json{});
+        REQUIRE(search(JMESPATH_STATIC("a.b[3]"), document) == Json{});
+        REQUIRE(search(JMESPATH_STATIC("a.b[-4]"), document) == Json{});
+        REQUIRE(search(JMESPATH_STATIC("a[0]"), document) == Json{});
+        REQUIRE(search(JMESPATH_STATIC("a.b.c"), document) == Json{});
+        REQUIRE(JMESPATH_STATIC("n.a").find(document) == nullptr);
+    }
+
+    SECTION("evaluates to the same result as the equivalent expression")
+    {
+        auto expression = JMESPATH_STATIC("a.b[-2]");
+
+        REQUIRE(search(expression, document)
+                == search(expression.toExpression(), document));
+    }
+}
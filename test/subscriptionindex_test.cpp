@@ -0,0 +1,97 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "fakeit.hpp"
+#include <jmespath/jmespath.h>
+
+TEST_CASE("SubscriptionIndex")
+{
+    using namespace jmespath;
+
+    Json order = R"({
+        "type": "order",
+        "region": "eu",
+        "total": 120,
+        "items": [{"sku": "a"}, {"sku": "b"}]
+    })"_json;
+
+    SECTION("matches equality comparisons")
+    {
+        SubscriptionIndex index;
+        index.addSubscription("type == 'order'");
+        index.addSubscription("type == 'refund'");
+        index.addSubscription("'eu' == region");
+        index.addSubscription("items[-1].sku == 'b'");
+
+        REQUIRE(index.subscriptionCount() == 4);
+        REQUIRE(index.match(order) == std::vector<size_t>{0, 2, 3});
+    }
+
+    SECTION("matches conjunctions and disjunctions")
+    {
+        SubscriptionIndex index;
+        index.addSubscription("type == 'order' && region == 'eu'");
+        index.addSubscription("type == 'order' && region == 'us'");
+        index.addSubscription("region == 'us' || (type == 'order')");
+        index.addSubscription("type == 'order' && total > `100`");
+        index.addSubscription("(region == 'us' || region == 'eu') "
+                              "&& total < `100`");
+
+        REQUIRE(index.match(order) == std::vector<size_t>{0, 2, 3});
+    }
+
+    SECTION("matches predicates which can't be indexed")
+    {
+        SubscriptionIndex index;
+        index.addSubscription("total > `100`");
+        index.addSubscription("type != 'order' || total");
+        index.addSubscription("!(type == 'order')");
+        index.addSubscription("");
+
+        REQUIRE(index.match(order) == std::vector<size_t>{0, 1});
+    }
+
+    SECTION("matches missing values compared to null")
+    {
+        SubscriptionIndex index;
+        index.addSubscription("customer.id == `null`");
+        index.addSubscription("type == `null`");
+
+        REQUIRE(index.match(order) == std::vector<size_t>{0});
+    }
+
+    SECTION("matches compiled predicates")
+    {
+        SubscriptionIndex index;
+        Expression predicate{"type == 'order' && items[?sku == 'a']"};
+        predicate.setEvaluationMode(EvaluationMode::Compiled);
+        index.addSubscription(predicate);
+
+        REQUIRE(index.match(order) == std::vector<size_t>{0});
+        REQUIRE(index.match(R"({"type": "order"})"_json).empty());
+    }
+}
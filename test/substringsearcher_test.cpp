@@ -0,0 +1,89 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "fakeit.hpp"
+#include "src/interpreter/substringsearcher.h"
+
+TEST_CASE("SubstringSearcher")
+{
+    using namespace jmespath;
+    using namespace jmespath::interpreter;
+
+    String haystack = "the request to the upstream service failed with a "
+                      "timeout after 30 seconds, retrying the request";
+
+    SECTION("finds needles at any position")
+    {
+        for (size_t position = 0; position < haystack.size(); ++position)
+        {
+            for (size_t size = 1; position + size <= haystack.size(); ++size)
+            {
+                String needle = haystack.substr(position, size);
+
+                REQUIRE(containsSubstring(haystack, needle));
+                REQUIRE(SubstringSearcher{needle}.isFoundIn(haystack));
+            }
+        }
+    }
+
+    SECTION("doesn't find needles which only partially match")
+    {
+        REQUIRE_FALSE(containsSubstring(haystack, "timeout before"));
+        REQUIRE_FALSE(containsSubstring(haystack, "tx"));
+        REQUIRE_FALSE(containsSubstring(haystack, "x"));
+        REQUIRE_FALSE(containsSubstring(haystack, "request!"));
+        REQUIRE_FALSE(containsSubstring("short", "longer than short"));
+        REQUIRE_FALSE(containsSubstring("", "a"));
+    }
+
+    SECTION("finds empty needles in every string")
+    {
+        REQUIRE(containsSubstring(haystack, ""));
+        REQUIRE(containsSubstring("", ""));
+    }
+
+    SECTION("finds needles in strings with null characters")
+    {
+        String binary("a\0b\0c\0timeout\0", 14);
+
+        REQUIRE(containsSubstring(binary, String("c\0time", 6)));
+        REQUIRE_FALSE(containsSubstring(binary, String("b\0\0", 3)));
+    }
+
+    SECTION("matches prefixes and suffixes")
+    {
+        SubstringSearcher prefix{"the request"};
+        SubstringSearcher suffix{"the request"};
+
+        REQUIRE(prefix.isPrefixOf(haystack));
+        REQUIRE(suffix.isSuffixOf(haystack));
+        REQUIRE_FALSE(SubstringSearcher{"request"}.isPrefixOf(haystack));
+        REQUIRE_FALSE(SubstringSearcher{"the"}.isSuffixOf(haystack));
+        REQUIRE_FALSE(SubstringSearcher{haystack + "!"}.isPrefixOf(haystack));
+        REQUIRE(SubstringSearcher{""}.isSuffixOf(haystack));
+    }
+}
@@ -0,0 +1,92 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "fakeit.hpp"
+#include "src/interpreter/utf8counter.h"
+#include "jmespath/types.h"
+#include <random>
+
+TEST_CASE("Utf8Counter")
+{
+    using namespace jmespath;
+    using namespace jmespath::interpreter;
+
+    auto decodedLength = [](const String& string) {
+        return static_cast<size_t>(std::distance(
+            UnicodeIteratorAdaptor(std::begin(string)),
+            UnicodeIteratorAdaptor(std::end(string))));
+    };
+
+    SECTION("counts the characters of ASCII strings")
+    {
+        String string(1000, 'a');
+
+        for (size_t size = 0; size <= string.size(); ++size)
+        {
+            REQUIRE(countCodePoints(string.data(), size) == size);
+            REQUIRE(isAscii(string.data(), size));
+        }
+    }
+
+    SECTION("counts the code points of multi byte sequences")
+    {
+        const String characters[] = {
+            "a", "\xc3\xa9", "\xe2\x98\x83", "\xf0\x9f\x98\x80"
+        };
+        std::mt19937 generator{42};
+        std::uniform_int_distribution<size_t> characterIndex{0, 3};
+        // the ASCII characters are more frequent in the first half of the
+        // strings, to cover both the ASCII and the mixed blocks
+        for (size_t length = 0; length < 300; ++length)
+        {
+            String string;
+            for (size_t i = 0; i < length; ++i)
+            {
+                string += i < length / 2 && characterIndex(generator) != 0
+                    ? characters[0]
+                    : characters[characterIndex(generator)];
+            }
+
+            REQUIRE(countCodePoints(string.data(), string.size())
+                    == decodedLength(string));
+            REQUIRE(countCodePoints(string.data(), string.size()) == length);
+        }
+    }
+
+    SECTION("detects non ASCII characters at any position")
+    {
+        String string(200, 'a');
+
+        for (size_t position = 0; position < string.size(); ++position)
+        {
+            String nonAscii = string;
+            nonAscii[position] = '\xc3';
+
+            REQUIRE_FALSE(isAscii(nonAscii.data(), nonAscii.size()));
+        }
+    }
+}
@@ -0,0 +1,81 @@
+/****************************************************************************
+**
+** Author: Róbert Márki <gsmiko@gmail.com>
+** Copyright (c) 2016 Róbert Márki
+**
+** This file is part of the jmespath.cpp project which is distributed under
+** the MIT License (MIT).
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to
+** deal in the Software without restriction, including without limitation the
+** rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+** sell copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+** FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+** DEALINGS IN THE SOFTWARE.
+**
+****************************************************************************/
+#include "fakeit.hpp"
+#include "src/parser/utf8iterator.h"
+
+TEST_CASE("Utf8Iterator")
+{
+    using namespace jmespath;
+    using jmespath::parser::Utf8Iterator;
+
+    SECTION("iterates over ASCII characters byte by byte")
+    {
+        String string{"foo.bar"};
+        UnicodeString codePoints;
+
+        for (Utf8Iterator it(string.cbegin()), end(string.cend());
+             it != end;
+             ++it)
+        {
+            codePoints.push_back(*it);
+        }
+
+        REQUIRE(codePoints == UnicodeString{U"foo.bar"});
+    }
+
+    SECTION("decodes multi byte sequences like the unicode adaptor")
+    {
+        String string{"a\xc3\xa9 \xe2\x98\x83-\xf0\x9f\x98\x80z"};
+        UnicodeString codePoints;
+        UnicodeString expectedCodePoints(
+            UnicodeIteratorAdaptor(string.cbegin()),
+            UnicodeIteratorAdaptor(string.cend()));
+
+        for (Utf8Iterator it(string.cbegin()), end(string.cend());
+             it != end;
+             ++it)
+        {
+            codePoints.push_back(*it);
+        }
+
+        REQUIRE(codePoints == expectedCodePoints);
+        REQUIRE(std::distance(Utf8Iterator(string.cbegin()),
+                              Utf8Iterator(string.cend())) == 7);
+    }
+
+    SECTION("points to the first byte of the current code point")
+    {
+        String string{"\xe2\x98\x83x"};
+        Utf8Iterator it(string.cbegin());
+
+        ++it;
+
+        REQUIRE(it.base() == string.cbegin() + 3);
+        REQUIRE(*it == U'x');
+    }
+}